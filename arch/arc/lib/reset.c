@@ -6,6 +6,7 @@
 #include <command.h>
 #include <common.h>
 #include <cpu_func.h>
+#include <serial.h>
 
 __weak void reset_cpu(ulong addr)
 {
@@ -16,6 +17,7 @@ __weak void reset_cpu(ulong addr)
 int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
 	printf("Resetting the board...\n");
+	serial_flush();
 
 	reset_cpu(0);
 
@@ -101,6 +101,9 @@ endif
 
 # needed for relocation
 LDFLAGS_u-boot += -pie
+ifdef CONFIG_RELR
+LDFLAGS_u-boot += -z pack-relative-relocs
+endif
 
 #
 # FIXME: binutils versions < 2.22 have a bug in the assembler where
@@ -133,7 +136,7 @@ endif
 # limit ourselves to the sections we want in the .bin.
 ifdef CONFIG_ARM64
 OBJCOPYFLAGS += -j .text -j .secure_text -j .secure_data -j .rodata -j .data \
-		-j .u_boot_list -j .rela.dyn -j .got -j .got.plt \
+		-j .u_boot_list -j .rela.dyn -j .relr.dyn -j .got -j .got.plt \
 		-j .binman_sym_table -j .text_rest
 else
 OBJCOPYFLAGS += -j .text -j .secure_text -j .secure_data -j .rodata -j .hash \
@@ -77,6 +77,56 @@ lr	.req	x30
 	b.eq	\el1_label
 .endm
 
+/*
+ * Branch to \label if the MMU is off at the current exception level. All data
+ * accesses are then to Device memory, where unaligned accesses and DC ZVA
+ * fault.
+ */
+.macro	branch_if_mmu_off, xreg, label
+	switch_el \xreg, 3f, 2f, 1f
+3:	mrs	\xreg, sctlr_el3
+	b	0f
+2:	mrs	\xreg, sctlr_el2
+	b	0f
+1:	mrs	\xreg, sctlr_el1
+0:	tbz	\xreg, #0, \label
+.endm
+
+/*
+ * Apply the packed relative relocations (SHT_RELR) from \first up to \last.
+ * An even entry is the link address of a word to fix. An odd entry is a
+ * bitmap in which bit n + 1 marks word n after the last fixed address, and
+ * is followed by words 63 further on. Each word is found at its link address
+ * plus \loc and has \val added to it, the linker having already stored the
+ * link-time value in place. Unlike RELA, the word is adjusted as found, so
+ * any change made to it before relocation is carried over. \first, \entry,
+ * \base, \tmp1 and \tmp2 are clobbered.
+ */
+.macro	apply_relr, first, last, loc, val, entry, base, tmp1, tmp2
+	b	5f
+1:	ldr	\entry, [\first], #8
+	tbnz	\entry, #0, 2f
+	add	\base, \entry, \loc
+	ldr	\tmp1, [\base]
+	add	\tmp1, \tmp1, \val
+	str	\tmp1, [\base], #8
+	b	5f
+	/* Visit the set bits only, lowest first */
+2:	lsr	\entry, \entry, #1
+	cbz	\entry, 4f
+3:	rbit	\tmp2, \entry
+	clz	\tmp2, \tmp2
+	ldr	\tmp1, [\base, \tmp2, lsl #3]
+	add	\tmp1, \tmp1, \val
+	str	\tmp1, [\base, \tmp2, lsl #3]
+	sub	\tmp2, \entry, #1
+	ands	\entry, \entry, \tmp2
+	b.ne	3b
+4:	add	\base, \base, #(63 * 8)
+5:	cmp	\first, \last
+	b.lo	1b
+.endm
+
 /*
  * Branch if current processor is a Cortex-A57 core.
  */
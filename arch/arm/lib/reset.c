@@ -24,6 +24,7 @@
 #include <command.h>
 #include <cpu_func.h>
 #include <irq_func.h>
+#include <serial.h>
 #include <linux/delay.h>
 
 __weak void reset_misc(void)
@@ -33,6 +34,7 @@ __weak void reset_misc(void)
 int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
 	puts ("resetting ...\n");
+	serial_flush();
 
 	mdelay(50);				/* wait 50 ms */
 
@@ -10,6 +10,7 @@
 
 #include <common.h>
 #include <init.h>
+#include <serial.h>
 #include <vsprintf.h>
 #include <watchdog.h>
 #include <command.h>
@@ -24,6 +25,8 @@ DECLARE_GLOBAL_DATA_PTR;
 int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
 	rcm_t *rcm = (rcm_t *) (MMAP_RCM);
+
+	serial_flush();
 	udelay(1000);
 	setbits_8(&rcm->rcr, RCM_RCR_SOFTRST);
 
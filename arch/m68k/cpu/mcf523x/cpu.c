@@ -11,6 +11,7 @@
 #include <common.h>
 #include <init.h>
 #include <net.h>
+#include <serial.h>
 #include <vsprintf.h>
 #include <watchdog.h>
 #include <command.h>
@@ -26,6 +27,7 @@ int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
 	ccm_t *ccm = (ccm_t *) MMAP_CCM;
 
+	serial_flush();
 	out_8(&ccm->rcr, CCM_RCR_SOFTRST);
 	/* we don't return! */
 	return 0;
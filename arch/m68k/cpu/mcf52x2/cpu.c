@@ -16,6 +16,7 @@
 #include <common.h>
 #include <init.h>
 #include <net.h>
+#include <serial.h>
 #include <vsprintf.h>
 #include <watchdog.h>
 #include <command.h>
@@ -33,6 +34,7 @@ int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
 	rcm_t *rcm = (rcm_t *)(MMAP_RCM);
 
+	serial_flush();
 	udelay(1000);
 
 	out_8(&rcm->rcr, RCM_RCR_SOFTRST);
@@ -144,6 +146,8 @@ int print_cpuinfo(void)
 
 int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
+	serial_flush();
+
 	/* Call the board specific reset actions first. */
 	if(board_reset) {
 		board_reset();
@@ -181,6 +185,7 @@ int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
 	wdog_t *wdp = (wdog_t *) (MMAP_WDOG);
 
+	serial_flush();
 	out_be16(&wdp->wdog_wrrr, 0);
 	udelay(1000);
 
@@ -270,6 +275,7 @@ int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
 	rcm_t *rcm = (rcm_t *)(MMAP_RCM);
 
+	serial_flush();
 	udelay(1000);
 
 	out_8(&rcm->rcr, RCM_RCR_SOFTRST);
@@ -358,6 +364,7 @@ int print_cpuinfo(void)
 
 int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
+	serial_flush();
 	MCFRESET_RCR = MCFRESET_RCR_SOFTRST;
 	return 0;
 };
@@ -377,6 +384,8 @@ int print_cpuinfo(void)
 
 int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
+	serial_flush();
+
 	/* enable watchdog, set timeout to 0 and wait */
 	mbar_writeByte(MCFSIM_SYPCR, 0xc0);
 	while (1) ;
@@ -409,6 +418,8 @@ int print_cpuinfo(void)
 
 int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
+	serial_flush();
+
 	/* enable watchdog, set timeout to 0 and wait */
 	mbar_writeByte(SIM_SYPCR, 0xc0);
 	while (1) ;
@@ -7,6 +7,7 @@
 #include <common.h>
 #include <command.h>
 #include <init.h>
+#include <serial.h>
 #include <vsprintf.h>
 #include <asm/immap.h>
 #include <asm/io.h>
@@ -16,6 +17,8 @@ int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
 	sim_t *sim = (sim_t *)(MMAP_SIM);
 
+	serial_flush();
+
 	/* enable watchdog/reset, set timeout to 0 and wait */
 	out_8(&sim->sypcr, SYPCR_SWE | SYPCR_SWRI);
 
@@ -11,6 +11,7 @@
 #include <common.h>
 #include <init.h>
 #include <net.h>
+#include <serial.h>
 #include <vsprintf.h>
 #include <watchdog.h>
 #include <command.h>
@@ -27,6 +28,7 @@ int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
 	rcm_t *rcm = (rcm_t *) (MMAP_RCM);
 
+	serial_flush();
 	udelay(1000);
 	setbits_8(&rcm->rcr, RCM_RCR_SOFTRST);
 
@@ -11,6 +11,7 @@
 #include <common.h>
 #include <init.h>
 #include <net.h>
+#include <serial.h>
 #include <vsprintf.h>
 #include <watchdog.h>
 #include <command.h>
@@ -26,6 +27,7 @@ int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
 	gptmr_t *gptmr = (gptmr_t *) (MMAP_GPTMR);
 
+	serial_flush();
 	out_be16(&gptmr->pre, 10);
 	out_be16(&gptmr->cnt, 1);
 
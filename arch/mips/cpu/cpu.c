@@ -7,6 +7,7 @@
 #include <common.h>
 #include <command.h>
 #include <init.h>
+#include <serial.h>
 #include <linux/compiler.h>
 #include <asm/cache.h>
 #include <asm/mipsregs.h>
@@ -23,6 +24,7 @@ void __weak _machine_restart(void)
 
 int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
+	serial_flush();
 	_machine_restart();
 
 	return 0;
@@ -17,6 +17,7 @@
 #include <command.h>
 #include <cpu_func.h>
 #include <irq_func.h>
+#include <serial.h>
 #include <watchdog.h>
 #include <asm/cache.h>
 
@@ -41,6 +42,7 @@ int cleanup_before_linux(void)
 
 int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
+	serial_flush();
 	disable_interrupts();
 
 	/*
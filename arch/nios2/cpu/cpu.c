@@ -12,6 +12,7 @@
 #include <errno.h>
 #include <init.h>
 #include <irq_func.h>
+#include <serial.h>
 #include <asm/cache.h>
 #include <asm/global_data.h>
 #include <asm/system.h>
@@ -36,6 +37,7 @@ int checkboard(void)
 
 int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
+	serial_flush();
 	disable_interrupts();
 	/* indirect call to go beyond 256MB limitation of toolchain */
 	nios2_callr(gd->arch.reset_addr);
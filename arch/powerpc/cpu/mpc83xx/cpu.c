@@ -13,6 +13,7 @@
 #include <cpu_func.h>
 #include <irq_func.h>
 #include <net.h>
+#include <serial.h>
 #include <time.h>
 #include <vsprintf.h>
 #include <watchdog.h>
@@ -131,6 +132,7 @@ int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 	volatile immap_t *immap = (immap_t *) CONFIG_SYS_IMMR;
 
 	puts("Resetting the board.\n");
+	serial_flush();
 
 	/* Interrupts and MMU off */
 	msr = mfmsr();
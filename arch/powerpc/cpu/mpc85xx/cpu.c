@@ -14,6 +14,7 @@
 #include <init.h>
 #include <irq_func.h>
 #include <log.h>
+#include <serial.h>
 #include <time.h>
 #include <vsprintf.h>
 #include <watchdog.h>
@@ -305,6 +306,8 @@ int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 	defined(CONFIG_ARCH_MPC8555) || defined(CONFIG_ARCH_MPC8560)
 	unsigned long val, msr;
 
+	serial_flush();
+
 	/*
 	 * Initiate hard reset in debug control register DBCR0
 	 * Make sure MSR[DE] = 1.  This only resets the core.
@@ -319,6 +322,8 @@ int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 #else
 	volatile ccsr_gur_t *gur = (void *)(CONFIG_SYS_MPC85xx_GUTS_ADDR);
 
+	serial_flush();
+
 	/* Attempt board-specific reset */
 	board_reset();
 
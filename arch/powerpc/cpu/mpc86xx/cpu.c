@@ -8,6 +8,7 @@
 #include <common.h>
 #include <cpu_func.h>
 #include <log.h>
+#include <serial.h>
 #include <time.h>
 #include <vsprintf.h>
 #include <watchdog.h>
@@ -114,6 +115,8 @@ int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 	volatile immap_t *immap = (immap_t *)CONFIG_SYS_IMMR;
 	volatile ccsr_gur_t *gur = &immap->im_gur;
 
+	serial_flush();
+
 	/* Attempt board-specific reset */
 	board_reset();
 
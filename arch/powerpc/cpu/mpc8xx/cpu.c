@@ -19,6 +19,7 @@
 #include <common.h>
 #include <cpu_func.h>
 #include <net.h>
+#include <serial.h>
 #include <time.h>
 #include <vsprintf.h>
 #include <watchdog.h>
@@ -202,6 +203,8 @@ int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 
 	immap_t __iomem *immap = (immap_t __iomem *)CONFIG_SYS_IMMR;
 
+	serial_flush();
+
 	/* Checkstop Reset enable */
 	setbits_be32(&immap->im_clkrst.car_plprcr, PLPRCR_CSR);
 
@@ -162,11 +162,21 @@ int sandbox_sdl_init_display(int width, int height, int log2_bpp,
 	return 0;
 }
 
-int sandbox_sdl_sync(void *lcd_base)
+int sandbox_sdl_sync(void *lcd_base, int xstart, int ystart, int xend,
+		     int yend)
 {
-	SDL_UpdateTexture(sdl.texture, NULL, lcd_base, sdl.pitch);
-	SDL_RenderCopy(sdl.renderer, sdl.texture, NULL, NULL);
-	SDL_RenderPresent(sdl.renderer);
+	SDL_Rect rect;
+
+	if (xend > xstart && yend > ystart) {
+		rect.x = xstart;
+		rect.y = ystart;
+		rect.w = xend - xstart;
+		rect.h = yend - ystart;
+		lcd_base += ystart * sdl.pitch + xstart * sdl.depth / 8;
+		SDL_UpdateTexture(sdl.texture, &rect, lcd_base, sdl.pitch);
+		SDL_RenderCopy(sdl.renderer, sdl.texture, NULL, NULL);
+		SDL_RenderPresent(sdl.renderer);
+	}
 	sandbox_sdl_poll_events();
 
 	return 0;
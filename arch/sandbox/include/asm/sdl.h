@@ -29,12 +29,18 @@ int sandbox_sdl_init_display(int width, int height, int log2_bpp,
  * sandbox_sdl_sync() - Sync current U-Boot LCD frame buffer to SDL
  *
  * This must be called periodically to update the screen for SDL so that the
- * user can see it.
+ * user can see it. Only the given rectangle is copied to the display; pass
+ * an empty rectangle to just process pending SDL events.
  *
  * @lcd_base: Base of frame buffer
+ * @xstart: Left edge of the region to update, in pixels
+ * @ystart: Top edge of the region to update, in pixels
+ * @xend: Right edge of the region to update (exclusive), in pixels
+ * @yend: Bottom edge of the region to update (exclusive), in pixels
  * @return 0 if screen was updated, -ENODEV is there is no screen.
  */
-int sandbox_sdl_sync(void *lcd_base);
+int sandbox_sdl_sync(void *lcd_base, int xstart, int ystart, int xend,
+		     int yend);
 
 /**
  * sandbox_sdl_scan_keys() - scan for pressed keys
@@ -87,7 +93,8 @@ static inline int sandbox_sdl_init_display(int width, int height, int log2_bpp,
 	return -ENODEV;
 }
 
-static inline int sandbox_sdl_sync(void *lcd_base)
+static inline int sandbox_sdl_sync(void *lcd_base, int xstart, int ystart,
+				   int xend, int yend)
 {
 	return -ENODEV;
 }
@@ -20,11 +20,13 @@ struct sandbox_serial_plat {
  * struct sandbox_serial_priv - Private data for this driver
  *
  * @buf: holds input characters available to be read by this driver
+ * @busy: true to report that there is no room for output (for testing)
  */
 struct sandbox_serial_priv {
 	struct membuff buf;
 	char serial_buf[16];
 	bool start_of_line;
+	bool busy;
 };
 
 #endif /* __asm_serial_h */
@@ -146,6 +146,15 @@ int sandbox_pwm_get_config(struct udevice *dev, uint channel, uint *period_nsp,
  */
 void sandbox_sf_set_block_protect(struct udevice *dev, int bp_mask);
 
+/**
+ * sandbox_sf_get_erase_count() - Get the number of erase commands received
+ *
+ * @dev: SPI flash emulator device
+ * @opcode: Erase opcode to count (e.g. SPINOR_OP_SE)
+ * @return number of commands with that opcode received since probe
+ */
+uint sandbox_sf_get_erase_count(struct udevice *dev, u8 opcode);
+
 /**
  * sandbox_get_codec_params() - Read back codec parameters
  *
@@ -275,4 +284,27 @@ void sandbox_set_enable_memio(bool enable);
  */
 void sandbox_cros_ec_set_test_flags(struct udevice *dev, uint flags);
 
+/**
+ * sandbox_serial_set_busy() - Set whether the serial port has room for output
+ *
+ * While busy, the driver's putc() method returns -EAGAIN as if the TX FIFO
+ * were full.
+ *
+ * @dev: Serial device to update
+ * @busy: true to refuse output, false to accept it
+ */
+void sandbox_serial_set_busy(struct udevice *dev, bool busy);
+
+/**
+ * sandbox_pci_get_id_reads() - Get the number of reads of the vendor ID
+ *
+ * Scanning a bus reads the vendor ID of every device slot, so this shows
+ * whether a bus was scanned. Reads for buses behind bridges are counted by
+ * the root bus.
+ *
+ * @bus: Sandbox PCI controller to check
+ * @return number of config-space reads at PCI_VENDOR_ID since probe
+ */
+uint sandbox_pci_get_id_reads(struct udevice *bus);
+
 #endif
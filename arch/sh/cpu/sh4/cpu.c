@@ -10,6 +10,7 @@
 #include <cpu_func.h>
 #include <net.h>
 #include <netdev.h>
+#include <serial.h>
 #include <asm/processor.h>
 
 int checkcpu(void)
@@ -31,6 +32,7 @@ int cleanup_before_linux (void)
 
 int do_reset(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
+	serial_flush();
 	disable_interrupts();
 	reset_cpu(0);
 	return 0;
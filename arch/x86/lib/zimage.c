@@ -21,6 +21,7 @@
 #include <irq_func.h>
 #include <log.h>
 #include <malloc.h>
+#include <serial.h>
 #include <acpi/acpi_table.h>
 #include <asm/io.h>
 #include <asm/ptrace.h>
@@ -493,11 +494,13 @@ static int do_zboot_go(struct cmd_tbl *cmdtp, int flag, int argc,
 {
 	int ret;
 
+	serial_tx_stop();
 	disable_interrupts();
 
 	/* we assume that the kernel is in place */
 	ret = boot_linux_kernel((ulong)state.base_ptr, state.load_address,
 				false);
+	serial_tx_start();
 	printf("Kernel returned! (err=%d)\n", ret);
 
 	return CMD_RET_FAILURE;
@@ -73,5 +73,5 @@ int at91_video_show_board_info(void)
 	for (s = buf, i = 0; i < len; s++, i++)
 		vidconsole_put_char(con, *s);
 
-	return 0;
+	return video_sync(con->parent, false);
 }
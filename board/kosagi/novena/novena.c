@@ -141,6 +141,7 @@ int board_late_init(void)
 	display_options_get_banner(false, buf, sizeof(buf));
 	vidconsole_position_cursor(con, 0, 0);
 	vidconsole_put_string(con, buf);
+	video_sync(con->parent, false);
 #endif
 	return 0;
 }
@@ -12,6 +12,7 @@
 #include <image.h>
 #include <log.h>
 #include <net.h>
+#include <serial.h>
 #include <vxworks.h>
 #ifdef CONFIG_X86
 #include <vbe.h>
@@ -73,12 +74,14 @@ int do_bootelf(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 		return rcode;
 
 	printf("## Starting application at 0x%08lx ...\n", addr);
+	serial_tx_stop();
 
 	/*
 	 * pass address parameter as argv[0] (aka command name),
 	 * and all remaining args
 	 */
 	rc = do_bootelf_exec((void *)addr, argc, argv);
+	serial_tx_start();
 	if (rc != 0)
 		rcode = 1;
 
@@ -275,6 +278,7 @@ int do_bootvx(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 		puts("## Not an ELF image, assuming binary\n");
 
 	printf("## Starting vxWorks at 0x%08lx ...\n", addr);
+	serial_tx_stop();
 
 	dcache_disable();
 #if defined(CONFIG_ARM64) && defined(CONFIG_ARMV8_PSCI)
@@ -288,6 +292,7 @@ int do_bootvx(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 #else
 	((void (*)(int))addr)(0);
 #endif
+	serial_tx_start();
 
 	puts("## vxWorks terminated\n");
 
@@ -28,6 +28,7 @@
 #include <linux/compiler.h>
 #include <linux/ctype.h>
 #include <linux/delay.h>
+#include <linux/sizes.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -1057,10 +1058,199 @@ static ulong mem_test_quick(vu_long *buf, ulong start_addr, ulong end_addr,
 	return errs;
 }
 
+/*
+ * The fast test writes each word with its own address XORed with a seed,
+ * then runs a moving-inversions sequence over it: upwards, check and
+ * invert each word; downwards, check and restore it; then check it once
+ * more. This finds address faults, stuck bits and most coupling faults in
+ * four passes over memory. The seed includes a bit which walks along the
+ * word from one iteration to the next.
+ *
+ * The passes use plain (not volatile) accesses so that the compiler can
+ * keep them tight, with a barrier between passes so that nothing is
+ * cached in registers. Memory is handled in chunks: errors are recorded
+ * as they are found and printed after each chunk, which is also when the
+ * watchdog and ctrl-c are checked.
+ */
+#define MTEST_CHUNK_WORDS	(SZ_1M / sizeof(ulong))
+#define MTEST_MAX_ERRS		16
+
+struct mtest_err {
+	ulong addr;
+	ulong expected;
+	ulong found;
+};
+
+struct mtest_state {
+	ulong errs;
+	ulong unreported;
+	int count;
+	struct mtest_err err[MTEST_MAX_ERRS];
+};
+
+enum mtest_pass {
+	MTEST_WRITE,	/* write the pattern */
+	MTEST_UP,	/* check the pattern and invert it, upwards */
+	MTEST_DOWN,	/* check the inverse and restore it, downwards */
+	MTEST_CHECK,	/* check the pattern */
+
+	MTEST_PASS_COUNT,
+};
+
+static const char *const mtest_pass_name[MTEST_PASS_COUNT] = {
+	"Writing...", "Up...     ", "Down...   ", "Reading...",
+};
+
+static noinline void mtest_record(struct mtest_state *st, ulong addr,
+				  ulong expected, ulong found)
+{
+	struct mtest_err *err;
+
+	st->errs++;
+	if (st->count == MTEST_MAX_ERRS) {
+		st->unreported++;
+		return;
+	}
+	err = &st->err[st->count++];
+	err->addr = addr;
+	err->expected = expected;
+	err->found = found;
+}
+
+static void mtest_report(struct mtest_state *st)
+{
+	int i;
+
+	for (i = 0; i < st->count; i++)
+		printf("\nMem error @ 0x%08lX: found %08lX, expected %08lX",
+		       st->err[i].addr, st->err[i].found, st->err[i].expected);
+	if (st->unreported)
+		printf("\n... and %lu more errors", st->unreported);
+	if (st->count)
+		putc('\n');
+	st->count = 0;
+	st->unreported = 0;
+}
+
+/**
+ * mtest_chunk() - Run one pass of the fast memory test over a chunk
+ *
+ * @p: First word of the chunk
+ * @count: Number of words in the chunk
+ * @addr: Address of the first word, as printed for errors
+ * @seed: Value XORed with each word's address to give its pattern
+ * @pass: Pass to run
+ * @st: Records any errors found
+ */
+static void mtest_chunk(ulong *p, ulong count, ulong addr, ulong seed,
+			enum mtest_pass pass, struct mtest_state *st)
+{
+	ulong i, val, found;
+
+	switch (pass) {
+	case MTEST_WRITE:
+		for (i = 0; i < count; i++, addr += sizeof(ulong))
+			p[i] = addr ^ seed;
+		break;
+	case MTEST_UP:
+		for (i = 0; i < count; i++, addr += sizeof(ulong)) {
+			val = addr ^ seed;
+			found = p[i];
+			if (unlikely(found != val))
+				mtest_record(st, addr, val, found);
+			p[i] = ~val;
+		}
+		break;
+	case MTEST_DOWN:
+		addr += count * sizeof(ulong);
+		for (i = count; i-- > 0;) {
+			addr -= sizeof(ulong);
+			val = addr ^ seed;
+			found = p[i];
+			if (unlikely(found != ~val))
+				mtest_record(st, addr, ~val, found);
+			p[i] = val;
+		}
+		break;
+	case MTEST_CHECK:
+		for (i = 0; i < count; i++, addr += sizeof(ulong)) {
+			val = addr ^ seed;
+			found = p[i];
+			if (unlikely(found != val))
+				mtest_record(st, addr, val, found);
+		}
+		break;
+	default:
+		break;
+	}
+	barrier();
+}
+
+/* Walk a one and a zero through the first word to check the data lines */
+static void mtest_data_bus(vu_long *buf, ulong start_addr,
+			   struct mtest_state *st)
+{
+	ulong val, found;
+	int i;
+
+	for (i = 0; i < BITS_PER_LONG; i++) {
+		val = 1UL << i;
+		*buf = val;
+		found = *buf;
+		if (found != val)
+			mtest_record(st, start_addr, val, found);
+		*buf = ~val;
+		found = *buf;
+		if (found != ~val)
+			mtest_record(st, start_addr, ~val, found);
+	}
+}
+
+static ulong mem_test_fast(vu_long *vbuf, ulong start_addr, ulong end_addr,
+			   ulong pattern, int iteration)
+{
+	ulong *buf = (ulong *)vbuf;
+	ulong length = (end_addr - start_addr) / sizeof(ulong);
+	ulong seed = pattern ^ (1UL << (iteration % BITS_PER_LONG));
+	struct mtest_state st = { 0 };
+	ulong offset, count;
+	int pass;
+
+	printf("\rPattern %08lX  ", seed);
+	mtest_data_bus(vbuf, start_addr, &st);
+	mtest_report(&st);
+
+	for (pass = 0; pass < MTEST_PASS_COUNT; pass++) {
+		printf("%s\b\b\b\b\b\b\b\b\b\b", mtest_pass_name[pass]);
+		for (offset = 0; offset < length; offset += count) {
+			count = min(length - offset, (ulong)MTEST_CHUNK_WORDS);
+			/* The downward pass takes the chunks in reverse */
+			if (pass == MTEST_DOWN)
+				mtest_chunk(buf + length - offset - count,
+					    count,
+					    start_addr + (length - offset -
+						count) * sizeof(ulong),
+					    seed, pass, &st);
+			else
+				mtest_chunk(buf + offset, count,
+					    start_addr + offset * sizeof(ulong),
+					    seed, pass, &st);
+
+			WATCHDOG_RESET();
+			mtest_report(&st);
+			if (ctrlc())
+				return -1UL;
+		}
+	}
+
+	return st.errs;
+}
+
 /*
  * Perform a memory test. A more complete alternative test can be
- * configured using CONFIG_SYS_ALT_MEMTEST. The complete test loops until
- * interrupted by ctrl-c or by a failure of one of the sub-tests.
+ * configured using CONFIG_SYS_ALT_MEMTEST, or a faster one using
+ * CONFIG_SYS_FAST_MEMTEST. The complete test loops until interrupted by
+ * ctrl-c or by a failure of one of the sub-tests.
  */
 static int do_mem_mtest(struct cmd_tbl *cmdtp, int flag, int argc,
 			char *const argv[])
@@ -1121,6 +1311,9 @@ static int do_mem_mtest(struct cmd_tbl *cmdtp, int flag, int argc,
 				count += errs;
 				errs = mem_test_bitflip(buf, start, end);
 			}
+		} else if (IS_ENABLED(CONFIG_SYS_FAST_MEMTEST)) {
+			errs = mem_test_fast(buf, start, end, pattern,
+					     iteration);
 		} else {
 			errs = mem_test_quick(buf, start, end, pattern,
 					      iteration);
@@ -706,6 +706,31 @@ char *from_env(const char *envvar)
 	return ret;
 }
 
+/*
+ * Copy out the value of a variable found in the restricted C runtime env.
+ */
+static int env_get_f_value(const char *name, int val, char *buf, unsigned len)
+{
+	int n, c;
+
+	for (n = 0; n < len; ++n, ++buf) {
+		c = env_get_char(val++);
+		if (c < 0)
+			return c;
+		*buf = c;
+		if (*buf == '\0')
+			return n;
+	}
+
+	if (n)
+		*--buf = '\0';
+
+	printf("env_buf [%u bytes] too small for value of \"%s\"\n",
+	       len, name);
+
+	return n;
+}
+
 /*
  * Look up variable from environment for restricted C runtime env.
  */
@@ -713,8 +738,16 @@ int env_get_f(const char *name, char *buf, unsigned len)
 {
 	int i, nxt, c;
 
+	if (CONFIG_IS_ENABLED(ENV_INDEX)) {
+		i = env_index_find(name);
+		if (i >= 0)
+			return env_get_f_value(name, i, buf, len);
+		if (i == -ENOENT)
+			return -1;
+	}
+
 	for (i = 0; env_get_char(i) != '\0'; i = nxt + 1) {
-		int val, n;
+		int val;
 
 		for (nxt = i; (c = env_get_char(nxt)) != '\0'; ++nxt) {
 			if (c < 0)
@@ -727,23 +760,7 @@ int env_get_f(const char *name, char *buf, unsigned len)
 		if (val < 0)
 			continue;
 
-		/* found; copy out */
-		for (n = 0; n < len; ++n, ++buf) {
-			c = env_get_char(val++);
-			if (c < 0)
-				return c;
-			*buf = c;
-			if (*buf == '\0')
-				return n;
-		}
-
-		if (n)
-			*--buf = '\0';
-
-		printf("env_buf [%u bytes] too small for value of \"%s\"\n",
-		       len, name);
-
-		return n;
+		return env_get_f_value(name, val, buf, len);
 	}
 
 	return -1;
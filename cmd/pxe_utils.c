@@ -344,6 +344,7 @@ static int label_localboot(struct pxe_label *label)
 static void label_boot_fdtoverlay(struct cmd_tbl *cmdtp, struct pxe_label *label)
 {
 	char *fdtoverlay = label->fdtoverlays;
+	struct fdt_overlay_index ov_idx;
 	struct fdt_header *working_fdt;
 	char *fdtoverlay_addr_env;
 	ulong fdtoverlay_addr;
@@ -366,6 +367,11 @@ static void label_boot_fdtoverlay(struct cmd_tbl *cmdtp, struct pxe_label *label
 
 	fdtoverlay_addr = simple_strtoul(fdtoverlay_addr_env, NULL, 16);
 
+	/* Index the main fdt once rather than walking it for each overlay */
+	err = fdt_overlay_index_alloc(working_fdt, &ov_idx);
+	if (err)
+		return;
+
 	/* Cycle over the overlay files and apply them in order */
 	do {
 		struct fdt_header *blob;
@@ -409,7 +415,8 @@ static void label_boot_fdtoverlay(struct cmd_tbl *cmdtp, struct pxe_label *label
 			goto skip_overlay;
 		}
 
-		err = fdt_overlay_apply_verbose(working_fdt, blob);
+		err = fdt_overlay_apply_index_verbose(working_fdt, blob,
+						      &ov_idx);
 		if (err) {
 			printf("Failed to apply overlay %s, skipping\n",
 			       overlayfile);
@@ -420,6 +427,8 @@ skip_overlay:
 		if (end)
 			free(overlayfile);
 	} while ((fdtoverlay = strstr(fdtoverlay, " ")));
+
+	fdt_overlay_index_free(&ov_idx);
 }
 #endif
 
@@ -40,6 +40,9 @@ static const char *const tag_name[] = {
 	[BLOBLISTT_TCPA_LOG]		= "TPM log space",
 	[BLOBLISTT_ACPI_TABLES]		= "ACPI tables for x86",
 	[BLOBLISTT_SMBIOS_TABLES]	= "SMBIOS tables for x86",
+	[BLOBLISTT_UBI_ATTACH]		= "UBI attach snapshot",
+	[BLOBLISTT_PCI_ENUM]		= "PCI enumeration cache",
+	[BLOBLISTT_NAND_BBT]		= "NAND bad block handoff",
 };
 
 const char *bloblist_tag_name(enum bloblist_tag_t tag)
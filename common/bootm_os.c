@@ -18,6 +18,7 @@
 #include <linux/libfdt.h>
 #include <malloc.h>
 #include <mapmem.h>
+#include <serial.h>
 #include <vxworks.h>
 #include <tee/optee.h>
 
@@ -613,7 +614,10 @@ int boot_selected_os(int argc, char *const argv[], int state,
 {
 	arch_preboot_os();
 	board_preboot_os();
+	/* The OS gets the UART, so stop buffering what is printed on the way */
+	serial_tx_stop();
 	boot_fn(state, argc, argv, images);
+	serial_tx_start();
 
 	/* Stand-alone may return when 'autostart' is 'no' */
 	if (images->os.type == IH_TYPE_STANDALONE ||
@@ -45,7 +45,7 @@ int run_command(const char *cmd, int flag)
 	int hush_flags = FLAG_PARSE_SEMICOLON | FLAG_EXIT_FROM_LOOP;
 
 	if (flag & CMD_FLAG_ENV)
-		hush_flags |= FLAG_CONT_ON_NEWLINE;
+		hush_flags |= FLAG_CONT_ON_NEWLINE | FLAG_CACHE_PARSE;
 	return parse_string_outer(cmd, hush_flags);
 #endif
 }
@@ -306,6 +306,28 @@ struct variables *top_vars = &shell_ver;
 static int flag_repeat = 0;
 static int do_repeat = 0;
 static struct variables *top_vars = NULL ;
+
+#ifdef CONFIG_HUSH_PARSE_CACHE
+#define PARSE_CACHE_SIZE 16
+
+/*
+ * A script which has been parsed and run, kept so that it can be run again
+ * without parsing. Running a list leaves it as it was parsed.
+ */
+struct parse_cache {
+	char *text;			/* script text, NULL if slot is unused */
+	uint hash;			/* hash of the text */
+	int flag;			/* FLAG_... used when parsing */
+	struct pipe **lines;		/* list for each line of the script */
+	int count;			/* number of lines */
+	int ready;			/* all lines have been parsed */
+	int busy;			/* script is being run */
+	ulong used;			/* parse_cache_seq when last used */
+};
+
+static struct parse_cache parse_cache[PARSE_CACHE_SIZE];
+static ulong parse_cache_seq;
+#endif
 #endif /*__U_BOOT__ */
 
 #define B_CHUNK (100)
@@ -333,6 +355,8 @@ struct in_str {
 	int promptmode;
 #ifndef __U_BOOT__
 	FILE *file;
+#else
+	struct parse_cache *cache;	/* records the parsed lines, or NULL */
 #endif
 	int (*get) (struct in_str *);
 	int (*peek) (struct in_str *);
@@ -1159,6 +1183,8 @@ static void setup_file_in_str(struct in_str *i)
 	i->promptmode=1;
 #ifndef __U_BOOT__
 	i->file = f;
+#else
+	i->cache = NULL;
 #endif
 	i->p = NULL;
 }
@@ -1169,6 +1195,9 @@ static void setup_string_in_str(struct in_str *i, const char *s)
 	i->get = static_get;
 	i->__promptme=1;
 	i->promptmode=1;
+#ifdef __U_BOOT__
+	i->cache = NULL;
+#endif
 	i->p = s;
 }
 
@@ -1539,6 +1568,7 @@ static int run_pipe_real(struct pipe *pi)
 	struct child_prog *child;
 	struct built_in_command *x;
 	char *p;
+	int sp;
 # if __GNUC__
 	/* Avoid longjmp clobbering */
 	(void) &i;
@@ -1551,6 +1581,7 @@ static int run_pipe_real(struct pipe *pi)
 	int flag = do_repeat ? CMD_FLAG_REPEAT : 0;
 	struct child_prog *child;
 	char *p;
+	int sp;
 # if __GNUC__
 	/* Avoid longjmp clobbering */
 	(void) &i;
@@ -1617,6 +1648,8 @@ static int run_pipe_real(struct pipe *pi)
 			}
 			return EXIT_SUCCESS;   /* don't worry about errors in set_local_var() yet */
 		}
+		/* Count substitutions locally, so the pipe can be run again */
+		sp = child->sp;
 		for (i = 0; is_assignment(child->argv[i]); i++) {
 			p = insert_var_value(child->argv[i]);
 #ifndef __U_BOOT__
@@ -1625,11 +1658,11 @@ static int run_pipe_real(struct pipe *pi)
 			set_local_var(p, 0);
 #endif
 			if (p != child->argv[i]) {
-				child->sp--;
+				sp--;
 				free(p);
 			}
 		}
-		if (child->sp) {
+		if (sp) {
 			char * str = NULL;
 
 			str = make_string(child->argv + i,
@@ -1763,6 +1796,7 @@ static int run_list_real(struct pipe *pi)
 	char **list = NULL;
 	char **save_list = NULL;
 	struct pipe *rpipe;
+	struct pipe *for_pipe = NULL;
 	int flag_rep = 0;
 #ifndef __U_BOOT__
 	int save_num_progs;
@@ -1801,7 +1835,8 @@ static int run_list_real(struct pipe *pi)
 				/* check Ctrl-C */
 				ctrlc();
 				if ((had_ctrlc())) {
-					return 1;
+					rcode = 1;
+					break;
 				}
 #endif
 				flag_restore = 0;
@@ -1830,6 +1865,7 @@ static int run_list_real(struct pipe *pi)
 				list = make_list_in(pi->next->progs->argv,
 					pi->progs->argv[0]);
 				save_list = list;
+				for_pipe = pi;
 				save_name = pi->progs->argv[0];
 				pi->progs->argv[0] = NULL;
 				flag_rep = 1;
@@ -1900,7 +1936,8 @@ static int run_list_real(struct pipe *pi)
 #else
 		if (rcode < -1) {
 			last_return_code = -rcode - 2;
-			return -2;	/* exit */
+			rcode = -2;	/* exit */
+			break;
 		}
 		last_return_code=(rcode == 0) ? 0 : 1;
 #endif
@@ -1918,6 +1955,17 @@ static int run_list_real(struct pipe *pi)
 			skip_more_in_this_rmode=rmode;
 #ifndef __U_BOOT__
 		checkjobs(NULL);
+#endif
+	}
+	/* Put back the "for" variable if the loop was cut short */
+	if (list) {
+		free(for_pipe->progs->argv[0]);
+		while (*list)
+			free(*list++);
+		free(save_list);
+		for_pipe->progs->argv[0] = save_name;
+#ifndef __U_BOOT__
+		for_pipe->progs->glob_result.gl_pathv[0] = save_name;
 #endif
 	}
 	return rcode;
@@ -3169,6 +3217,120 @@ static void update_ifs_map(void)
 	mapset(ifs, 2);            /* also flow through if quoted */
 }
 
+#ifdef CONFIG_HUSH_PARSE_CACHE
+static uint parse_cache_hash(const char *s)
+{
+	uint hash = 5381;
+
+	while (*s)
+		hash = hash * 33 + (uchar)*s++;
+
+	return hash;
+}
+
+static void parse_cache_free(struct parse_cache *pc)
+{
+	int i;
+
+	for (i = 0; i < pc->count; i++)
+		free_pipe_list(pc->lines[i], 0);
+	free(pc->lines);
+	free(pc->text);
+	memset(pc, '\0', sizeof(*pc));
+}
+
+/**
+ * parse_cache_get() - find a script in the cache, or make an entry for it
+ *
+ * The entry is marked busy until the script has been run. A new entry
+ * replaces the least recently used one which is not busy.
+ *
+ * @s: script text
+ * @flag: FLAG_... used to parse the script
+ * Return: entry, which is ready if the script was found, or NULL if the
+ * script is already running or no entry is free
+ */
+static struct parse_cache *parse_cache_get(const char *s, int flag)
+{
+	struct parse_cache *pc, *victim = NULL;
+	uint hash;
+
+	if (!(gd->flags & GD_FLG_RELOC))
+		return NULL;
+
+	hash = parse_cache_hash(s);
+	for (pc = parse_cache; pc < parse_cache + PARSE_CACHE_SIZE; pc++) {
+		if (pc->text && pc->hash == hash && pc->flag == flag &&
+		    !strcmp(pc->text, s)) {
+			if (pc->busy)
+				return NULL;
+			pc->busy = 1;
+			pc->used = ++parse_cache_seq;
+			return pc;
+		}
+		if (!pc->busy && (!victim || pc->used < victim->used))
+			victim = pc;
+	}
+	if (!victim)
+		return NULL;
+
+	parse_cache_free(victim);
+	victim->text = strdup(s);
+	if (!victim->text)
+		return NULL;
+	victim->hash = hash;
+	victim->flag = flag;
+	victim->busy = 1;
+	victim->used = ++parse_cache_seq;
+
+	return victim;
+}
+
+/* Run each line of a cached script, as parse_stream_outer() would */
+static int parse_cache_run(struct parse_cache *pc)
+{
+	int code = 1;
+	int i;
+
+	for (i = 0; i < pc->count; i++) {
+		code = run_list_real(pc->lines[i]);
+		if (code == -2) {	/* exit */
+			code = 0;
+			break;
+		}
+		if (code == -1)
+			flag_repeat = 0;
+	}
+	pc->busy = 0;
+
+	return (code != 0) ? 1 : 0;
+}
+
+/* Run a list, keeping it for the script being recorded, if any */
+static int run_list_cached(struct in_str *inp, struct pipe *pi)
+{
+	struct parse_cache *pc = inp->cache;
+	struct pipe **lines;
+	int rcode;
+
+	if (!pc)
+		return run_list(pi);
+
+	rcode = run_list_real(pi);
+	lines = realloc(pc->lines, (pc->count + 1) * sizeof(*lines));
+	if (!lines) {
+		free_pipe_list(pi, 0);
+		parse_cache_free(pc);
+		inp->cache = NULL;
+		return rcode;
+	}
+	lines[pc->count++] = pi;
+	pc->lines = lines;
+
+	return rcode;
+}
+#endif
+
 /* most recursion does not come through here, the exeception is
  * from builtin_source() */
 static int parse_stream_outer(struct in_str *inp, int flag)
@@ -3202,8 +3364,12 @@ static int parse_stream_outer(struct in_str *inp, int flag)
 			done_pipe(&ctx,PIPE_SEQ);
 #ifndef __U_BOOT__
 			run_list(ctx.list_head);
+#else
+#ifdef CONFIG_HUSH_PARSE_CACHE
+			code = run_list_cached(inp, ctx.list_head);
 #else
 			code = run_list(ctx.list_head);
+#endif
 			if (code == -2) {	/* exit */
 				b_free(&temp);
 				code = 0;
@@ -3225,6 +3391,13 @@ static int parse_stream_outer(struct in_str *inp, int flag)
 #ifdef __U_BOOT__
 			if (inp->__promptme == 0) printf("<INTERRUPT>\n");
 			inp->__promptme = 1;
+#endif
+#ifdef CONFIG_HUSH_PARSE_CACHE
+			/* Parse scripts with errors each time, to report them */
+			if (inp->cache) {
+				parse_cache_free(inp->cache);
+				inp->cache = NULL;
+			}
 #endif
 			temp.nonnull = 0;
 			temp.quote = 0;
@@ -3238,6 +3411,12 @@ static int parse_stream_outer(struct in_str *inp, int flag)
 #ifndef __U_BOOT__
 	return 0;
 #else
+#ifdef CONFIG_HUSH_PARSE_CACHE
+	if (inp->cache) {
+		inp->cache->ready = 1;
+		inp->cache->busy = 0;
+	}
+#endif
 	return (code != 0) ? 1 : 0;
 #endif /* __U_BOOT__ */
 }
@@ -3250,23 +3429,35 @@ int parse_string_outer(const char *s, int flag)
 {
 	struct in_str input;
 #ifdef __U_BOOT__
+	struct parse_cache *pc = NULL;
 	char *p = NULL;
 	int rcode;
 	if (!s)
 		return 1;
 	if (!*s)
 		return 0;
+#ifdef CONFIG_HUSH_PARSE_CACHE
+	if (flag & FLAG_CACHE_PARSE) {
+		pc = parse_cache_get(s, flag);
+		if (pc && pc->ready)
+			return parse_cache_run(pc);
+	}
+#endif
 	if (!(p = strchr(s, '\n')) || *++p) {
 		p = xmalloc(strlen(s) + 2);
 		strcpy(p, s);
 		strcat(p, "\n");
 		setup_string_in_str(&input, p);
+		input.cache = pc;
 		rcode = parse_stream_outer(&input, flag);
 		free(p);
 		return rcode;
 	} else {
 #endif
 	setup_string_in_str(&input, s);
+#ifdef __U_BOOT__
+	input.cache = pc;
+#endif
 	return parse_stream_outer(&input, flag);
 #ifdef __U_BOOT__
 	}
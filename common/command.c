@@ -14,6 +14,8 @@
 #include <console.h>
 #include <env.h>
 #include <log.h>
+#include <malloc.h>
+#include <sort.h>
 #include <asm/global_data.h>
 #include <linux/ctype.h>
 
@@ -123,10 +125,106 @@ struct cmd_tbl *find_cmd_tbl(const char *cmd, struct cmd_tbl *table,
 	return NULL;	/* not found or ambiguous command */
 }
 
+#if CONFIG_IS_ENABLED(CMDLINE_INDEX)
+/* Command table entries sorted by name, built on first use */
+static struct cmd_tbl **cmd_index;
+
+static int cmd_index_compare(const void *a, const void *b)
+{
+	struct cmd_tbl *const *pa = a, *const *pb = b;
+	int ret;
+
+	ret = strcmp((*pa)->name, (*pb)->name);
+	if (ret)
+		return ret;
+
+	/* Keep duplicate names in table order, so the first one is found */
+	return *pa < *pb ? -1 : *pa > *pb;
+}
+
+/**
+ * cmd_index_get() - get the sorted index of the command table
+ *
+ * The index is built after relocation, so that it holds the final addresses
+ * of the entries and lives in the full malloc() pool.
+ *
+ * @start:	first entry in the command table
+ * @count:	number of entries in the command table
+ * Return: index, or NULL if it is not available
+ */
+static struct cmd_tbl **cmd_index_get(struct cmd_tbl *start, int count)
+{
+	struct cmd_tbl **index;
+	int i;
+
+	if (cmd_index || !(gd->flags & GD_FLG_RELOC))
+		return cmd_index;
+
+	index = malloc(count * sizeof(*index));
+	if (!index)
+		return NULL;
+	for (i = 0; i < count; i++)
+		index[i] = start + i;
+	qsort(index, count, sizeof(*index), cmd_index_compare);
+	cmd_index = index;
+
+	return cmd_index;
+}
+
+/**
+ * find_cmd_index() - find a command using the sorted index
+ *
+ * This gives the same result as find_cmd_tbl() with a binary search. The names
+ * starting with the command sort together, with a full match first.
+ *
+ * @cmd:	command to find, possibly with a '.' suffix
+ * @index:	sorted index
+ * @count:	number of entries in the index
+ * Return: command, or NULL if not found or ambiguous
+ */
+static struct cmd_tbl *find_cmd_index(const char *cmd, struct cmd_tbl **index,
+				      int count)
+{
+	const char *p;
+	int lo, hi, mid;
+	int len;
+
+	len = ((p = strchr(cmd, '.')) == NULL) ? strlen(cmd) : (p - cmd);
+
+	/* Find the first name which does not sort before the command */
+	lo = 0;
+	hi = count;
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (strncmp(index[mid]->name, cmd, len) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == count || strncmp(index[lo]->name, cmd, len))
+		return NULL;
+	if (strlen(index[lo]->name) == len)
+		return index[lo];	/* full match */
+
+	/* An abbreviation must match exactly one command */
+	if (lo + 1 < count && !strncmp(index[lo + 1]->name, cmd, len))
+		return NULL;
+
+	return index[lo];
+}
+#endif
+
 struct cmd_tbl *find_cmd(const char *cmd)
 {
 	struct cmd_tbl *start = ll_entry_start(struct cmd_tbl, cmd);
 	const int len = ll_entry_count(struct cmd_tbl, cmd);
+
+#if CONFIG_IS_ENABLED(CMDLINE_INDEX)
+	struct cmd_tbl **index = cmd_index_get(start, len);
+
+	if (cmd && index)
+		return find_cmd_index(cmd, index, len);
+#endif
 	return find_cmd_tbl(cmd, start, len);
 }
 
@@ -9,6 +9,7 @@
 #include <common.h>
 #include <env.h>
 #include <log.h>
+#include <malloc.h>
 #include <mapmem.h>
 #include <net.h>
 #include <stdio_dev.h>
@@ -76,6 +77,30 @@ u32 fdt_getprop_u32_default(const void *fdt, const char *path,
 	return fdt_getprop_u32_default_node(fdt, off, 0, prop, dflt);
 }
 
+/**
+ * fdt_update_prop: Set a property, in place if its size is unchanged
+ *
+ * @fdt: ptr to device tree
+ * @nodeoffset: offset of the node
+ * @name: property name
+ * @val: ptr to new value
+ * @len: length of new property value
+ *
+ * Fixups mostly rewrite a property which is already there with a value of
+ * the same size, e.g. a MAC address or a reg value. fdt_setprop() then still
+ * moves everything after the property, so overwrite the value instead.
+ */
+int fdt_update_prop(void *fdt, int nodeoffset, const char *name,
+		    const void *val, int len)
+{
+	int oldlen;
+
+	if (fdt_getprop(fdt, nodeoffset, name, &oldlen) && oldlen == len)
+		return fdt_setprop_inplace(fdt, nodeoffset, name, val, len);
+
+	return fdt_setprop(fdt, nodeoffset, name, val, len);
+}
+
 /**
  * fdt_find_and_setprop: Find a node and set it's property
  *
@@ -99,7 +124,7 @@ int fdt_find_and_setprop(void *fdt, const char *node, const char *prop,
 	if ((!create) && (fdt_get_property(fdt, nodeoff, prop, NULL) == NULL))
 		return 0; /* create flag not set; so exit quietly */
 
-	return fdt_setprop(fdt, nodeoff, prop, val, len);
+	return fdt_update_prop(fdt, nodeoff, prop, val, len);
 }
 
 /**
@@ -154,7 +179,7 @@ static int fdt_fixup_stdout(void *fdt, int chosenoff)
 	/* fdt_setprop may break "path" so we copy it to tmp buffer */
 	memcpy(tmp, path, len);
 
-	err = fdt_setprop(fdt, chosenoff, "linux,stdout-path", tmp, len);
+	err = fdt_update_prop(fdt, chosenoff, "linux,stdout-path", tmp, len);
 	if (err < 0)
 		printf("WARNING: could not set linux,stdout-path %s.\n",
 		       fdt_strerror(err));
@@ -177,10 +202,15 @@ static int fdt_fixup_stdout(void *fdt, int chosenoff)
 static inline int fdt_setprop_uxx(void *fdt, int nodeoffset, const char *name,
 				  uint64_t val, int is_u64)
 {
+	fdt64_t val64 = cpu_to_fdt64(val);
+	fdt32_t val32 = cpu_to_fdt32(val);
+
 	if (is_u64)
-		return fdt_setprop_u64(fdt, nodeoffset, name, val);
+		return fdt_update_prop(fdt, nodeoffset, name, &val64,
+				       sizeof(val64));
 	else
-		return fdt_setprop_u32(fdt, nodeoffset, name, (uint32_t)val);
+		return fdt_update_prop(fdt, nodeoffset, name, &val32,
+				       sizeof(val32));
 }
 
 int fdt_root(void *fdt)
@@ -288,8 +318,8 @@ int fdt_chosen(void *fdt)
 
 	str = env_get("bootargs");
 	if (str) {
-		err = fdt_setprop(fdt, nodeoffset, "bootargs", str,
-				  strlen(str) + 1);
+		err = fdt_update_prop(fdt, nodeoffset, "bootargs", str,
+				      strlen(str) + 1);
 		if (err < 0) {
 			printf("WARNING: could not set bootargs %s.\n",
 			       fdt_strerror(err));
@@ -339,7 +369,7 @@ void do_fixup_by_prop(void *fdt,
 	off = fdt_node_offset_by_prop_value(fdt, -1, pname, pval, plen);
 	while (off != -FDT_ERR_NOTFOUND) {
 		if (create || (fdt_get_property(fdt, off, prop, NULL) != NULL))
-			fdt_setprop(fdt, off, prop, val, len);
+			fdt_update_prop(fdt, off, prop, val, len);
 		off = fdt_node_offset_by_prop_value(fdt, off, pname, pval, plen);
 	}
 }
@@ -366,7 +396,7 @@ void do_fixup_by_compat(void *fdt, const char *compat,
 	off = fdt_node_offset_by_compatible(fdt, -1, compat);
 	while (off != -FDT_ERR_NOTFOUND) {
 		if (create || (fdt_get_property(fdt, off, prop, NULL) != NULL))
-			fdt_setprop(fdt, off, prop, val, len);
+			fdt_update_prop(fdt, off, prop, val, len);
 		off = fdt_node_offset_by_compatible(fdt, off, compat);
 	}
 }
@@ -436,8 +466,8 @@ int fdt_fixup_memory_banks(void *blob, u64 start[], u64 size[], int banks)
 	if (nodeoffset < 0)
 			return nodeoffset;
 
-	err = fdt_setprop(blob, nodeoffset, "device_type", "memory",
-			sizeof("memory"));
+	err = fdt_update_prop(blob, nodeoffset, "device_type", "memory",
+			      sizeof("memory"));
 	if (err < 0) {
 		printf("WARNING: could not set %s %s.\n", "device_type",
 				fdt_strerror(err));
@@ -456,7 +486,7 @@ int fdt_fixup_memory_banks(void *blob, u64 start[], u64 size[], int banks)
 
 	len = fdt_pack_reg(blob, tmp, start, size, banks);
 
-	err = fdt_setprop(blob, nodeoffset, "reg", tmp, len);
+	err = fdt_update_prop(blob, nodeoffset, "reg", tmp, len);
 	if (err < 0) {
 		printf("WARNING: could not set %s %s.\n",
 				"reg", fdt_strerror(err));
@@ -490,7 +520,8 @@ int fdt_set_usable_memory(void *blob, u64 start[], u64 size[], int areas)
 
 	len = fdt_pack_reg(blob, tmp, start, size, areas);
 
-	err = fdt_setprop(blob, nodeoffset, "linux,usable-memory", tmp, len);
+	err = fdt_update_prop(blob, nodeoffset, "linux,usable-memory", tmp,
+			      len);
 	if (err < 0) {
 		printf("WARNING: could not set %s %s.\n",
 		       "reg", fdt_strerror(err));
@@ -1532,33 +1563,33 @@ unsigned int fdt_create_phandle(void *fdt, int nodeoffset)
 int fdt_set_node_status(void *fdt, int nodeoffset,
 			enum fdt_status status, unsigned int error_code)
 {
+	const char *str;
 	char buf[16];
-	int ret = 0;
 
 	if (nodeoffset < 0)
 		return nodeoffset;
 
 	switch (status) {
 	case FDT_STATUS_OKAY:
-		ret = fdt_setprop_string(fdt, nodeoffset, "status", "okay");
+		str = "okay";
 		break;
 	case FDT_STATUS_DISABLED:
-		ret = fdt_setprop_string(fdt, nodeoffset, "status", "disabled");
+		str = "disabled";
 		break;
 	case FDT_STATUS_FAIL:
-		ret = fdt_setprop_string(fdt, nodeoffset, "status", "fail");
+		str = "fail";
 		break;
 	case FDT_STATUS_FAIL_ERROR_CODE:
 		sprintf(buf, "fail-%d", error_code);
-		ret = fdt_setprop_string(fdt, nodeoffset, "status", buf);
+		str = buf;
 		break;
 	default:
 		printf("Invalid fdt status: %x\n", status);
-		ret = -1;
-		break;
+		return -1;
 	}
 
-	return ret;
+	return fdt_update_prop(fdt, nodeoffset, "status", str,
+			       strlen(str) + 1);
 }
 
 /*
@@ -1867,16 +1898,41 @@ int fdt_fixup_display(void *blob, const char *path, const char *display)
 }
 
 #ifdef CONFIG_OF_LIBFDT_OVERLAY
-/**
- * fdt_overlay_apply_verbose - Apply an overlay with verbose error reporting
- *
- * @fdt: ptr to device tree
- * @fdto: ptr to device tree overlay
- *
- * Convenience function to apply an overlay and display helpful messages
- * in the case of an error
- */
-int fdt_overlay_apply_verbose(void *fdt, void *fdto)
+int fdt_overlay_index_alloc(const void *fdt, struct fdt_overlay_index *idx)
+{
+	struct fdt_phandle_entry *ents;
+	int size, ret;
+
+	ret = fdt_check_header(fdt);
+	if (ret)
+		return ret;
+
+	/*
+	 * A node with a phandle needs at least 28 bytes in the structure
+	 * block. Allow twice as many entries as that, plus some for nodes
+	 * added by overlays. Without memory, lookups just walk the tree.
+	 */
+	size = fdt_size_dt_struct(fdt) / 14 + 64;
+	ents = malloc(size * sizeof(*ents));
+	if (!ents)
+		size = 0;
+
+	ret = fdt_overlay_index_init(fdt, idx, ents, size);
+	if (ret)
+		free(ents);
+
+	return ret;
+}
+
+void fdt_overlay_index_free(struct fdt_overlay_index *idx)
+{
+	free(idx->ents);
+	idx->ents = NULL;
+	idx->size = 0;
+}
+
+int fdt_overlay_apply_index_verbose(void *fdt, void *fdto,
+				    struct fdt_overlay_index *idx)
 {
 	int err;
 	bool has_symbols;
@@ -1884,7 +1940,7 @@ int fdt_overlay_apply_verbose(void *fdt, void *fdto)
 	err = fdt_path_offset(fdt, "/__symbols__");
 	has_symbols = err >= 0;
 
-	err = fdt_overlay_apply(fdt, fdto);
+	err = fdt_overlay_apply_index(fdt, fdto, idx);
 	if (err < 0) {
 		printf("failed on fdt_overlay_apply(): %s\n",
 				fdt_strerror(err));
@@ -1895,4 +1951,18 @@ int fdt_overlay_apply_verbose(void *fdt, void *fdto)
 	}
 	return err;
 }
+
+/**
+ * fdt_overlay_apply_verbose - Apply an overlay with verbose error reporting
+ *
+ * @fdt: ptr to device tree
+ * @fdto: ptr to device tree overlay
+ *
+ * Convenience function to apply an overlay and display helpful messages
+ * in the case of an error
+ */
+int fdt_overlay_apply_verbose(void *fdt, void *fdto)
+{
+	return fdt_overlay_apply_index_verbose(fdt, fdto, NULL);
+}
 #endif
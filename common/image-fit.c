@@ -1664,6 +1664,99 @@ int fit_check_format(const void *fit, ulong size)
 	return 0;
 }
 
+int fit_conf_get_compat_node(const void *fit, int noffset, const void **fdtp)
+{
+	const char *kfdt_name;
+	int images_noffset, kfdt_noffset;
+	size_t sz;
+
+	/* If there's a compat property in the config node, use that. */
+	if (fdt_getprop(fit, noffset, "compatible", NULL)) {
+		*fdtp = fit;		/* search in FIT image */
+		return noffset;		/* search under config node */
+	}
+
+	/* Otherwise extract it from the kernel FDT. */
+	kfdt_name = fdt_getprop(fit, noffset, "fdt", NULL);
+	if (!kfdt_name) {
+		debug("No fdt property found.\n");
+		return -ENOENT;
+	}
+	images_noffset = fdt_path_offset(fit, FIT_IMAGES_PATH);
+	kfdt_noffset = fdt_subnode_offset(fit, images_noffset, kfdt_name);
+	if (kfdt_noffset < 0) {
+		debug("No image node named \"%s\" found.\n", kfdt_name);
+		return -ENOENT;
+	}
+
+	if (!fit_image_check_comp(fit, kfdt_noffset, IH_COMP_NONE)) {
+		debug("Can't extract compat from \"%s\" (compressed)\n",
+		      kfdt_name);
+		return -ENOENT;
+	}
+
+	/* search in this config's kernel FDT */
+	if (fit_image_get_data(fit, kfdt_noffset, fdtp, &sz)) {
+		debug("Failed to get fdt \"%s\".\n", kfdt_name);
+		return -ENOENT;
+	}
+
+	return 0;	/* search kFDT under root node */
+}
+
+/**
+ * fit_conf_find_compat_index() - Look up a configuration in the index
+ *
+ * The index is a list of pairs of strings, each giving a compatible string
+ * and the name of the first configuration which has it. See
+ * fit_conf_find_compat() for how it is used.
+ *
+ * @fit: FIT to search
+ * @confs_noffset: Offset of the configurations node
+ * @fdt_compat: Compatible strings of U-Boot's device tree
+ * @fdt_compat_len: Length of @fdt_compat in bytes
+ * @return offset of the configuration node, -ENOENT if there is no index,
+ *	-ENODEV if no configuration matches, -EINVAL if the index is not valid
+ */
+static int fit_conf_find_compat_index(const void *fit, int confs_noffset,
+				      const char *fdt_compat,
+				      int fdt_compat_len)
+{
+	const char *index, *end, *p, *compat, *conf;
+	int len, noffset;
+
+	index = fdt_getprop(fit, confs_noffset, FIT_COMPAT_INDEX_PROP, &len);
+	if (!index)
+		return -ENOENT;
+	end = index + len;
+
+	for (; fdt_compat_len > 0;
+	     fdt_compat_len -= len, fdt_compat += len) {
+		len = strnlen(fdt_compat, fdt_compat_len) + 1;
+		for (p = index; p < end;) {
+			compat = p;
+			p += strnlen(p, end - p) + 1;
+			conf = p;
+			p += strnlen(p, end - p) + 1;
+			if (p > end)
+				return -EINVAL;
+			if (strcmp(compat, fdt_compat))
+				continue;
+
+			noffset = fdt_subnode_offset(fit, confs_noffset, conf);
+			if (noffset < 0) {
+				debug("No configuration \"%s\" found.\n",
+				      conf);
+				return -EINVAL;
+			}
+
+			return noffset;
+		}
+	}
+
+	return -ENODEV;
+}
+
 /**
  * fit_conf_find_compat
  * @fit: pointer to the FIT format image header
@@ -1703,6 +1796,11 @@ int fit_check_format(const void *fit, ulong size)
  * copied into the configuration node in the FIT image. This is required to
  * match configurations with compressed FDTs.
  *
+ * If mkimage has added a compatible-index property to the configurations
+ * node, that is used instead of looking at each configuration in turn. This
+ * gives the same result and is much faster when there are many
+ * configurations.
+ *
  * returns:
  *     offset to the configuration to use if one was found
  *     -1 otherwise
@@ -1729,6 +1827,15 @@ int fit_conf_find_compat(const void *fit, const void *fdt)
 		return -1;
 	}
 
+	noffset = fit_conf_find_compat_index(fit, confs_noffset, fdt_compat,
+					     fdt_compat_len);
+	if (noffset >= 0)
+		return noffset;
+	if (noffset == -ENODEV) {
+		debug("No match found.\n");
+		return -1;
+	}
+
 	/*
 	 * Loop over the configurations in the FIT image.
 	 */
@@ -1736,49 +1843,17 @@ int fit_conf_find_compat(const void *fit, const void *fdt)
 			(noffset >= 0) && (ndepth > 0);
 			noffset = fdt_next_node(fit, noffset, &ndepth)) {
 		const void *fdt;
-		const char *kfdt_name;
-		int kfdt_noffset, compat_noffset;
+		int compat_noffset;
 		const char *cur_fdt_compat;
 		int len;
-		size_t sz;
 		int i;
 
 		if (ndepth > 1)
 			continue;
 
-		/* If there's a compat property in the config node, use that. */
-		if (fdt_getprop(fit, noffset, "compatible", NULL)) {
-			fdt = fit;		  /* search in FIT image */
-			compat_noffset = noffset; /* search under config node */
-		} else {	/* Otherwise extract it from the kernel FDT. */
-			kfdt_name = fdt_getprop(fit, noffset, "fdt", &len);
-			if (!kfdt_name) {
-				debug("No fdt property found.\n");
-				continue;
-			}
-			kfdt_noffset = fdt_subnode_offset(fit, images_noffset,
-							  kfdt_name);
-			if (kfdt_noffset < 0) {
-				debug("No image node named \"%s\" found.\n",
-				      kfdt_name);
-				continue;
-			}
-
-			if (!fit_image_check_comp(fit, kfdt_noffset,
-						  IH_COMP_NONE)) {
-				debug("Can't extract compat from \"%s\" "
-				      "(compressed)\n", kfdt_name);
-				continue;
-			}
-
-			/* search in this config's kernel FDT */
-			if (fit_image_get_data(fit, kfdt_noffset, &fdt, &sz)) {
-				debug("Failed to get fdt \"%s\".\n", kfdt_name);
-				continue;
-			}
-
-			compat_noffset = 0;  /* search kFDT under root node */
-		}
+		compat_noffset = fit_conf_get_compat_node(fit, noffset, &fdt);
+		if (compat_noffset < 0)
+			continue;
 
 		len = fdt_compat_len;
 		cur_fdt_compat = fdt_compat;
@@ -2263,6 +2338,7 @@ int boot_get_fdt_fit(bootm_headers_t *images, ulong addr,
 	const char *uconfig;
 	const char *uname;
 	void *base, *ov;
+	struct fdt_overlay_index ov_idx = {};
 	int i, err, noffset, ov_noffset;
 #endif
 
@@ -2317,6 +2393,14 @@ int boot_get_fdt_fit(bootm_headers_t *images, ulong addr,
 
 	base = map_sysmem(load, len);
 
+	/* index the base tree once rather than walking it for each overlay */
+	err = fdt_overlay_index_alloc(base, &ov_idx);
+	if (err < 0) {
+		printf("failed on fdt_overlay_index_alloc\n");
+		fdt_noffset = err;
+		goto out;
+	}
+
 	/* apply extra configs in FIT first, followed by args */
 	for (i = 1; ; i++) {
 		if (i < count) {
@@ -2369,7 +2453,7 @@ int boot_get_fdt_fit(bootm_headers_t *images, ulong addr,
 			goto out;
 		}
 		/* the verbose method prints out messages on error */
-		err = fdt_overlay_apply_verbose(base, ov);
+		err = fdt_overlay_apply_index_verbose(base, ov, &ov_idx);
 		if (err < 0) {
 			fdt_noffset = err;
 			goto out;
@@ -2383,6 +2467,9 @@ int boot_get_fdt_fit(bootm_headers_t *images, ulong addr,
 #endif
 
 out:
+#ifdef CONFIG_OF_LIBFDT_OVERLAY
+	fdt_overlay_index_free(&ov_idx);
+#endif
 	if (datap)
 		*datap = load;
 	if (lenp)
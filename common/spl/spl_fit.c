@@ -8,14 +8,17 @@
 #include <errno.h>
 #include <fpga.h>
 #include <gzip.h>
+#include <hash.h>
 #include <image.h>
 #include <log.h>
 #include <malloc.h>
+#include <memalign.h>
 #include <spl.h>
 #include <sysinfo.h>
 #include <asm/cache.h>
 #include <asm/global_data.h>
 #include <linux/libfdt.h>
+#include <linux/sizes.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -27,6 +30,9 @@ DECLARE_GLOBAL_DATA_PTR;
 #define CONFIG_SYS_BOOTM_LEN	(64 << 20)
 #endif
 
+/* Amount of image data read from a raw device between two hash updates */
+#define SPL_FIT_HASH_CHUNK	SZ_64K
+
 struct spl_fit_info {
 	const void *fit;	/* Pointer to a valid FIT blob */
 	size_t ext_data_offset;	/* Offset to FIT external data (end of FIT) */
@@ -34,6 +40,21 @@ struct spl_fit_info {
 	int conf_node;		/* FDT offset to selected configuration node */
 };
 
+/**
+ * struct spl_fit_hash - hash of an image computed while it is being read
+ *
+ * @algo:	Progressive hash algorithm, or NULL if the image is checked
+ *		with fit_image_verify_with_data() after loading. This is set
+ *		back to NULL once @ctx has been freed.
+ * @ctx:	Hash context returned by @algo->hash_init()
+ * @noffset:	FDT offset of the hash node being checked
+ */
+struct spl_fit_hash {
+	struct hash_algo *algo;
+	void *ctx;
+	int noffset;
+};
+
 __weak void board_spl_fit_post_load(const void *fit)
 {
 }
@@ -213,6 +234,166 @@ static int get_aligned_image_size(struct spl_load_info *info, int data_size,
 	return (data_size + info->bl_len - 1) / info->bl_len;
 }
 
+/**
+ * spl_fit_hash_start(): set up hashing of an image while it is read
+ * @hash:	Hash state to set up
+ * @fit:	Pointer to the FIT blob
+ * @node:	Offset of the image node
+ *
+ * Hashing on read is only used for the common case of an image with a single
+ * hash node and no signatures. Anything else is left to
+ * fit_image_verify_with_data(), which needs the complete image in memory.
+ *
+ * Return:	true if @hash is ready for spl_fit_read_hashed(), false if the
+ *		image must be verified after loading
+ */
+static bool spl_fit_hash_start(struct spl_fit_hash *hash, const void *fit,
+			       int node)
+{
+	const void *blob = gd_fdt_blob();
+	struct hash_algo *algo;
+	int noffset, hash_node = -1;
+	char *name;
+
+	hash->algo = NULL;
+	if (!IS_ENABLED(CONFIG_SPL_FIT_HASH_ON_READ))
+		return false;
+
+	/* Required keys mean a signature check on the whole image */
+	if (FIT_IMAGE_ENABLE_VERIFY && blob &&
+	    fdt_subnode_offset(blob, 0, FIT_SIG_NODENAME) >= 0)
+		return false;
+
+	fdt_for_each_subnode(noffset, fit, node) {
+		const char *sub = fit_get_name(fit, noffset, NULL);
+
+		if (!strncmp(sub, FIT_SIG_NODENAME, strlen(FIT_SIG_NODENAME)))
+			return false;
+		if (!strncmp(sub, FIT_HASH_NODENAME,
+			     strlen(FIT_HASH_NODENAME))) {
+			if (hash_node >= 0)
+				return false;
+			hash_node = noffset;
+		}
+	}
+	if (hash_node < 0)
+		return false;
+
+	/* Leave the hash-ignore handling to the normal check */
+	if (IMAGE_ENABLE_IGNORE &&
+	    fdt_getprop(fit, hash_node, FIT_IGNORE_PROP, NULL))
+		return false;
+
+	if (fit_image_hash_get_algo(fit, hash_node, &name) ||
+	    hash_progressive_lookup_algo(name, &algo) ||
+	    algo->hash_init(algo, &hash->ctx))
+		return false;
+
+	hash->algo = algo;
+	hash->noffset = hash_node;
+
+	return true;
+}
+
+/**
+ * spl_fit_hash_finish(): check the hash computed by spl_fit_read_hashed()
+ * @hash:	Hash state, which must have been set up by spl_fit_hash_start()
+ * @fit:	Pointer to the FIT blob
+ *
+ * Return:	0 if the hash matches, -EPERM if not, or another negative
+ *		error number
+ */
+static int spl_fit_hash_finish(struct spl_fit_hash *hash, const void *fit)
+{
+	struct hash_algo *algo = hash->algo;
+	uint8_t value[FIT_MAX_HASH_LEN];
+	uint8_t *fit_value;
+	int fit_value_len;
+
+	printf("%s", algo->name);
+	if (algo->hash_finish(algo, hash->ctx, value, sizeof(value)))
+		return -EIO;
+	/* hash_finish() has freed the context */
+	hash->algo = NULL;
+
+	if (fit_image_hash_get_value(fit, hash->noffset, &fit_value,
+				     &fit_value_len) ||
+	    fit_value_len != algo->digest_size ||
+	    memcmp(value, fit_value, fit_value_len)) {
+		printf(" error!\nBad hash value for '%s' hash node\n",
+		       fit_get_name(fit, hash->noffset, NULL));
+		return -EPERM;
+	}
+	puts("+ ");
+
+	return 0;
+}
+
+/**
+ * spl_fit_hash_abort(): free the hash context if it has not been finished
+ * @hash:	Hash state from spl_fit_hash_start()
+ */
+static void spl_fit_hash_abort(struct spl_fit_hash *hash)
+{
+	if (hash->algo) {
+		free(hash->ctx);
+		hash->algo = NULL;
+	}
+}
+
+/**
+ * spl_fit_read_hashed(): read image data, hashing it as it arrives
+ * @info:	points to information about the device to load data from
+ * @sector:	first sector (or byte offset for FS reads) to read
+ * @nr_sectors:	number of sectors (or bytes for FS reads) to read
+ * @buf:	buffer to read into
+ * @overhead:	offset of the image data within @buf
+ * @length:	size of the image data
+ * @hash:	hash state from spl_fit_hash_start(), if its @algo is NULL the
+ *		data is only read
+ *
+ * Raw devices are read in chunks of SPL_FIT_HASH_CHUNK so that each chunk is
+ * hashed while it is still in the cache, rather than in a second pass over
+ * the whole image once it has been loaded.
+ *
+ * Return:	0 on success or a negative error number.
+ */
+static int spl_fit_read_hashed(struct spl_load_info *info, ulong sector,
+			       int nr_sectors, void *buf, ulong overhead,
+			       size_t length, struct spl_fit_hash *hash)
+{
+	int chunk, count, done;
+	ulong hashed, end;
+
+	if (!hash->algo)
+		return info->read(info, sector, nr_sectors, buf) == nr_sectors ?
+			0 : -EIO;
+
+	if (info->filename)
+		chunk = nr_sectors;
+	else
+		chunk = max(SPL_FIT_HASH_CHUNK / info->bl_len, 1);
+
+	for (done = 0, hashed = overhead; done < nr_sectors; done += count) {
+		count = min(chunk, nr_sectors - done);
+		if (info->read(info, sector + done, count,
+			       buf + done * info->bl_len) != count)
+			return -EIO;
+
+		end = min((ulong)(done + count) * info->bl_len,
+			  overhead + length);
+		if (end <= hashed)
+			continue;
+		if (hash->algo->hash_update(hash->algo, hash->ctx,
+					    buf + hashed, end - hashed,
+					    end == overhead + length))
+			return -EIO;
+		hashed = end;
+	}
+
+	return 0;
+}
+
 /**
  * spl_load_fit_image(): load the image described in a certain FIT node
  * @info:	points to information about the device to load data from
@@ -237,6 +418,7 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 	ulong size;
 	ulong load_addr, load_ptr;
 	void *src;
+	void *stage = NULL;
 	ulong overhead;
 	int nr_sectors;
 	int align_len = ARCH_DMA_MINALIGN - 1;
@@ -244,6 +426,8 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 	const void *data;
 	const void *fit = ctx->fit;
 	bool external_data = false;
+	struct spl_fit_hash hash = { .algo = NULL };
+	int ret;
 
 	if (IS_ENABLED(CONFIG_SPL_FPGA) ||
 	    (IS_ENABLED(CONFIG_SPL_OS_BOOT) && IS_ENABLED(CONFIG_SPL_GZIP))) {
@@ -273,16 +457,47 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 		if (fit_image_get_data_size(fit, node, &len))
 			return -ENOENT;
 
-		load_ptr = (load_addr + align_len) & ~align_len;
 		length = len;
-
 		overhead = get_aligned_image_overhead(info, offset);
 		nr_sectors = get_aligned_image_size(info, length, offset);
 
-		if (info->read(info,
-			       sector + get_aligned_image_offset(info, offset),
-			       nr_sectors, (void *)load_ptr) != nr_sectors)
-			return -EIO;
+		/*
+		 * Compressed data is staged away from the load address, so
+		 * that it can be decompressed straight out of the read
+		 * buffer. Anything else is read as close to the load address
+		 * as alignment allows; when the load address and the data
+		 * offset are both aligned this is the load address itself
+		 * and no copy is needed afterwards.
+		 */
+		if (IS_ENABLED(CONFIG_SPL_GZIP) && image_comp == IH_COMP_GZIP) {
+			size = nr_sectors * info->bl_len;
+			stage = malloc_cache_aligned(size);
+			if (stage)
+				load_ptr = (ulong)stage;
+			else
+				load_ptr = (ulong)spl_get_load_buffer(0, size);
+
+			/*
+			 * gunzip() must not write over its own input, so stage
+			 * it past the largest image it may write if needed
+			 */
+			if (load_ptr < load_addr + CONFIG_SYS_BOOTM_LEN &&
+			    load_addr < load_ptr + size)
+				load_ptr = ALIGN(load_addr + CONFIG_SYS_BOOTM_LEN,
+						 ARCH_DMA_MINALIGN);
+		} else {
+			load_ptr = (load_addr + align_len) & ~align_len;
+		}
+
+		if (CONFIG_IS_ENABLED(FIT_SIGNATURE))
+			spl_fit_hash_start(&hash, fit, node);
+
+		sector += get_aligned_image_offset(info, offset);
+		ret = spl_fit_read_hashed(info, sector, nr_sectors,
+					  (void *)load_ptr, overhead, length,
+					  &hash);
+		if (ret)
+			goto out;
 
 		debug("External data: dst=%lx, offset=%x, size=%lx\n",
 		      load_ptr, offset, (unsigned long)length);
@@ -301,8 +516,15 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 	if (CONFIG_IS_ENABLED(FIT_SIGNATURE)) {
 		printf("## Checking hash(es) for Image %s ... ",
 		       fit_get_name(fit, node, NULL));
-		if (!fit_image_verify_with_data(fit, node, src, length))
-			return -EPERM;
+		if (hash.algo) {
+			ret = spl_fit_hash_finish(&hash, fit);
+			if (ret)
+				goto out;
+		} else if (!fit_image_verify_with_data(fit, node, src,
+						       length)) {
+			ret = -EPERM;
+			goto out;
+		}
 		puts("OK\n");
 	}
 
@@ -314,11 +536,13 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 		if (gunzip((void *)load_addr, CONFIG_SYS_BOOTM_LEN,
 			   src, &size)) {
 			puts("Uncompressing error\n");
-			return -EIO;
+			ret = -EIO;
+			goto out;
 		}
 		length = size;
-	} else {
-		memcpy((void *)load_addr, src, length);
+	} else if (src != (void *)load_addr) {
+		/* The read buffer may overlap the load address */
+		memmove((void *)load_addr, src, length);
 	}
 
 	if (image_info) {
@@ -332,8 +556,13 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 		else
 			image_info->entry_point = FDT_ERROR;
 	}
+	ret = 0;
 
-	return 0;
+out:
+	spl_fit_hash_abort(&hash);
+	free(stage);
+
+	return ret;
 }
 
 static bool os_takes_devicetree(uint8_t os)
@@ -463,6 +463,7 @@ unsigned long blk_dwrite(struct blk_desc *block_dev, lbaint_t start,
 		return -ENOSYS;
 
 	blkcache_invalidate(block_dev->if_type, block_dev->devnum);
+	block_dev->write_gen++;
 	return ops->write(dev, start, blkcnt, buffer);
 }
 
@@ -476,6 +477,7 @@ unsigned long blk_derase(struct blk_desc *block_dev, lbaint_t start,
 		return -ENOSYS;
 
 	blkcache_invalidate(block_dev->if_type, block_dev->devnum);
+	block_dev->write_gen++;
 	return ops->erase(dev, start, blkcnt);
 }
 
@@ -129,15 +129,29 @@ int device_unbind(struct udevice *dev)
  */
 void device_free(struct udevice *dev)
 {
+	bool combined = dev_get_flags(dev) & DM_FLAG_ALLOC_PRIV_COMBINED;
 	int size;
 
+	/*
+	 * At least two blocks share the allocation, so it starts with priv
+	 * if there is any, else with uclass_priv
+	 */
+	if (combined) {
+		if (dev->driver->priv_auto)
+			free(dev_get_priv(dev));
+		else
+			free(dev_get_uclass_priv(dev));
+		dev_bic_flags(dev, DM_FLAG_ALLOC_PRIV_COMBINED);
+	}
 	if (dev->driver->priv_auto) {
-		free(dev_get_priv(dev));
+		if (!combined)
+			free(dev_get_priv(dev));
 		dev_set_priv(dev, NULL);
 	}
 	size = dev->uclass->uc_drv->per_device_auto;
 	if (size) {
-		free(dev_get_uclass_priv(dev));
+		if (!combined)
+			free(dev_get_uclass_priv(dev));
 		dev_set_uclass_priv(dev, NULL);
 	}
 	if (dev->parent) {
@@ -146,8 +160,9 @@ void device_free(struct udevice *dev)
 			size = dev->parent->uclass->uc_drv->
 					per_child_auto;
 		}
-		if (size) {
-			free(dev_get_parent_priv(dev));
+		if (size || combined) {
+			if (!combined)
+				free(dev_get_parent_priv(dev));
 			dev_set_parent_priv(dev, NULL);
 		}
 	}
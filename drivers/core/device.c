@@ -34,6 +34,43 @@
 
 DECLARE_GLOBAL_DATA_PTR;
 
+/* Blocks carved from a combined allocation keep the alignment of malloc() */
+#define DM_ALLOC_ALIGN		(2 * sizeof(void *))
+#define DM_ALLOC_SIZE(size)	ALIGN(size, DM_ALLOC_ALIGN)
+
+/**
+ * device_alloc_block() - Allocate a zeroed block of data for a device
+ *
+ * @nextp: Next free space in the combined allocation holding the device, or
+ *	NULL to use calloc()
+ * @size: Size of the block in bytes
+ * @return pointer to the block, or NULL if out of memory
+ */
+static void *device_alloc_block(char **nextp, int size)
+{
+	void *ptr;
+
+	if (!nextp)
+		return calloc(1, size);
+	ptr = *nextp;
+	*nextp += DM_ALLOC_SIZE(size);
+
+	return ptr;
+}
+
+static int device_parent_plat_size(struct udevice *parent)
+{
+	int size;
+
+	if (!parent)
+		return 0;
+	size = parent->driver->per_child_plat_auto;
+	if (!size)
+		size = parent->uclass->uc_drv->per_child_plat_auto;
+
+	return size;
+}
+
 static int device_bind_common(struct udevice *parent, const struct driver *drv,
 			      const char *name, void *plat,
 			      ulong driver_data, ofnode node,
@@ -43,6 +80,8 @@ static int device_bind_common(struct udevice *parent, const struct driver *drv,
 	struct uclass *uc;
 	int size, ret = 0;
 	bool auto_seq = true;
+	bool alloc_plat = false;
+	char *next, **nextp = NULL;
 	void *ptr;
 
 	if (devp)
@@ -56,9 +95,38 @@ static int device_bind_common(struct udevice *parent, const struct driver *drv,
 		return ret;
 	}
 
-	dev = calloc(1, sizeof(struct udevice));
+	/*
+	 * For of-platdata, we try use the existing data, but if
+	 * plat_auto is larger, we must allocate a new space
+	 */
+	if (drv->plat_auto) {
+		alloc_plat = !plat;
+		if (CONFIG_IS_ENABLED(OF_PLATDATA) &&
+		    of_plat_size < drv->plat_auto)
+			alloc_plat = true;
+	}
+
+	/*
+	 * The plat blocks live exactly as long as the device, so they can
+	 * follow it in the same allocation. They then have no
+	 * DM_FLAG_ALLOC_... flag and go away when the device is freed.
+	 */
+	size = sizeof(struct udevice);
+	if (CONFIG_IS_ENABLED(DM_COMBINED_ALLOC)) {
+		size = DM_ALLOC_SIZE(size);
+		if (alloc_plat)
+			size += DM_ALLOC_SIZE(drv->plat_auto);
+		size += DM_ALLOC_SIZE(uc->uc_drv->per_device_plat_auto);
+		size += DM_ALLOC_SIZE(device_parent_plat_size(parent));
+	}
+
+	dev = calloc(1, size);
 	if (!dev)
 		return -ENOMEM;
+	if (CONFIG_IS_ENABLED(DM_COMBINED_ALLOC)) {
+		next = (char *)dev + DM_ALLOC_SIZE(sizeof(struct udevice));
+		nextp = &next;
+	}
 
 	INIT_LIST_HEAD(&dev->sibling_node);
 	INIT_LIST_HEAD(&dev->child_head);
@@ -94,21 +162,12 @@ static int device_bind_common(struct udevice *parent, const struct driver *drv,
 
 	/* Check if we need to allocate plat */
 	if (drv->plat_auto) {
-		bool alloc = !plat;
-
-		/*
-		 * For of-platdata, we try use the existing data, but if
-		 * plat_auto is larger, we must allocate a new space
-		 */
-		if (CONFIG_IS_ENABLED(OF_PLATDATA)) {
-			if (of_plat_size)
-				dev_or_flags(dev, DM_FLAG_OF_PLATDATA);
-			if (of_plat_size < drv->plat_auto)
-				alloc = true;
-		}
-		if (alloc) {
-			dev_or_flags(dev, DM_FLAG_ALLOC_PDATA);
-			ptr = calloc(1, drv->plat_auto);
+		if (CONFIG_IS_ENABLED(OF_PLATDATA) && of_plat_size)
+			dev_or_flags(dev, DM_FLAG_OF_PLATDATA);
+		if (alloc_plat) {
+			if (!nextp)
+				dev_or_flags(dev, DM_FLAG_ALLOC_PDATA);
+			ptr = device_alloc_block(nextp, drv->plat_auto);
 			if (!ptr) {
 				ret = -ENOMEM;
 				goto fail_alloc1;
@@ -126,8 +185,9 @@ static int device_bind_common(struct udevice *parent, const struct driver *drv,
 
 	size = uc->uc_drv->per_device_plat_auto;
 	if (size) {
-		dev_or_flags(dev, DM_FLAG_ALLOC_UCLASS_PDATA);
-		ptr = calloc(1, size);
+		if (!nextp)
+			dev_or_flags(dev, DM_FLAG_ALLOC_UCLASS_PDATA);
+		ptr = device_alloc_block(nextp, size);
 		if (!ptr) {
 			ret = -ENOMEM;
 			goto fail_alloc2;
@@ -136,12 +196,11 @@ static int device_bind_common(struct udevice *parent, const struct driver *drv,
 	}
 
 	if (parent) {
-		size = parent->driver->per_child_plat_auto;
-		if (!size)
-			size = parent->uclass->uc_drv->per_child_plat_auto;
+		size = device_parent_plat_size(parent);
 		if (size) {
-			dev_or_flags(dev, DM_FLAG_ALLOC_PARENT_PDATA);
-			ptr = calloc(1, size);
+			if (!nextp)
+				dev_or_flags(dev, DM_FLAG_ALLOC_PARENT_PDATA);
+			ptr = device_alloc_block(nextp, size);
 			if (!ptr) {
 				ret = -ENOMEM;
 				goto fail_alloc3;
@@ -336,6 +395,70 @@ static void *alloc_priv(int size, uint flags)
 	return priv;
 }
 
+static int device_parent_priv_size(struct udevice *dev)
+{
+	int size;
+
+	if (!dev->parent)
+		return 0;
+	size = dev->parent->driver->per_child_auto;
+	if (!size)
+		size = dev->parent->uclass->uc_drv->per_child_auto;
+
+	return size;
+}
+
+/**
+ * device_alloc_priv_combined() - Allocate priv data in a single block
+ *
+ * This handles the usual case, where none of priv, uclass_priv and parent_priv
+ * is set up yet and none needs DMA alignment. Any two or more of them needed
+ * are carved, in that order, out of one allocation which device_free() frees
+ * as a whole.
+ *
+ * @dev: Device to process
+ * @return 0 if OK, -ENOMEM if out of memory, -ENOENT if the blocks should be
+ *	allocated one by one
+ */
+static int device_alloc_priv_combined(struct udevice *dev)
+{
+	const struct uclass_driver *uc_drv = dev->uclass->uc_drv;
+	const struct driver *drv = dev->driver;
+	int size, uc_size, parent_size;
+	char *ptr;
+
+	if ((drv->flags & DM_FLAG_ALLOC_PRIV_DMA) ||
+	    (uc_drv->flags & DM_UC_FLAG_ALLOC_PRIV_DMA))
+		return -ENOENT;
+	if (dev_get_priv(dev) || dev_get_uclass_priv(dev) ||
+	    dev_get_parent_priv(dev))
+		return -ENOENT;
+
+	size = drv->priv_auto;
+	uc_size = uc_drv->per_device_auto;
+	parent_size = device_parent_priv_size(dev);
+	if (!!size + !!uc_size + !!parent_size < 2)
+		return -ENOENT;
+
+	ptr = calloc(1, DM_ALLOC_SIZE(size) + DM_ALLOC_SIZE(uc_size) +
+		     parent_size);
+	if (!ptr)
+		return -ENOMEM;
+	if (size) {
+		dev_set_priv(dev, ptr);
+		ptr += DM_ALLOC_SIZE(size);
+	}
+	if (uc_size) {
+		dev_set_uclass_priv(dev, ptr);
+		ptr += DM_ALLOC_SIZE(uc_size);
+	}
+	if (parent_size)
+		dev_set_parent_priv(dev, ptr);
+	dev_or_flags(dev, DM_FLAG_ALLOC_PRIV_COMBINED);
+
+	return 0;
+}
+
 /**
  * device_alloc_priv() - Allocate priv/plat data required by the device
  *
@@ -346,11 +469,17 @@ static int device_alloc_priv(struct udevice *dev)
 {
 	const struct driver *drv;
 	void *ptr;
-	int size;
+	int size, ret;
 
 	drv = dev->driver;
 	assert(drv);
 
+	if (CONFIG_IS_ENABLED(DM_COMBINED_ALLOC)) {
+		ret = device_alloc_priv_combined(dev);
+		if (ret != -ENOENT)
+			return ret;
+	}
+
 	/* Allocate private data if requested and not reentered */
 	if (drv->priv_auto && !dev_get_priv(dev)) {
 		ptr = alloc_priv(drv->priv_auto, drv->flags);
@@ -370,9 +499,7 @@ static int device_alloc_priv(struct udevice *dev)
 
 	/* Allocate parent data for this child */
 	if (dev->parent) {
-		size = dev->parent->driver->per_child_auto;
-		if (!size)
-			size = dev->parent->uclass->uc_drv->per_child_auto;
+		size = device_parent_priv_size(dev);
 		if (size && !dev_get_parent_priv(dev)) {
 			ptr = alloc_priv(size, drv->flags);
 			if (!ptr)
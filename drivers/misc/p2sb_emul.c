@@ -64,6 +64,8 @@ static int sandbox_p2sb_emul_read_config(const struct udevice *emul,
 		break;
 	case PCI_VENDOR_ID:
 		*valuep = SANDBOX_PCI_VENDOR_ID;
+		if (size == PCI_SIZE_32)
+			*valuep |= SANDBOX_PCI_P2SB_EMUL_ID << 16;
 		break;
 	case PCI_DEVICE_ID:
 		*valuep = SANDBOX_PCI_P2SB_EMUL_ID;
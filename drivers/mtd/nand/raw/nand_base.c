@@ -2298,6 +2298,57 @@ static int nand_setup_read_retry(struct mtd_info *mtd, int retry_mode)
 	return chip->setup_read_retry(mtd, retry_mode);
 }
 
+/**
+ * nand_read_cache_end_op - End a cache read
+ * @chip: The NAND chip
+ * @next: page the chip is reading into its page register, or -1 if none
+ *
+ * This issues READ CACHE END if a cache read is still running, so that the
+ * chip is ready for the next operation. The data of @next is dropped.
+ * This function does not select/unselect the CS line.
+ *
+ * Returns -1, the next page once the cache read has ended.
+ */
+static int nand_read_cache_end_op(struct nand_chip *chip, int next)
+{
+	if (next != -1)
+		chip->cmdfunc(nand_to_mtd(chip), NAND_CMD_READCACHEEND, -1, -1);
+
+	return -1;
+}
+
+/**
+ * nand_read_cache_op - Do a READ PAGE operation as part of a cache read
+ * @chip: The NAND chip
+ * @page: page to read
+ * @next: page the chip is reading into its page register, or -1 if none
+ * @last: last page of the cache read
+ *
+ * This issues READ CACHE SEQUENTIAL so that the chip reads the page after
+ * @page from the array while @page is transferred, or READ CACHE END when
+ * @page is @last. A new cache read is started if @page is not @next.
+ * This function does not select/unselect the CS line.
+ *
+ * Returns the page the chip is now reading, or -1 if none.
+ */
+static int nand_read_cache_op(struct nand_chip *chip, int page, int next,
+			      int last)
+{
+	struct mtd_info *mtd = nand_to_mtd(chip);
+
+	if (page != next) {
+		nand_read_cache_end_op(chip, next);
+		chip->cmdfunc(mtd, NAND_CMD_READ0, 0, page);
+		if (page == last)
+			return -1;
+	} else if (page == last) {
+		return nand_read_cache_end_op(chip, next);
+	}
+	chip->cmdfunc(mtd, NAND_CMD_READCACHESEQ, -1, -1);
+
+	return page + 1;
+}
+
 /**
  * nand_do_read_ops - [INTERN] Read data with ECC
  * @mtd: MTD device structure
@@ -2321,6 +2372,10 @@ static int nand_do_read_ops(struct mtd_info *mtd, loff_t from,
 	unsigned int max_bitflips = 0;
 	int retry_mode = 0;
 	bool ecc_fail = false;
+	int cache_next = -1;
+	int block_mask;
+
+	block_mask = (1 << (chip->phys_erase_shift - chip->page_shift)) - 1;
 
 	chipnr = (int)(from >> chip->chip_shift);
 	chip->select_chip(mtd, chipnr);
@@ -2358,7 +2413,20 @@ static int nand_do_read_ops(struct mtd_info *mtd, loff_t from,
 						 __func__, buf);
 
 read_retry:
-			if (nand_standard_page_accessors(&chip->ecc)) {
+			/*
+			 * Whole pages are read with cache reads where possible,
+			 * up to the end of the block or of the request
+			 */
+			if (NAND_HAS_CACHEREAD(chip) && aligned && !oob &&
+			    !retry_mode) {
+				int last = readlen >> chip->page_shift;
+
+				last = min(page + last - 1, page | block_mask);
+				cache_next = nand_read_cache_op(chip, page,
+						cache_next, last);
+			} else if (nand_standard_page_accessors(&chip->ecc)) {
+				cache_next = nand_read_cache_end_op(chip,
+								    cache_next);
 				ret = nand_read_page_op(chip, page, 0, NULL, 0);
 				if (ret)
 					break;
@@ -2422,6 +2490,9 @@ read_retry:
 			}
 
 			if (mtd->ecc_stats.failed - ecc_failures) {
+				/* End the cache read before a retry is set up */
+				cache_next = nand_read_cache_end_op(chip,
+								    cache_next);
 				if (retry_mode + 1 < chip->read_retries) {
 					retry_mode++;
 					ret = nand_setup_read_retry(mtd,
@@ -2472,6 +2543,7 @@ read_retry:
 			chip->select_chip(mtd, chipnr);
 		}
 	}
+	nand_read_cache_end_op(chip, cache_next);
 	chip->select_chip(mtd, -1);
 
 	ops->retlen = ops->len - (size_t) readlen;
@@ -3972,6 +4044,10 @@ static int nand_flash_detect_onfi(struct mtd_info *mtd, struct nand_chip *chip,
 	else
 		*busw = 0;
 
+	if (IS_ENABLED(CONFIG_SYS_NAND_CACHE_READ) &&
+	    (le16_to_cpu(p->opt_cmd) & ONFI_OPT_CMD_READ_CACHE))
+		chip->options |= NAND_CACHEREAD;
+
 	if (p->ecc_bits != 0xff) {
 		chip->ecc_strength_ds = p->ecc_bits;
 		chip->ecc_step_ds = 512;
@@ -5264,6 +5340,15 @@ int nand_scan_tail(struct mtd_info *mtd)
 		break;
 	}
 
+	/*
+	 * Cache reads need the generic command function, which knows the
+	 * cache commands, and page readers which only stream the data out
+	 */
+	if (chip->cmdfunc != nand_command_lp ||
+	    !nand_standard_page_accessors(ecc) ||
+	    ecc->read_page == nand_read_page_hwecc_oob_first)
+		chip->options &= ~NAND_CACHEREAD;
+
 	/* Fill in remaining MTD driver data */
 	mtd->type = nand_is_slc(chip) ? MTD_NANDFLASH : MTD_MLCNANDFLASH;
 	mtd->flags = (chip->options & NAND_ROM) ? MTD_CAP_ROM :
@@ -63,6 +63,7 @@
 #include <dm/devres.h>
 #include <linux/bug.h>
 #include <linux/compat.h>
+#include <linux/delay.h>
 #include <linux/mtd/mtd.h>
 #include <linux/mtd/bbm.h>
 #include <linux/mtd/rawnand.h>
@@ -441,6 +442,75 @@ static int scan_block_fast(struct mtd_info *mtd, struct nand_bbt_descr *bd,
 	return 0;
 }
 
+/*
+ * Scan a given block partially, with the chip held and selected by the caller.
+ * This runs in the middle of an erase or a bad block check, so it must not go
+ * through mtd_read_oob(), which would release and deselect the chip.
+ */
+static int scan_block_held(struct mtd_info *mtd, struct nand_bbt_descr *bd,
+			   loff_t offs, int numpages)
+{
+	struct nand_chip *this = mtd_to_nand(mtd);
+	int page = (int)(offs >> this->page_shift) & this->pagemask;
+	int j, ret;
+
+	for (j = 0; j < numpages; j++) {
+		ret = this->ecc.read_oob(mtd, this, page + j);
+		if (ret < 0)
+			return ret;
+
+		if (this->options & NAND_NEED_READRDY) {
+			if (!this->dev_ready)
+				udelay(this->chip_delay);
+			else
+				nand_wait_ready(mtd);
+		}
+
+		if (check_short_pattern(this->oob_poi, bd))
+			return 1;
+	}
+	return 0;
+}
+
+/**
+ * scan_block_lazy - [GENERIC] Fill in the memory based bbt entry of a block
+ * @mtd: MTD device structure
+ * @block: block to check
+ *
+ * Read the bad block marker of a block the first time it is checked, when the
+ * memory based bad block table is filled in on demand. This avoids scanning
+ * the whole device before the first access. The caller must hold the device
+ * with the chip containing @block selected; it stays selected.
+ */
+static void scan_block_lazy(struct mtd_info *mtd, int block)
+{
+	struct nand_chip *this = mtd_to_nand(mtd);
+	struct nand_bbt_descr *bd = this->badblock_pattern;
+	int numpages = bd->options & NAND_BBT_SCAN2NDPAGE ? 2 : 1;
+	loff_t from = (loff_t)block << this->bbt_erase_shift;
+	int ret;
+
+	if (this->bbt_scanned[block >> 3] & BIT(block & 7))
+		return;
+
+	if (this->bbt_options & NAND_BBT_SCANLASTPAGE)
+		from += mtd->erasesize - (mtd->writesize * numpages);
+
+	ret = scan_block_held(mtd, bd, from, numpages);
+	/* The chip no longer holds the cached page */
+	this->pagebuf = -1;
+	if (ret < 0)
+		return;
+
+	if (ret) {
+		bbt_mark_entry(this, block, BBT_BLOCK_FACTORY_BAD);
+		pr_warn("Bad eraseblock %d at 0x%012llx\n", block,
+			(unsigned long long)from);
+		mtd->ecc_stats.badblocks++;
+	}
+	this->bbt_scanned[block >> 3] |= BIT(block & 7);
+}
+
 /**
  * create_bbt - [GENERIC] Create a bad block table by scanning the device
  * @mtd: MTD device structure
@@ -1077,24 +1147,33 @@ static int nand_scan_bbt(struct mtd_info *mtd, struct nand_bbt_descr *bd)
 {
 	struct nand_chip *this = mtd_to_nand(mtd);
 	int len, res;
+	int scanned_len = 0;
 	uint8_t *buf;
 	struct nand_bbt_descr *td = this->bbt_td;
 	struct nand_bbt_descr *md = this->bbt_md;
+	bool lazy = !td && IS_ENABLED(CONFIG_SYS_NAND_LAZY_BBT);
 
 	len = (mtd->size >> (this->bbt_erase_shift + 2)) ? : 1;
+	if (lazy)
+		scanned_len = DIV_ROUND_UP(mtd->size >> this->bbt_erase_shift,
+					   8);
 	/*
-	 * Allocate memory (2bit per block) and clear the memory bad block
-	 * table.
+	 * Allocate memory (2bit per block, plus 1bit per block if the table
+	 * is filled in on demand) and clear the memory bad block table.
 	 */
-	this->bbt = kzalloc(len, GFP_KERNEL);
+	this->bbt = kzalloc(len + scanned_len, GFP_KERNEL);
 	if (!this->bbt)
 		return -ENOMEM;
+	this->bbt_scanned = lazy ? this->bbt + len : NULL;
 
 	/*
 	 * If no primary table decriptor is given, scan the device to build a
-	 * memory based bad block table.
+	 * memory based bad block table. With a lazy table, each block is
+	 * scanned when it is first checked instead.
 	 */
 	if (!td) {
+		if (lazy)
+			return 0;
 		if ((res = nand_memory_bbt(mtd, bd))) {
 			pr_err("nand_bbt: can't scan flash and build the RAM-based BBT\n");
 			goto err;
@@ -1337,6 +1416,8 @@ int nand_isbad_bbt(struct mtd_info *mtd, loff_t offs, int allowbbt)
 	int block, res;
 
 	block = (int)(offs >> this->bbt_erase_shift);
+	if (this->bbt_scanned)
+		scan_block_lazy(mtd, block);
 	res = bbt_get_entry(this, block);
 
 	pr_debug("nand_isbad_bbt(): bbt info for offs 0x%08x: (block %d) 0x%02x\n",
@@ -1367,6 +1448,8 @@ int nand_markbad_bbt(struct mtd_info *mtd, loff_t offs)
 
 	/* Mark bad block in memory */
 	bbt_mark_entry(this, block, BBT_BLOCK_WORN);
+	if (this->bbt_scanned)
+		this->bbt_scanned[block >> 3] |= BIT(block & 7);
 
 	/* Update flash-based bad block table */
 	if (this->bbt_options & NAND_BBT_USE_FLASH)
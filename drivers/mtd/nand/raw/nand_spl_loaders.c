@@ -1,3 +1,71 @@
+#ifdef CONFIG_SPL_NAND_BAD_BLOCK_CACHE
+#include <bloblist.h>
+#include <asm/global_data.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#define NAND_BBC_BLOCKS	CONFIG_SPL_NAND_BAD_BLOCK_CACHE_BLOCKS
+#define NAND_BBC_SIZE	(sizeof(struct nand_bbt_handoff) + \
+			 DIV_ROUND_UP(NAND_BBC_BLOCKS, 4))
+
+/**
+ * nand_get_bbc() - Get the bad block cache
+ *
+ * This uses the bloblist if there is one, so that blocks checked in an
+ * earlier phase need not be checked again, otherwise a static buffer.
+ *
+ * @return the bad block cache
+ */
+static struct nand_bbt_handoff *nand_get_bbc(void)
+{
+	static u8 buf[NAND_BBC_SIZE] __aligned(4);
+	static struct nand_bbt_handoff *bbc;
+
+	if (bbc)
+		return bbc;
+#if CONFIG_IS_ENABLED(BLOBLIST)
+	if (gd->bloblist)
+		bbc = bloblist_ensure(BLOBLISTT_NAND_BBT, NAND_BBC_SIZE);
+#endif
+	if (!bbc)
+		bbc = (struct nand_bbt_handoff *)buf;
+	if (bbc->block_size != CONFIG_SYS_NAND_BLOCK_SIZE ||
+	    bbc->num_blocks != NAND_BBC_BLOCKS) {
+		memset(bbc, '\0', NAND_BBC_SIZE);
+		bbc->block_size = CONFIG_SYS_NAND_BLOCK_SIZE;
+		bbc->num_blocks = NAND_BBC_BLOCKS;
+	}
+
+	return bbc;
+}
+#endif
+
+/* Check if a block is bad, reading its marker only if not yet known */
+static int nand_spl_block_isbad(unsigned int block)
+{
+#ifdef CONFIG_SPL_NAND_BAD_BLOCK_CACHE
+	struct nand_bbt_handoff *bbc = nand_get_bbc();
+	int shift = (block % 4) * 2;
+	int bad;
+
+	if (block < bbc->num_blocks) {
+		switch ((bbc->state[block / 4] >> shift) & 3) {
+		case NAND_BBT_HANDOFF_GOOD:
+			return 0;
+		case NAND_BBT_HANDOFF_BAD:
+			return 1;
+		}
+		bad = nand_is_bad_block(block);
+		bbc->state[block / 4] |= (bad ? NAND_BBT_HANDOFF_BAD :
+					  NAND_BBT_HANDOFF_GOOD) << shift;
+
+		return bad;
+	}
+#endif
+
+	return nand_is_bad_block(block);
+}
+
 int nand_spl_load_image(uint32_t offs, unsigned int size, void *dst)
 {
 	unsigned int block, lastblock;
@@ -10,7 +78,7 @@ int nand_spl_load_image(uint32_t offs, unsigned int size, void *dst)
 	page_offset = offs % CONFIG_SYS_NAND_PAGE_SIZE;
 
 	while (block <= lastblock) {
-		if (!nand_is_bad_block(block)) {
+		if (!nand_spl_block_isbad(block)) {
 			/* Skip bad blocks */
 			while (page < CONFIG_SYS_NAND_PAGE_COUNT) {
 				nand_read_page(block, page, dst);
@@ -58,7 +126,7 @@ u32 nand_spl_adjust_offset(u32 sector, u32 offs)
 	lastblock = (sector + offs) / CONFIG_SYS_NAND_BLOCK_SIZE;
 
 	while (block <= lastblock) {
-		if (nand_is_bad_block(block)) {
+		if (nand_spl_block_isbad(block)) {
 			offs += CONFIG_SYS_NAND_BLOCK_SIZE;
 			lastblock++;
 		}
@@ -95,6 +95,7 @@ int nand_erase_opts(struct mtd_info *mtd,
 			kfree(chip->bbt);
 		}
 		chip->bbt = NULL;
+		chip->bbt_scanned = NULL;
 		chip->options &= ~NAND_BBT_SCANNED;
 	}
 
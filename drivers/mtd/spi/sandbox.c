@@ -94,6 +94,8 @@ struct sandbox_spi_flash {
 	const struct flash_info *data;
 	/* The file on disk to serv up data from */
 	int fd;
+	/* Number of erase commands received, indexed by opcode */
+	uint erase_count[0x100];
 };
 
 struct sandbox_spi_flash_plat_data {
@@ -111,6 +113,13 @@ void sandbox_sf_set_block_protect(struct udevice *dev, int bp_mask)
 	sbsf->status |= bp_mask << STAT_BP_SHIFT;
 }
 
+uint sandbox_sf_get_erase_count(struct udevice *dev, u8 opcode)
+{
+	struct sandbox_spi_flash *sbsf = dev_get_priv(dev);
+
+	return sbsf->erase_count[opcode];
+}
+
 /**
  * This is a very strange probe function. If it has platform data (which may
  * have come from the device tree) then this function gets the filename and
@@ -274,16 +283,28 @@ static int sandbox_sf_process_cmd(struct sandbox_spi_flash *sbsf, const u8 *rx,
 
 		/* we only support erase here */
 		if (sbsf->cmd == SPINOR_OP_CHIP_ERASE) {
+			/* no address: erase the whole array straight away */
 			sbsf->erase_size = sbsf->data->sector_size *
 				sbsf->data->n_sectors;
+			sbsf->off = 0;
+			if (os_lseek(sbsf->fd, 0, OS_SEEK_SET) < 0) {
+				puts("sandbox_sf: os_lseek() failed");
+				return -EIO;
+			}
+			sbsf->state = SF_ERASE;
+			sbsf->erase_count[sbsf->cmd]++;
+			break;
 		} else if (sbsf->cmd == SPINOR_OP_BE_4K && (flags & SECT_4K)) {
 			sbsf->erase_size = 4 << 10;
-		} else if (sbsf->cmd == SPINOR_OP_SE && !(flags & SECT_4K)) {
+		} else if (sbsf->cmd == SPINOR_OP_BE_32K && (flags & SECT_4K)) {
+			sbsf->erase_size = 32 << 10;
+		} else if (sbsf->cmd == SPINOR_OP_SE) {
 			sbsf->erase_size = 64 << 10;
 		} else {
 			debug(" cmd unknown: %#x\n", sbsf->cmd);
 			return -EIO;
 		}
+		sbsf->erase_count[sbsf->cmd]++;
 		sbsf->state = SF_ADDR;
 		break;
 	}
@@ -336,8 +357,8 @@ static int sandbox_sf_xfer(struct udevice *dev, unsigned int bitlen,
 		++pos;
 	}
 
-	/* Process the remaining data */
-	while (pos < bytes) {
+	/* Process the remaining data; a chip erase has none */
+	while (pos < bytes || sbsf->state == SF_ERASE) {
 		switch (sbsf->state) {
 		case SF_ID: {
 			u8 id;
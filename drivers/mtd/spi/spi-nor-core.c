@@ -39,6 +39,12 @@
 
 #define DEFAULT_READY_WAIT_JIFFIES		(40UL * HZ)
 
+/*
+ * For full-chip erase, calibrated to a 2MB flash (M25P16); should be scaled up
+ * for larger flash
+ */
+#define CHIP_ERASE_2MB_READY_WAIT_JIFFIES	(40UL * HZ)
+
 static int spi_nor_read_write_reg(struct spi_nor *nor, struct spi_mem_op
 		*op, void *buf)
 {
@@ -74,6 +80,18 @@ static int spi_nor_write_reg(struct spi_nor *nor, u8 opcode, u8 *buf, int len)
 	return spi_nor_read_write_reg(nor, &op, buf);
 }
 
+static void spi_nor_setup_read_op(struct spi_nor *nor, struct spi_mem_op *op)
+{
+	/* get transfer protocols. */
+	op->cmd.buswidth = spi_nor_get_protocol_inst_nbits(nor->read_proto);
+	op->addr.buswidth = spi_nor_get_protocol_addr_nbits(nor->read_proto);
+	op->dummy.buswidth = op->addr.buswidth;
+	op->data.buswidth = spi_nor_get_protocol_data_nbits(nor->read_proto);
+
+	/* convert the dummy cycles to the number of bytes */
+	op->dummy.nbytes = (nor->read_dummy * op->dummy.buswidth) / 8;
+}
+
 static ssize_t spi_nor_read_data(struct spi_nor *nor, loff_t from, size_t len,
 				 u_char *buf)
 {
@@ -85,14 +103,11 @@ static ssize_t spi_nor_read_data(struct spi_nor *nor, loff_t from, size_t len,
 	size_t remaining = len;
 	int ret;
 
-	/* get transfer protocols. */
-	op.cmd.buswidth = spi_nor_get_protocol_inst_nbits(nor->read_proto);
-	op.addr.buswidth = spi_nor_get_protocol_addr_nbits(nor->read_proto);
-	op.dummy.buswidth = op.addr.buswidth;
-	op.data.buswidth = spi_nor_get_protocol_data_nbits(nor->read_proto);
+	/* Set up at the end of spi_nor_scan(), for the final read settings */
+	if (nor->dirmap.rdesc)
+		return spi_mem_dirmap_read(nor->dirmap.rdesc, from, len, buf);
 
-	/* convert the dummy cycles to the number of bytes */
-	op.dummy.nbytes = (nor->read_dummy * op.dummy.buswidth) / 8;
+	spi_nor_setup_read_op(nor, &op);
 
 	while (remaining) {
 		op.data.nbytes = remaining < UINT_MAX ? remaining : UINT_MAX;
@@ -296,12 +311,18 @@ static u8 spi_nor_convert_3to4_erase(u8 opcode)
 static void spi_nor_set_4byte_opcodes(struct spi_nor *nor,
 				      const struct flash_info *info)
 {
+	struct spi_nor_erase_type *types = nor->erase_map.types;
+	int i;
+
 	/* Do some manufacturer fixups first */
 	switch (JEDEC_MFR(info)) {
 	case SNOR_MFR_SPANSION:
 		/* No small sector erase for 4-byte command set */
 		nor->erase_opcode = SPINOR_OP_SE;
 		nor->mtd.erasesize = info->sector_size;
+		for (i = 0; i < SNOR_ERASE_TYPE_MAX; i++)
+			if (types[i].size < info->sector_size)
+				types[i].size = 0;
 		break;
 
 	default:
@@ -311,6 +332,8 @@ static void spi_nor_set_4byte_opcodes(struct spi_nor *nor,
 	nor->read_opcode = spi_nor_convert_3to4_read(nor->read_opcode);
 	nor->program_opcode = spi_nor_convert_3to4_program(nor->program_opcode);
 	nor->erase_opcode = spi_nor_convert_3to4_erase(nor->erase_opcode);
+	for (i = 0; i < SNOR_ERASE_TYPE_MAX; i++)
+		types[i].opcode = spi_nor_convert_3to4_erase(types[i].opcode);
 }
 #endif /* !CONFIG_SPI_FLASH_BAR */
 
@@ -542,13 +565,95 @@ static int spi_nor_erase_sector(struct spi_nor *nor, u32 addr)
 	return spi_mem_exec_op(nor->spi, &op);
 }
 
+/*
+ * Erase the whole flash memory
+ *
+ * Returns 0 if successful, non-zero otherwise.
+ */
+static int spi_nor_erase_chip(struct spi_nor *nor)
+{
+	unsigned long timeout;
+	int ret;
+
+	dev_dbg(nor->dev, " %lldKiB\n", (long long)(nor->mtd.size >> 10));
+
+	write_enable(nor);
+
+	ret = nor->write_reg(nor, SPINOR_OP_CHIP_ERASE, NULL, 0);
+	if (ret)
+		return ret;
+
+	/*
+	 * Scale the timeout linearly with the size of the flash, with
+	 * a minimum calibrated to an old 2MB flash. We could try to
+	 * pull these from CFI/SFDP, but these values should be good
+	 * enough for now.
+	 */
+	timeout = max(CHIP_ERASE_2MB_READY_WAIT_JIFFIES,
+		      CHIP_ERASE_2MB_READY_WAIT_JIFFIES *
+		      (unsigned long)(nor->mtd.size / SZ_2M));
+
+	return spi_nor_wait_till_ready_with_timeout(nor, timeout);
+}
+
+/*
+ * Pick the largest erase type that starts at @addr and fits in the @len bytes
+ * left to erase. On non-uniform flashes, only the erase types of the region
+ * containing @addr are considered, and the erase must not cross its end.
+ */
+static const struct spi_nor_erase_type *
+spi_nor_find_erase_type(struct spi_nor *nor, u32 addr, u32 len)
+{
+	const struct spi_nor_erase_map *map = &nor->erase_map;
+	const struct spi_nor_erase_type *type, *best = NULL;
+	u8 erase_mask = SNOR_ERASE_TYPE_MASK;
+	unsigned int i;
+
+	if (map->n_regions) {
+		const struct spi_nor_erase_region *region = NULL;
+
+		for (i = 0; i < map->n_regions; i++) {
+			if (addr >= map->regions[i].offset &&
+			    addr < map->regions[i].offset + map->regions[i].size) {
+				region = &map->regions[i];
+				break;
+			}
+		}
+		if (!region)
+			return NULL;
+
+		erase_mask = region->erase_mask;
+		len = min_t(u64, len, region->offset + region->size - addr);
+	}
+
+	for (i = 0; i < SNOR_ERASE_TYPE_MAX; i++) {
+		type = &map->types[i];
+		if (!type->size || !(erase_mask & BIT(i)))
+			continue;
+		if (addr % type->size || len < type->size)
+			continue;
+		if (!best || type->size > best->size)
+			best = type;
+	}
+
+	return best;
+}
+
 /*
  * Erase an address range on the nor chip.  The address range may extend
  * one or more erase sectors.  Return an error is there is a problem erasing.
+ *
+ * Each step uses the largest erase type which is aligned on the current
+ * address and fits in the remaining length, so that only the unaligned edges
+ * of the range are erased with small sectors. A request covering the whole
+ * flash is done with a single chip erase command.
  */
 static int spi_nor_erase(struct mtd_info *mtd, struct erase_info *instr)
 {
 	struct spi_nor *nor = mtd_to_spi_nor(mtd);
+	const struct spi_nor_erase_type *type;
+	struct spi_nor_erase_type def;
+	u8 erase_opcode = nor->erase_opcode;
 	u32 addr, len, rem;
 	int ret;
 
@@ -558,27 +663,48 @@ static int spi_nor_erase(struct mtd_info *mtd, struct erase_info *instr)
 	if (!instr->len)
 		return 0;
 
-	div_u64_rem(instr->len, mtd->erasesize, &rem);
-	if (rem)
-		return -EINVAL;
+	if (!nor->erase_map.n_regions) {
+		div_u64_rem(instr->len, mtd->erasesize, &rem);
+		if (rem)
+			return -EINVAL;
+	}
 
 	addr = instr->addr;
 	len = instr->len;
 
+	if (!addr && instr->len == mtd->size &&
+	    !(nor->flags & SNOR_F_NO_OP_CHIP_ERASE)) {
+		ret = spi_nor_erase_chip(nor);
+		goto erase_err;
+	}
+
+	def.size = mtd->erasesize;
+	def.opcode = nor->erase_opcode;
+
 	while (len) {
 #ifdef CONFIG_SPI_FLASH_BAR
 		ret = write_bar(nor, addr);
 		if (ret < 0)
 			return ret;
 #endif
+		type = spi_nor_find_erase_type(nor, addr, len);
+		if (!type) {
+			if (nor->erase_map.n_regions) {
+				ret = -EINVAL;
+				goto erase_err;
+			}
+			type = &def;
+		}
+
 		write_enable(nor);
 
+		nor->erase_opcode = type->opcode;
 		ret = spi_nor_erase_sector(nor, addr);
 		if (ret)
 			goto erase_err;
 
-		addr += mtd->erasesize;
-		len -= mtd->erasesize;
+		addr += type->size;
+		len -= type->size;
 
 		ret = spi_nor_wait_till_ready(nor);
 		if (ret)
@@ -586,6 +712,7 @@ static int spi_nor_erase(struct mtd_info *mtd, struct erase_info *instr)
 	}
 
 erase_err:
+	nor->erase_opcode = erase_opcode;
 #ifdef CONFIG_SPI_FLASH_BAR
 	ret = clean_bar(nor);
 #endif
@@ -1540,6 +1667,35 @@ spi_nor_set_pp_settings(struct spi_nor_pp_command *pp,
  * Serial Flash Discoverable Parameters (SFDP) parsing.
  */
 
+/**
+ * spi_nor_read_raw() - raw read of serial flash memory. read_opcode,
+ *			addr_width and read_dummy members of the struct spi_nor
+ *			should be previously set.
+ * @nor:	pointer to a 'struct spi_nor'
+ * @addr:	offset in the serial flash memory
+ * @len:	number of bytes to read
+ * @buf:	buffer where the data is copied into (dma-safe memory)
+ *
+ * Return: 0 on success, -errno otherwise.
+ */
+static int spi_nor_read_raw(struct spi_nor *nor, u32 addr, size_t len, u8 *buf)
+{
+	int ret;
+
+	while (len) {
+		ret = nor->read(nor, addr, len, buf);
+		if (!ret || ret > len)
+			return -EIO;
+		if (ret < 0)
+			return ret;
+
+		buf += ret;
+		addr += ret;
+		len -= ret;
+	}
+	return 0;
+}
+
 /**
  * spi_nor_read_sfdp() - read Serial Flash Discoverable Parameters.
  * @nor:	pointer to a 'struct spi_nor'
@@ -1567,22 +1723,8 @@ static int spi_nor_read_sfdp(struct spi_nor *nor, u32 addr,
 	nor->addr_width = 3;
 	nor->read_dummy = 8;
 
-	while (len) {
-		ret = nor->read(nor, addr, len, (u8 *)buf);
-		if (!ret || ret > len) {
-			ret = -EIO;
-			goto read_err;
-		}
-		if (ret < 0)
-			goto read_err;
-
-		buf += ret;
-		addr += ret;
-		len -= ret;
-	}
-	ret = 0;
+	ret = spi_nor_read_raw(nor, addr, len, buf);
 
-read_err:
 	nor->read_opcode = read_opcode;
 	nor->addr_width = addr_width;
 	nor->read_dummy = read_dummy;
@@ -1936,11 +2078,18 @@ static int spi_nor_parse_bfpt(struct spi_nor *nor,
 
 		erasesize = 1U << erasesize;
 		opcode = (half >> 8) & 0xff;
+
+		/* Keep all erase types, spi_nor_erase() picks among them. */
+		nor->erase_map.types[i].size = erasesize;
+		nor->erase_map.types[i].opcode = opcode;
+
 #ifdef CONFIG_SPI_FLASH_USE_4K_SECTORS
+		if (mtd->erasesize == SZ_4K)
+			continue;
 		if (erasesize == SZ_4K) {
 			nor->erase_opcode = opcode;
 			mtd->erasesize = erasesize;
-			break;
+			continue;
 		}
 #endif
 		if (!mtd->erasesize || mtd->erasesize < erasesize) {
@@ -2015,6 +2164,309 @@ spi_nor_parse_microchip_sfdp(struct spi_nor *nor,
 	return ret;
 }
 
+#define SMPT_CMD_ADDRESS_LEN_MASK		GENMASK(23, 22)
+#define SMPT_CMD_ADDRESS_LEN_0			(0x0UL << 22)
+#define SMPT_CMD_ADDRESS_LEN_3			(0x1UL << 22)
+#define SMPT_CMD_ADDRESS_LEN_4			(0x2UL << 22)
+#define SMPT_CMD_ADDRESS_LEN_USE_CURRENT	(0x3UL << 22)
+
+#define SMPT_CMD_READ_DUMMY_MASK		GENMASK(19, 16)
+#define SMPT_CMD_READ_DUMMY_SHIFT		16
+#define SMPT_CMD_READ_DUMMY(_cmd) \
+	(((_cmd) & SMPT_CMD_READ_DUMMY_MASK) >> SMPT_CMD_READ_DUMMY_SHIFT)
+#define SMPT_CMD_READ_DUMMY_IS_VARIABLE		0xfUL
+
+#define SMPT_CMD_READ_DATA_MASK			GENMASK(31, 24)
+#define SMPT_CMD_READ_DATA_SHIFT		24
+#define SMPT_CMD_READ_DATA(_cmd) \
+	(((_cmd) & SMPT_CMD_READ_DATA_MASK) >> SMPT_CMD_READ_DATA_SHIFT)
+
+#define SMPT_CMD_OPCODE_MASK			GENMASK(15, 8)
+#define SMPT_CMD_OPCODE_SHIFT			8
+#define SMPT_CMD_OPCODE(_cmd) \
+	(((_cmd) & SMPT_CMD_OPCODE_MASK) >> SMPT_CMD_OPCODE_SHIFT)
+
+#define SMPT_MAP_REGION_COUNT_MASK		GENMASK(23, 16)
+#define SMPT_MAP_REGION_COUNT_SHIFT		16
+#define SMPT_MAP_REGION_COUNT(_header) \
+	((((_header) & SMPT_MAP_REGION_COUNT_MASK) >> \
+	  SMPT_MAP_REGION_COUNT_SHIFT) + 1)
+
+#define SMPT_MAP_ID_MASK			GENMASK(15, 8)
+#define SMPT_MAP_ID_SHIFT			8
+#define SMPT_MAP_ID(_header) \
+	(((_header) & SMPT_MAP_ID_MASK) >> SMPT_MAP_ID_SHIFT)
+
+#define SMPT_MAP_REGION_SIZE_MASK		GENMASK(31, 8)
+#define SMPT_MAP_REGION_SIZE_SHIFT		8
+#define SMPT_MAP_REGION_SIZE(_region) \
+	(((((_region) & SMPT_MAP_REGION_SIZE_MASK) >> \
+	   SMPT_MAP_REGION_SIZE_SHIFT) + 1) * 256)
+
+#define SMPT_MAP_REGION_ERASE_TYPE(_region) \
+	((_region) & SNOR_ERASE_TYPE_MASK)
+
+#define SMPT_DESC_TYPE_MAP			BIT(1)
+#define SMPT_DESC_END				BIT(0)
+
+/**
+ * spi_nor_smpt_addr_width() - return the address width used in the
+ *			       configuration detection command.
+ * @nor:	pointer to a 'struct spi_nor'
+ * @settings:	configuration detection command descriptor, dword1
+ */
+static u8 spi_nor_smpt_addr_width(const struct spi_nor *nor, const u32 settings)
+{
+	switch (settings & SMPT_CMD_ADDRESS_LEN_MASK) {
+	case SMPT_CMD_ADDRESS_LEN_0:
+		return 0;
+	case SMPT_CMD_ADDRESS_LEN_3:
+		return 3;
+	case SMPT_CMD_ADDRESS_LEN_4:
+		return 4;
+	case SMPT_CMD_ADDRESS_LEN_USE_CURRENT:
+	default:
+		return nor->addr_width;
+	}
+}
+
+/**
+ * spi_nor_smpt_read_dummy() - return the configuration detection command read
+ *			       latency, in clock cycles.
+ * @nor:	pointer to a 'struct spi_nor'
+ * @settings:	configuration detection command descriptor, dword1
+ *
+ * Return: the number of dummy cycles for an SMPT read
+ */
+static u8 spi_nor_smpt_read_dummy(const struct spi_nor *nor, const u32 settings)
+{
+	u8 read_dummy = SMPT_CMD_READ_DUMMY(settings);
+
+	if (read_dummy == SMPT_CMD_READ_DUMMY_IS_VARIABLE)
+		return nor->read_dummy;
+	return read_dummy;
+}
+
+/**
+ * spi_nor_get_map_in_use() - get the configuration map in use
+ * @nor:	pointer to a 'struct spi_nor'
+ * @smpt:	pointer to the sector map parameter table
+ * @smpt_len:	sector map parameter table length, in dwords
+ *
+ * Return: pointer to the map in use, ERR_PTR(-errno) otherwise.
+ */
+static const u32 *spi_nor_get_map_in_use(struct spi_nor *nor, const u32 *smpt,
+					 u8 smpt_len)
+{
+	const u32 *ret;
+	u8 addr_width, read_opcode, read_dummy;
+	u8 read_data_mask, map_id;
+	u32 addr;
+	u8 *buf;
+	int err;
+	u8 i;
+
+	buf = kmalloc(sizeof(*buf), GFP_KERNEL);
+	if (!buf)
+		return ERR_PTR(-ENOMEM);
+
+	addr_width = nor->addr_width;
+	read_dummy = nor->read_dummy;
+	read_opcode = nor->read_opcode;
+
+	map_id = 0;
+	/* Determine if there are any optional Detection Command Descriptors */
+	for (i = 0; i + 1 < smpt_len; i += 2) {
+		if (smpt[i] & SMPT_DESC_TYPE_MAP)
+			break;
+
+		read_data_mask = SMPT_CMD_READ_DATA(smpt[i]);
+		nor->addr_width = spi_nor_smpt_addr_width(nor, smpt[i]);
+		nor->read_dummy = spi_nor_smpt_read_dummy(nor, smpt[i]);
+		nor->read_opcode = SMPT_CMD_OPCODE(smpt[i]);
+		addr = smpt[i + 1];
+
+		err = spi_nor_read_raw(nor, addr, 1, buf);
+		if (err) {
+			ret = ERR_PTR(err);
+			goto out;
+		}
+
+		/*
+		 * Build an index value that is used to select the Sector Map
+		 * Configuration that is currently in use.
+		 */
+		map_id = map_id << 1 | !!(*buf & read_data_mask);
+	}
+
+	/*
+	 * If command descriptors are provided, they always precede map
+	 * descriptors in the table. There is no need to start the iteration
+	 * over smpt array all over again.
+	 *
+	 * Find the matching configuration map.
+	 */
+	ret = ERR_PTR(-EINVAL);
+	while (i < smpt_len) {
+		if (i + SMPT_MAP_REGION_COUNT(smpt[i]) >= smpt_len)
+			break;
+
+		if (SMPT_MAP_ID(smpt[i]) == map_id) {
+			ret = smpt + i;
+			break;
+		}
+
+		/*
+		 * If there are no more configuration map descriptors and no
+		 * configuration ID matched the configuration identifier, the
+		 * sector address map is unknown.
+		 */
+		if (smpt[i] & SMPT_DESC_END)
+			break;
+
+		/* increment the table index to the next map */
+		i += SMPT_MAP_REGION_COUNT(smpt[i]) + 1;
+	}
+
+out:
+	kfree(buf);
+	nor->addr_width = addr_width;
+	nor->read_dummy = read_dummy;
+	nor->read_opcode = read_opcode;
+	return ret;
+}
+
+/**
+ * spi_nor_init_non_uniform_erase_map() - initialize the non-uniform erase map
+ * @nor:	pointer to a 'struct spi_nor'
+ * @smpt:	pointer to the sector map in use
+ * @params:	pointer to a duplicate 'struct spi_nor_flash_parameter' that is
+ *		filled
+ *
+ * Return: 0 on success, -errno otherwise.
+ */
+static int spi_nor_init_non_uniform_erase_map(struct spi_nor *nor,
+					      const u32 *smpt,
+					      struct spi_nor_flash_parameter *params)
+{
+	struct spi_nor_erase_map *map = &nor->erase_map;
+	struct spi_nor_erase_region *regions;
+	unsigned int region_count, i;
+	u32 erasesize = 0;
+	u8 erase_mask = 0;
+	u8 opcode = 0;
+	u64 offset;
+
+	region_count = SMPT_MAP_REGION_COUNT(*smpt);
+	regions = devm_kcalloc(nor->dev, region_count, sizeof(*regions),
+			       GFP_KERNEL);
+	if (!regions)
+		return -ENOMEM;
+
+	offset = 0;
+	for (i = 0; i < region_count; i++) {
+		regions[i].offset = offset;
+		regions[i].size = SMPT_MAP_REGION_SIZE(smpt[i + 1]);
+		regions[i].erase_mask = SMPT_MAP_REGION_ERASE_TYPE(smpt[i + 1]);
+		erase_mask |= regions[i].erase_mask;
+		offset += regions[i].size;
+	}
+
+	/* The regions must cover the whole flash with known erase types. */
+	if (offset != params->size)
+		goto err;
+
+	for (i = 0; i < SNOR_ERASE_TYPE_MAX; i++) {
+		if ((erase_mask & BIT(i)) && !map->types[i].size)
+			goto err;
+	}
+
+	/*
+	 * Advertise the smallest erase size which can be served in every
+	 * region: the largest of the smallest erase types of each region.
+	 */
+	for (i = 0; i < region_count; i++) {
+		const struct spi_nor_erase_type *type, *min = NULL;
+		unsigned int j;
+
+		for (j = 0; j < SNOR_ERASE_TYPE_MAX; j++) {
+			type = &map->types[j];
+			if (!(regions[i].erase_mask & BIT(j)))
+				continue;
+			if (!min || type->size < min->size)
+				min = type;
+		}
+		if (!min)
+			goto err;
+		if (min->size > erasesize) {
+			erasesize = min->size;
+			opcode = min->opcode;
+		}
+	}
+
+	nor->mtd.erasesize = erasesize;
+	nor->erase_opcode = opcode;
+	map->regions = regions;
+	map->n_regions = region_count;
+
+	return 0;
+
+err:
+	devm_kfree(nor->dev, regions);
+	return -EINVAL;
+}
+
+/**
+ * spi_nor_parse_smpt() - parse Sector Map Parameter Table
+ * @nor:		pointer to a 'struct spi_nor'
+ * @smpt_header:	sector map parameter table header
+ * @params:		pointer to a duplicate 'struct spi_nor_flash_parameter'
+ *			that is filled
+ *
+ * This table is optional, but when available, we parse it to identify the
+ * location and size of sectors within the main data array of the flash memory
+ * device and to identify which Erase Types are supported by each sector.
+ *
+ * Return: 0 on success, -errno otherwise.
+ */
+static int spi_nor_parse_smpt(struct spi_nor *nor,
+			      const struct sfdp_parameter_header *smpt_header,
+			      struct spi_nor_flash_parameter *params)
+{
+	const u32 *sector_map;
+	u32 *smpt;
+	size_t len;
+	u32 addr;
+	int i, ret;
+
+	/* Read the Sector Map Parameter Table. */
+	len = smpt_header->length * sizeof(*smpt);
+	smpt = kmalloc(len, GFP_KERNEL);
+	if (!smpt)
+		return -ENOMEM;
+
+	addr = SFDP_PARAM_HEADER_PTP(smpt_header);
+	ret = spi_nor_read_sfdp(nor, addr, len, smpt);
+	if (ret)
+		goto out;
+
+	/* Fix endianness of the SMPT DWORDs. */
+	for (i = 0; i < smpt_header->length; i++)
+		smpt[i] = le32_to_cpu(smpt[i]);
+
+	sector_map = spi_nor_get_map_in_use(nor, smpt, smpt_header->length);
+	if (IS_ERR(sector_map)) {
+		ret = PTR_ERR(sector_map);
+		goto out;
+	}
+
+	ret = spi_nor_init_non_uniform_erase_map(nor, sector_map, params);
+
+out:
+	kfree(smpt);
+	return ret;
+}
+
 /**
  * spi_nor_parse_sfdp() - parse the Serial Flash Discoverable Parameters.
  * @nor:		pointer to a 'struct spi_nor'
@@ -2109,8 +2561,7 @@ static int spi_nor_parse_sfdp(struct spi_nor *nor,
 
 		switch (SFDP_PARAM_HEADER_ID(param_header)) {
 		case SFDP_SECTOR_MAP_ID:
-			dev_info(nor->dev,
-				 "non-uniform erase sector maps are not supported yet.\n");
+			err = spi_nor_parse_smpt(nor, param_header, params);
 			break;
 
 		case SFDP_SST_ID:
@@ -2229,6 +2680,7 @@ static int spi_nor_init_params(struct spi_nor *nor,
 	/* Override the parameters with data read from SFDP tables. */
 	nor->addr_width = 0;
 	nor->mtd.erasesize = 0;
+	memset(&nor->erase_map, 0, sizeof(nor->erase_map));
 	if ((info->flags & (SPI_NOR_DUAL_READ | SPI_NOR_QUAD_READ)) &&
 	    !(info->flags & SPI_NOR_SKIP_SFDP)) {
 		struct spi_nor_flash_parameter sfdp_params;
@@ -2237,6 +2689,7 @@ static int spi_nor_init_params(struct spi_nor *nor,
 		if (spi_nor_parse_sfdp(nor, &sfdp_params)) {
 			nor->addr_width = 0;
 			nor->mtd.erasesize = 0;
+			memset(&nor->erase_map, 0, sizeof(nor->erase_map));
 		} else {
 			memcpy(params, &sfdp_params, sizeof(*params));
 		}
@@ -2371,6 +2824,18 @@ static int spi_nor_select_erase(struct spi_nor *nor,
 		nor->erase_opcode = SPINOR_OP_SE;
 		mtd->erasesize = info->sector_size;
 	}
+
+	/*
+	 * Without SFDP we only know about the small sector and the sector
+	 * erase commands, let spi_nor_erase() use the latter on aligned spans.
+	 */
+	if (mtd->erasesize != info->sector_size) {
+		nor->erase_map.types[0].size = mtd->erasesize;
+		nor->erase_map.types[0].opcode = nor->erase_opcode;
+	}
+	nor->erase_map.types[1].size = info->sector_size;
+	nor->erase_map.types[1].opcode = SPINOR_OP_SE;
+
 	return 0;
 }
 
@@ -2479,6 +2944,46 @@ static int spi_nor_init(struct spi_nor *nor)
 	return 0;
 }
 
+/*
+ * Set up a direct mapping of the whole flash for the read path, so that
+ * controllers exposing a memory-mapped window can serve reads with a copy
+ * instead of a sequence of size-limited operations. This is best effort:
+ * reads keep using spi_mem_exec_op() when no mapping can be created.
+ */
+static void spi_nor_create_read_dirmap(struct spi_nor *nor)
+{
+	struct spi_mem_dirmap_info info = {
+		.op_tmpl = SPI_MEM_OP(SPI_MEM_OP_CMD(nor->read_opcode, 1),
+				      SPI_MEM_OP_ADDR(nor->addr_width, 0, 1),
+				      SPI_MEM_OP_DUMMY(nor->read_dummy, 1),
+				      SPI_MEM_OP_DATA_IN(0, NULL, 1)),
+		.offset = 0,
+		.length = nor->mtd.size,
+	};
+	struct spi_mem_dirmap_desc *desc;
+
+	spi_nor_setup_read_op(nor, &info.op_tmpl);
+
+	desc = spi_mem_dirmap_create(nor->spi, &info);
+	if (IS_ERR(desc)) {
+		dev_dbg(nor->dev, "no read direct mapping: %ld\n",
+			PTR_ERR(desc));
+		return;
+	}
+
+	nor->dirmap.rdesc = desc;
+}
+
+int spi_nor_remove(struct spi_nor *nor)
+{
+	if (nor->dirmap.rdesc) {
+		spi_mem_dirmap_destroy(nor->dirmap.rdesc);
+		nor->dirmap.rdesc = NULL;
+	}
+
+	return 0;
+}
+
 int spi_nor_scan(struct spi_nor *nor)
 {
 	struct spi_nor_flash_parameter params;
@@ -2492,6 +2997,8 @@ int spi_nor_scan(struct spi_nor *nor)
 	struct spi_slave *spi = nor->spi;
 	int ret;
 
+	spi_nor_remove(nor);
+
 	/* Reset SPI protocol for all commands. */
 	nor->reg_proto = SNOR_PROTO_1_1_1;
 	nor->read_proto = SNOR_PROTO_1_1_1;
@@ -2634,6 +3141,8 @@ int spi_nor_scan(struct spi_nor *nor)
 	nor->erase_size = mtd->erasesize;
 	nor->sector_size = mtd->erasesize;
 
+	spi_nor_create_read_dirmap(nor);
+
 #ifndef CONFIG_SPL_BUILD
 	printf("SF: Detected %s with page size ", nor->name);
 	print_size(nor->page_size, ", erase size ");
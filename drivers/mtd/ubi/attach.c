@@ -86,6 +86,7 @@
 #include <linux/math64.h>
 
 #include <ubi_uboot.h>
+#include <bloblist.h>
 #include "ubi.h"
 
 static int self_check_ai(struct ubi_device *ubi, struct ubi_attach_info *ai);
@@ -802,6 +803,367 @@ out_unlock:
 	return err;
 }
 
+#ifdef CONFIG_MTD_UBI_ATTACH_CACHE
+
+/**
+ * struct ubi_snap_cache - attach snapshot kept for a detached MTD device.
+ * @list: link in the list of kept snapshots
+ * @snap: the snapshot
+ * @mtd_name: name of the MTD device the snapshot describes
+ */
+struct ubi_snap_cache {
+	struct list_head list;
+	struct ubi_snap *snap;
+	char mtd_name[0];
+};
+
+static LIST_HEAD(snap_cache);
+static bool snap_handoff_taken;
+
+static size_t snap_size(int peb_count)
+{
+	return sizeof(struct ubi_snap) +
+	       peb_count * sizeof(struct ubi_snap_peb);
+}
+
+static bool snap_fits(const struct ubi_device *ubi,
+		      const struct ubi_snap *snap)
+{
+	return snap->magic == UBI_SNAP_MAGIC &&
+	       snap->peb_count == ubi->peb_count &&
+	       snap->peb_size == ubi->peb_size &&
+	       snap->vid_hdr_offset == ubi->vid_hdr_offset;
+}
+
+static void snap_reset(struct ubi_snap *snap)
+{
+	memset(snap->peb, 0, snap->peb_count * sizeof(struct ubi_snap_peb));
+	snap->max_sqnum = 0;
+	snap->image_seq = 0;
+	snap->newest = -1;
+}
+
+/**
+ * snap_start - set up the attach snapshot of an UBI device.
+ * @ubi: UBI device description object
+ *
+ * The snapshot kept when the same MTD device was last detached is used first,
+ * then one handed over by SPL. Otherwise the scan starts from an empty one and
+ * fills it in. Running out of memory just means attaching without snapshot.
+ */
+static void snap_start(struct ubi_device *ubi)
+{
+	struct ubi_snap_cache *sc;
+	const struct ubi_snap *spl;
+	struct ubi_snap *snap;
+	size_t size = snap_size(ubi->peb_count);
+
+	list_for_each_entry(sc, &snap_cache, list) {
+		if (strcmp(sc->mtd_name, ubi->mtd->name))
+			continue;
+
+		list_del(&sc->list);
+		snap = sc->snap;
+		kfree(sc);
+		if (snap_fits(ubi, snap)) {
+			ubi->snap = snap;
+			return;
+		}
+		vfree(snap);
+		break;
+	}
+
+	snap = vmalloc(size);
+	if (!snap)
+		return;
+	ubi->snap = snap;
+
+	if (IS_ENABLED(CONFIG_SPL_UBI_ATTACH_HANDOFF) && !snap_handoff_taken) {
+		spl = bloblist_find(BLOBLISTT_UBI_ATTACH, size);
+		if (spl && snap_fits(ubi, spl)) {
+			memcpy(snap, spl, size);
+			snap_handoff_taken = true;
+			return;
+		}
+	}
+
+	snap->magic = UBI_SNAP_MAGIC;
+	snap->peb_count = ubi->peb_count;
+	snap->peb_size = ubi->peb_size;
+	snap->vid_hdr_offset = ubi->vid_hdr_offset;
+	snap_reset(snap);
+}
+
+/**
+ * snap_check_peb - check a used PEB of the attach snapshot against the flash.
+ * @ubi: UBI device description object
+ * @pnum: the physical eraseblock number
+ *
+ * The EC and VID headers of @pnum are read back, which also checks their CRC,
+ * and compared to the snapshot record. Returns zero if they match.
+ */
+static int snap_check_peb(struct ubi_device *ubi, int pnum)
+{
+	struct ubi_snap_peb *sp = &ubi->snap->peb[pnum];
+
+	if (ubi_io_read_ec_hdr(ubi, pnum, ech, 0) ||
+	    be64_to_cpu(ech->ec) != sp->ec ||
+	    be32_to_cpu(ech->image_seq) != ubi->snap->image_seq)
+		return -EINVAL;
+
+	if (ubi_io_read_vid_hdr(ubi, pnum, vidh, 0) ||
+	    be64_to_cpu(vidh->sqnum) != sp->sqnum ||
+	    be32_to_cpu(vidh->vol_id) != sp->vol_id ||
+	    be32_to_cpu(vidh->lnum) != sp->lnum ||
+	    be32_to_cpu(vidh->data_size) != sp->data_size ||
+	    be32_to_cpu(vidh->used_ebs) != sp->used_ebs ||
+	    be32_to_cpu(vidh->data_pad) != sp->data_pad ||
+	    vidh->vol_type != sp->vol_type)
+		return -EINVAL;
+
+	return 0;
+}
+
+/**
+ * snap_check - check the attach snapshot of an UBI device against the flash.
+ * @ubi: UBI device description object
+ *
+ * Every VID header written gets a higher sequence number than all before it.
+ * The snapshot is taken to be current if, for every volume it describes, the
+ * PEB which held the newest VID header of that volume still holds it, with
+ * the same erase counter and image sequence number. Writes through UBI drop
+ * the snapshot anyway, so this has to catch the UBI image, or some of its
+ * volumes, being flashed or formatted again behind U-Boot's back, for
+ * instance between SPL and U-Boot proper. Returns zero if the snapshot can be
+ * used.
+ */
+static int snap_check(struct ubi_device *ubi)
+{
+	struct ubi_snap *snap = ubi->snap;
+	struct ubi_snap_peb *sp;
+	int *newest, idx, pnum, err = 0;
+
+	pnum = snap->newest;
+	if (pnum < 0 || pnum >= ubi->peb_count)
+		return -EINVAL;
+
+	sp = &snap->peb[pnum];
+	if (sp->state != UBI_SNAP_USED || sp->sqnum != snap->max_sqnum)
+		return -EINVAL;
+
+	/* The newest PEB of each volume, the layout volume comes last */
+	newest = kmalloc_array(UBI_MAX_VOLUMES + 1, sizeof(*newest),
+			       GFP_KERNEL);
+	if (!newest)
+		return -ENOMEM;
+	for (idx = 0; idx <= UBI_MAX_VOLUMES; idx++)
+		newest[idx] = -1;
+
+	for (pnum = 0; pnum < ubi->peb_count; pnum++) {
+		sp = &snap->peb[pnum];
+		if (sp->state != UBI_SNAP_USED)
+			continue;
+
+		if (sp->vol_id == UBI_LAYOUT_VOLUME_ID) {
+			idx = UBI_MAX_VOLUMES;
+		} else if (sp->vol_id < UBI_MAX_VOLUMES) {
+			idx = sp->vol_id;
+		} else {
+			err = -EINVAL;
+			goto out;
+		}
+
+		if (newest[idx] < 0 ||
+		    sp->sqnum > snap->peb[newest[idx]].sqnum)
+			newest[idx] = pnum;
+	}
+
+	for (idx = 0; idx <= UBI_MAX_VOLUMES; idx++) {
+		if (newest[idx] < 0)
+			continue;
+		err = snap_check_peb(ubi, newest[idx]);
+		if (err)
+			break;
+	}
+
+out:
+	kfree(newest);
+	return err;
+}
+
+static void snap_validate(struct ubi_device *ubi)
+{
+	if (!ubi->snap)
+		return;
+
+	if (snap_check(ubi)) {
+		if (ubi->snap->newest >= 0)
+			ubi_msg(ubi, "attach snapshot is out of date");
+		snap_reset(ubi->snap);
+		return;
+	}
+
+	ubi_msg(ubi, "attaching from snapshot");
+	if (!ubi->image_seq)
+		ubi->image_seq = ubi->snap->image_seq;
+}
+
+/**
+ * snap_record - record the scan result of a PEB in the attach snapshot.
+ * @ubi: UBI device description object
+ * @pnum: the physical eraseblock number
+ * @state: %UBI_SNAP_BAD, %UBI_SNAP_FREE or %UBI_SNAP_USED for a PEB the scan
+ *         found nothing unusual about, %UBI_SNAP_UNKNOWN otherwise
+ * @ec: erase counter of the PEB
+ * @vid_hdr: VID header of a used PEB
+ */
+static void snap_record(struct ubi_device *ubi, int pnum, int state, int ec,
+			const struct ubi_vid_hdr *vid_hdr)
+{
+	struct ubi_snap_peb *sp;
+
+	if (!ubi->snap)
+		return;
+
+	sp = &ubi->snap->peb[pnum];
+	memset(sp, 0, sizeof(*sp));
+
+	if (state == UBI_SNAP_USED) {
+		/* Copies of a LEB have to be told apart by their data */
+		if (vid_hdr->copy_flag ||
+		    be32_to_cpu(vid_hdr->data_pad) > U16_MAX)
+			return;
+
+		sp->sqnum = be64_to_cpu(vid_hdr->sqnum);
+		sp->vol_id = be32_to_cpu(vid_hdr->vol_id);
+		sp->lnum = be32_to_cpu(vid_hdr->lnum);
+		sp->data_size = be32_to_cpu(vid_hdr->data_size);
+		sp->used_ebs = be32_to_cpu(vid_hdr->used_ebs);
+		sp->data_pad = be32_to_cpu(vid_hdr->data_pad);
+		sp->vol_type = vid_hdr->vol_type;
+	}
+	sp->ec = ec;
+	sp->state = state;
+}
+
+/**
+ * snap_replay - add a PEB to the attaching information from the snapshot.
+ * @ubi: UBI device description object
+ * @ai: attaching information
+ * @pnum: the physical eraseblock number
+ *
+ * Returns zero if the PEB was added, %1 if it has to be scanned and a negative
+ * error code in case of failure.
+ */
+static int snap_replay(struct ubi_device *ubi, struct ubi_attach_info *ai,
+		       int pnum)
+{
+	struct ubi_snap_peb *sp;
+	int err;
+
+	if (!ubi->snap)
+		return 1;
+
+	sp = &ubi->snap->peb[pnum];
+	switch (sp->state) {
+	case UBI_SNAP_BAD:
+		ai->bad_peb_count += 1;
+		return 0;
+	case UBI_SNAP_FREE:
+		err = add_to_list(ai, pnum, UBI_UNKNOWN, UBI_UNKNOWN, sp->ec,
+				  0, &ai->free);
+		break;
+	case UBI_SNAP_USED:
+		memset(vidh, 0, sizeof(*vidh));
+		vidh->vol_type = sp->vol_type;
+		if (sp->vol_id == UBI_LAYOUT_VOLUME_ID)
+			vidh->compat = UBI_LAYOUT_VOLUME_COMPAT;
+		vidh->vol_id = cpu_to_be32(sp->vol_id);
+		vidh->lnum = cpu_to_be32(sp->lnum);
+		vidh->data_size = cpu_to_be32(sp->data_size);
+		vidh->used_ebs = cpu_to_be32(sp->used_ebs);
+		vidh->data_pad = cpu_to_be32(sp->data_pad);
+		vidh->sqnum = cpu_to_be64(sp->sqnum);
+		err = ubi_add_to_av(ubi, ai, pnum, sp->ec, vidh, 0);
+		break;
+	default:
+		return 1;
+	}
+	if (err)
+		return err;
+
+	ai->ec_sum += sp->ec;
+	ai->ec_count += 1;
+	if (sp->ec > ai->max_ec)
+		ai->max_ec = sp->ec;
+	if (sp->ec < ai->min_ec)
+		ai->min_ec = sp->ec;
+
+	return 0;
+}
+
+static void snap_finish(struct ubi_device *ubi)
+{
+	struct ubi_snap *snap = ubi->snap;
+	int pnum;
+
+	if (!snap)
+		return;
+
+	snap->image_seq = ubi->image_seq;
+	snap->max_sqnum = 0;
+	snap->newest = -1;
+	for (pnum = 0; pnum < ubi->peb_count; pnum++) {
+		struct ubi_snap_peb *sp = &snap->peb[pnum];
+
+		if (sp->state == UBI_SNAP_USED &&
+		    (snap->newest < 0 || sp->sqnum > snap->max_sqnum)) {
+			snap->max_sqnum = sp->sqnum;
+			snap->newest = pnum;
+		}
+	}
+}
+
+/**
+ * ubi_snap_save - keep the attach snapshot of an UBI device being detached.
+ * @ubi: UBI device description object
+ *
+ * The snapshot is still there if nothing was written to the device since it
+ * was attached. It is kept for the next attach of the same MTD device, which
+ * then does not need to scan it again.
+ */
+void ubi_snap_save(struct ubi_device *ubi)
+{
+	struct ubi_snap_cache *sc;
+
+	if (!ubi->snap)
+		return;
+
+	sc = kmalloc(sizeof(*sc) + strlen(ubi->mtd->name) + 1, GFP_KERNEL);
+	if (!sc) {
+		ubi_snap_drop(ubi);
+		return;
+	}
+
+	strcpy(sc->mtd_name, ubi->mtd->name);
+	sc->snap = ubi->snap;
+	ubi->snap = NULL;
+	list_add(&sc->list, &snap_cache);
+}
+
+#else
+static inline void snap_start(struct ubi_device *ubi) {}
+static inline void snap_validate(struct ubi_device *ubi) {}
+static inline void snap_record(struct ubi_device *ubi, int pnum, int state,
+			       int ec, const struct ubi_vid_hdr *vid_hdr) {}
+static inline int snap_replay(struct ubi_device *ubi,
+			      struct ubi_attach_info *ai, int pnum)
+{
+	return 1;
+}
+static inline void snap_finish(struct ubi_device *ubi) {}
+#endif
+
 /**
  * scan_peb - scan and process UBI headers of a PEB.
  * @ubi: UBI device description object
@@ -823,12 +1185,15 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 
 	dbg_bld("scan PEB %d", pnum);
 
+	snap_record(ubi, pnum, UBI_SNAP_UNKNOWN, 0, NULL);
+
 	/* Skip bad physical eraseblocks */
 	err = ubi_io_is_bad(ubi, pnum);
 	if (err < 0)
 		return err;
 	else if (err) {
 		ai->bad_peb_count += 1;
+		snap_record(ubi, pnum, UBI_SNAP_BAD, 0, NULL);
 		return 0;
 	}
 
@@ -977,9 +1342,11 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 		if (ec_err || bitflips)
 			err = add_to_list(ai, pnum, UBI_UNKNOWN,
 					  UBI_UNKNOWN, ec, 1, &ai->erase);
-		else
+		else {
 			err = add_to_list(ai, pnum, UBI_UNKNOWN,
 					  UBI_UNKNOWN, ec, 0, &ai->free);
+			snap_record(ubi, pnum, UBI_SNAP_FREE, ec, NULL);
+		}
 		if (err)
 			return err;
 		goto adjust_mean_ec;
@@ -1040,6 +1407,10 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	if (err)
 		return err;
 
+	if (!ec_err && !bitflips &&
+	    (vol_id < UBI_MAX_VOLUMES || vol_id == UBI_LAYOUT_VOLUME_ID))
+		snap_record(ubi, pnum, UBI_SNAP_USED, ec, vidh);
+
 adjust_mean_ec:
 	if (!ec_err) {
 		ai->ec_sum += ec;
@@ -1241,11 +1612,15 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	if (!vidh)
 		goto out_ech;
 
+	snap_validate(ubi);
+
 	for (pnum = start; pnum < ubi->peb_count; pnum++) {
 		cond_resched();
 
 		dbg_gen("process PEB %d", pnum);
-		err = scan_peb(ubi, ai, pnum, NULL, NULL);
+		err = snap_replay(ubi, ai, pnum);
+		if (err > 0)
+			err = scan_peb(ubi, ai, pnum, NULL, NULL);
 		if (err < 0)
 			goto out_vidh;
 	}
@@ -1287,6 +1662,8 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	if (err)
 		goto out_vidh;
 
+	snap_finish(ubi);
+
 	ubi_free_vid_hdr(ubi, vidh);
 	kfree(ech);
 
@@ -1406,6 +1783,8 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 	if (!ai)
 		return -ENOMEM;
 
+	snap_start(ubi);
+
 #ifdef CONFIG_MTD_UBI_FASTMAP
 	/* On small flash devices we disable fastmap in any case. */
 	if ((int)mtd_div_by_eb(ubi->mtd->size, ubi->mtd) <= UBI_FM_MAX_START) {
@@ -1436,6 +1815,12 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 	if (err)
 		goto out_ai;
 
+#ifdef CONFIG_MTD_UBI_FASTMAP
+	/* Attaching from a fastmap does not fill in the snapshot */
+	if (ubi->fm)
+		ubi_snap_drop(ubi);
+#endif
+
 	ubi->bad_peb_count = ai->bad_peb_count;
 	ubi->good_peb_count = ubi->peb_count - ubi->bad_peb_count;
 	ubi->corr_peb_count = ai->corr_peb_count;
@@ -1488,6 +1873,7 @@ out_vtbl:
 	ubi_free_internal_volumes(ubi);
 	vfree(ubi->vtbl);
 out_ai:
+	ubi_snap_drop(ubi);
 	destroy_ai(ai);
 	return err;
 }
@@ -251,6 +251,8 @@ int ubi_io_write(struct ubi_device *ubi, const void *buf, int pnum, int offset,
 	if (err)
 		return err;
 
+	ubi_snap_drop(ubi);
+
 	/* The area we are writing to has to contain all 0xFF bytes */
 	err = ubi_self_check_all_ff(ubi, pnum, offset, len);
 	if (err)
@@ -576,6 +578,8 @@ int ubi_io_sync_erase(struct ubi_device *ubi, int pnum, int torture)
 		return -EROFS;
 	}
 
+	ubi_snap_drop(ubi);
+
 	if (ubi->nor_flash) {
 		err = nor_erase_prepare(ubi, pnum);
 		if (err)
@@ -507,4 +507,74 @@ struct ubi_fm_eba {
 	__be32 reserved_pebs;
 	__be32 pnum[0];
 } __packed;
+
+/*
+ * UBI attach snapshot.
+ *
+ * This is not an on-flash structure. It summarizes the EC and VID headers
+ * found while scanning the PEBs of an UBI device, so that a later attach of
+ * the same device does not have to read them again. U-Boot keeps the snapshot
+ * of its last scan across "ubi part", and ubispl may pass the one it collected
+ * to U-Boot proper in a bloblist record. Records are in CPU byte order.
+ */
+
+#define UBI_SNAP_MAGIC 0x55425350 /* "UBSP" */
+
+/* The state of a PEB in the attach snapshot */
+enum {
+	UBI_SNAP_UNKNOWN = 0,
+	UBI_SNAP_BAD,
+	UBI_SNAP_FREE,
+	UBI_SNAP_USED,
+};
+
+/**
+ * struct ubi_snap_peb - attach snapshot record of a PEB
+ * @sqnum: sequence number from the VID header
+ * @ec: erase counter from the EC header
+ * @vol_id: volume ID from the VID header
+ * @lnum: logical eraseblock number from the VID header
+ * @data_size: data size from the VID header
+ * @used_ebs: used_ebs from the VID header
+ * @data_pad: data_pad from the VID header
+ * @state: %UBI_SNAP_UNKNOWN if the PEB has to be scanned, otherwise what the
+ *         scan found there
+ * @vol_type: volume type from the VID header
+ *
+ * Only @state and @ec are valid for free PEBs and only @state for bad ones.
+ */
+struct ubi_snap_peb {
+	__u64 sqnum;
+	__u32 ec;
+	__u32 vol_id;
+	__u32 lnum;
+	__u32 data_size;
+	__u32 used_ebs;
+	__u16 data_pad;
+	__u8 state;
+	__u8 vol_type;
+};
+
+/**
+ * struct ubi_snap - attach snapshot of an UBI device
+ * @max_sqnum: highest sequence number found in a VID header
+ * @magic: snapshot magic number (%UBI_SNAP_MAGIC)
+ * @peb_count: number of PEBs, that is, of @peb records
+ * @peb_size: size of a PEB in bytes
+ * @vid_hdr_offset: VID header offset in a PEB
+ * @image_seq: image sequence number found in the EC headers
+ * @newest: PEB holding the VID header with @max_sqnum, or -1
+ * @peb: one record per PEB
+ */
+struct ubi_snap {
+	__u64 max_sqnum;
+	__u32 magic;
+	__u32 peb_count;
+	__u32 peb_size;
+	__u32 vid_hdr_offset;
+	__u32 image_seq;
+	__s32 newest;
+	struct ubi_snap_peb peb[0];
+};
+
 #endif /* !__UBI_MEDIA_H__ */
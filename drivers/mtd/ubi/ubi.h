@@ -528,6 +528,9 @@ struct ubi_debug_info {
  * @buf_mutex: protects @peb_buf
  * @ckvol_mutex: serializes static volume checking when opening
  *
+ * @snap: attach snapshot taken by the last scan, dropped on the first write or
+ *        erase of a PEB
+ *
  * @dbg: debugging information for this UBI device
  */
 struct ubi_device {
@@ -627,6 +630,10 @@ struct ubi_device {
 	struct mutex buf_mutex;
 	struct mutex ckvol_mutex;
 
+#ifdef CONFIG_MTD_UBI_ATTACH_CACHE
+	struct ubi_snap *snap;
+#endif
+
 	struct ubi_debug_info dbg;
 };
 
@@ -795,6 +802,27 @@ struct ubi_ainf_peb *ubi_early_get_peb(struct ubi_device *ubi,
 				       struct ubi_attach_info *ai);
 int ubi_attach(struct ubi_device *ubi, int force_scan);
 void ubi_destroy_ai(struct ubi_attach_info *ai);
+#ifdef CONFIG_MTD_UBI_ATTACH_CACHE
+void ubi_snap_save(struct ubi_device *ubi);
+
+/**
+ * ubi_snap_drop - forget the attach snapshot of an UBI device.
+ * @ubi: UBI device description object
+ *
+ * The snapshot no longer describes the flash once a PEB has been written or
+ * erased, so the I/O sub-system calls this before doing either.
+ */
+static inline void ubi_snap_drop(struct ubi_device *ubi)
+{
+	if (ubi->snap) {
+		vfree(ubi->snap);
+		ubi->snap = NULL;
+	}
+}
+#else
+static inline void ubi_snap_save(struct ubi_device *ubi) {}
+static inline void ubi_snap_drop(struct ubi_device *ubi) {}
+#endif
 
 /* vtbl.c */
 int ubi_change_vtbl_record(struct ubi_device *ubi, int idx,
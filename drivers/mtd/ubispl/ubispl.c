@@ -8,6 +8,7 @@
  */
 
 #include <common.h>
+#include <bloblist.h>
 #include <errno.h>
 #include <linux/bug.h>
 #include <u-boot/crc.h>
@@ -229,6 +230,120 @@ out:
 
 #endif /* CONFIG_SPL_UBI_LOAD_BY_VOLNAME */
 
+#ifdef CONFIG_SPL_UBI_ATTACH_HANDOFF
+
+#define UBI_EC_UNKNOWN		0xffffffff
+
+static void ubi_io_read_ec(struct ubi_scan_info *ubi, int pnum)
+{
+	struct ubi_ec_hdr ech;
+	u32 image_seq;
+
+	ubi->ec[pnum] = UBI_EC_UNKNOWN;
+
+	if (ubi_io_read(ubi, &ech, pnum, 0, sizeof(ech)))
+		return;
+
+	if (be32_to_cpu(ech.magic) != UBI_EC_HDR_MAGIC ||
+	    ech.version != UBI_VERSION ||
+	    be64_to_cpu(ech.ec) > UBI_MAX_ERASECOUNTER)
+		return;
+
+	if (crc32(UBI_CRC32_INIT, &ech, UBI_EC_HDR_SIZE_CRC) !=
+	    be32_to_cpu(ech.hdr_crc))
+		return;
+
+	image_seq = be32_to_cpu(ech.image_seq);
+	if (!ubi->image_seq)
+		ubi->image_seq = image_seq;
+	if (image_seq && image_seq != ubi->image_seq)
+		return;
+
+	ubi->ec[pnum] = be64_to_cpu(ech.ec);
+}
+
+static int ubi_vid_hdr_is_ff(struct ubi_vid_hdr *vh)
+{
+	const u8 *p = (const u8 *)vh;
+	int i;
+
+	for (i = 0; i < sizeof(*vh); i++) {
+		if (p[i] != 0xff)
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * Pass the headers we scanned to U-Boot proper, which then attaches from
+ * them instead of scanning again. Blocks which were not scanned, e.g.
+ * because fastmap told us where the volumes are, and anything unusual
+ * about a block are left for U-Boot to scan.
+ */
+static void ubi_hand_over_scan(struct ubi_scan_info *ubi)
+{
+	struct ubi_snap *snap;
+	u32 pnum, vol_id, size;
+
+	size = sizeof(*snap) + ubi->peb_count * sizeof(snap->peb[0]);
+	snap = bloblist_ensure(BLOBLISTT_UBI_ATTACH, size);
+	if (!snap) {
+		ubi_warn("No space to hand over the scan");
+		return;
+	}
+
+	memset(snap, 0, size);
+	snap->magic = UBI_SNAP_MAGIC;
+	snap->peb_count = ubi->peb_count;
+	snap->peb_size = ubi->leb_start + ubi->leb_size;
+	snap->vid_hdr_offset = ubi->vid_offset;
+	snap->image_seq = ubi->image_seq;
+	snap->newest = -1;
+
+	for (pnum = 0; pnum < ubi->peb_count; pnum++) {
+		struct ubi_vid_hdr *vh = ubi->blockinfo + pnum;
+		struct ubi_snap_peb *sp = snap->peb + pnum;
+
+		if (!test_bit(pnum, ubi->scanned) ||
+		    ubi->ec[pnum] == UBI_EC_UNKNOWN)
+			continue;
+
+		if (test_bit(pnum, ubi->corrupt)) {
+			if (!ubi_vid_hdr_is_ff(vh))
+				continue;
+			sp->state = UBI_SNAP_FREE;
+			sp->ec = ubi->ec[pnum];
+			continue;
+		}
+
+		/* The fastmap blocks are read elsewhere */
+		if (be32_to_cpu(vh->magic) != UBI_VID_HDR_MAGIC)
+			continue;
+
+		vol_id = be32_to_cpu(vh->vol_id);
+		if (vh->copy_flag || be32_to_cpu(vh->data_pad) > U16_MAX ||
+		    (vol_id >= UBI_MAX_VOLUMES && vol_id != UBI_LAYOUT_VOLUME_ID))
+			continue;
+
+		sp->state = UBI_SNAP_USED;
+		sp->ec = ubi->ec[pnum];
+		sp->sqnum = be64_to_cpu(vh->sqnum);
+		sp->vol_id = vol_id;
+		sp->lnum = be32_to_cpu(vh->lnum);
+		sp->data_size = be32_to_cpu(vh->data_size);
+		sp->used_ebs = be32_to_cpu(vh->used_ebs);
+		sp->data_pad = be32_to_cpu(vh->data_pad);
+		sp->vol_type = vh->vol_type;
+
+		if (snap->newest < 0 || sp->sqnum > snap->max_sqnum) {
+			snap->max_sqnum = sp->sqnum;
+			snap->newest = pnum;
+		}
+	}
+}
+
+#endif /* CONFIG_SPL_UBI_ATTACH_HANDOFF */
+
 static int ubi_io_read_vid_hdr(struct ubi_scan_info *ubi, int pnum,
 			       struct ubi_vid_hdr *vh, int unused)
 {
@@ -244,6 +359,10 @@ static int ubi_io_read_vid_hdr(struct ubi_scan_info *ubi, int pnum,
 	if (test_and_set_bit(pnum, ubi->scanned))
 		return 0;
 
+#ifdef CONFIG_SPL_UBI_ATTACH_HANDOFF
+	ubi_io_read_ec(ubi, pnum);
+#endif
+
 	res = ubi_io_read(ubi, vh, pnum, ubi->vid_offset, sizeof(*vh));
 
 	/*
@@ -1135,5 +1254,9 @@ retry:
 			return res;
 		}
 	}
+
+#ifdef CONFIG_SPL_UBI_ATTACH_HANDOFF
+	ubi_hand_over_scan(ubi);
+#endif
 	return 0;
 }
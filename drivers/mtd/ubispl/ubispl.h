@@ -80,6 +80,9 @@ struct ubi_vol_info {
  * @vtbl_corrupted:	Flag to indicate status of volume table
  * @vtbl:		Volume table
  *
+ * @image_seq:		Image sequence number found in the EC headers
+ * @ec:			Erase counters of the scanned blocks
+ *
  * @fm_buf:		The large fastmap attach buffer
  */
 struct ubi_scan_info {
@@ -118,6 +121,11 @@ struct ubi_scan_info {
 	/* Volume table */
 	int                             vtbl_valid;
 	struct ubi_vtbl_record          vtbl[UBI_SPL_VOL_IDS];
+#endif
+#ifdef CONFIG_SPL_UBI_ATTACH_HANDOFF
+	/* Data handed over to U-Boot proper */
+	u32				image_seq;
+	u32				ec[CONFIG_SPL_UBI_MAX_PEBS];
 #endif
 	/* The large buffer for the fastmap */
 	uint8_t				fm_buf[UBI_FM_BUF_SIZE];
@@ -5,6 +5,7 @@
  */
 
 #include <common.h>
+#include <bloblist.h>
 #include <dm.h>
 #include <errno.h>
 #include <init.h>
@@ -787,21 +788,273 @@ error:
 	return ret;
 }
 
+/*
+ * Sizes of the PCI enumeration cache. This is kept in a bloblist so that its
+ * layout must not depend on the U-Boot phase.
+ */
+#define PCI_ENUM_MAX_BUSES	32
+#define PCI_ENUM_MAX_FUNCS	128
+
+/* Parent of a bus directly below a host controller */
+#define PCI_ENUM_ROOT		0xffffffff
+
+/* Bus number of a record which must not be used */
+#define PCI_ENUM_STALE		0xffff
+
+/**
+ * struct pci_enum_bus - A bus recorded in the PCI enumeration cache
+ *
+ * @parent:	BDF of the bridge leading to this bus, or PCI_ENUM_ROOT
+ * @busno:	Bus number, or PCI_ENUM_STALE if the record is no longer valid
+ * @first:	Index of the first function found on the bus
+ * @count:	Number of functions found on the bus
+ */
+struct pci_enum_bus {
+	u32 parent;
+	u16 busno;
+	u16 spare;
+	u16 first;
+	u16 count;
+};
+
+/**
+ * struct pci_enum_func - A function recorded in the PCI enumeration cache
+ *
+ * @bdf:	Bus/device/function of the function
+ * @id:		Vendor ID in bits 15:0, device ID in bits 31:16
+ * @class:	Class code in bits 31:8, header type in bits 7:0
+ */
+struct pci_enum_func {
+	u32 bdf;
+	u32 id;
+	u32 class;
+};
+
+/**
+ * struct pci_enum_cache - PCI functions found when buses were first scanned
+ *
+ * Scanning a bus reads the vendor ID at each of the 32 device slots (and the
+ * functions of any multi-function device), which is slow on large systems.
+ * The functions found are recorded here, so that later phases of U-Boot, or
+ * later probes of the same bus, only need to check that each one is still
+ * there.
+ *
+ * @num_buses:	Number of buses recorded
+ * @num_funcs:	Number of functions recorded, across all buses
+ * @bus:	Buses recorded
+ * @func:	Functions recorded
+ */
+struct pci_enum_cache {
+	u16 num_buses;
+	u16 num_funcs;
+	struct pci_enum_bus bus[PCI_ENUM_MAX_BUSES];
+	struct pci_enum_func func[PCI_ENUM_MAX_FUNCS];
+};
+
+static struct pci_enum_cache *pci_enum_cache_get(void)
+{
+#if CONFIG_IS_ENABLED(BLOBLIST)
+	/* The bloblist may not be set up yet */
+	if (gd->bloblist)
+		return bloblist_ensure(BLOBLISTT_PCI_ENUM,
+				       sizeof(struct pci_enum_cache));
+#endif
+
+	return NULL;
+}
+
+void pci_enum_cache_reset(void)
+{
+	struct pci_enum_cache *cache;
+
+	if (!CONFIG_IS_ENABLED(PCI_ENUM_CACHE))
+		return;
+
+	cache = pci_enum_cache_get();
+	if (cache) {
+		cache->num_buses = 0;
+		cache->num_funcs = 0;
+	}
+}
+
+static u32 pci_enum_parent(struct udevice *bus)
+{
+	if (!device_is_on_pci_bus(bus))
+		return PCI_ENUM_ROOT;
+
+	return dm_pci_get_bdf(bus);
+}
+
+static struct pci_enum_bus *pci_enum_find_bus(struct pci_enum_cache *cache,
+					      struct udevice *bus)
+{
+	u32 parent = pci_enum_parent(bus);
+	int i;
+
+	for (i = 0; i < cache->num_buses; i++) {
+		if (cache->bus[i].busno == dev_seq(bus) &&
+		    cache->bus[i].parent == parent)
+			return &cache->bus[i];
+	}
+
+	return NULL;
+}
+
+/* Record a function found while scanning, or return -ENOSPC if full */
+static int pci_enum_record(struct pci_enum_cache *cache, pci_dev_t bdf,
+			   ulong vendor, ulong device, ulong class,
+			   ulong header_type)
+{
+	struct pci_enum_func *func;
+
+	if (cache->num_funcs == PCI_ENUM_MAX_FUNCS)
+		return -ENOSPC;
+	func = &cache->func[cache->num_funcs++];
+	func->bdf = bdf;
+	func->id = vendor | device << 16;
+	func->class = class << 8 | header_type;
+
+	return 0;
+}
+
+/**
+ * pci_bind_function() - Bind a device for a function found on a bus
+ *
+ * This uses the device-tree node for the function if there is one, otherwise
+ * it binds a driver which matches the IDs, or a generic driver.
+ *
+ * @bus:	Bus containing the function
+ * @bdf:	Bus/device/function of the function
+ * @vendor:	Vendor ID
+ * @device:	Device ID
+ * @class:	Class code (without the revision)
+ * @header_type: Header type
+ * @devp:	Returns the device bound
+ * @return 0 if OK, -EPERM if the function should be ignored, other -ve on
+ *	error
+ */
+static int pci_bind_function(struct udevice *bus, pci_dev_t bdf,
+			     ulong vendor, ulong device, ulong class,
+			     ulong header_type, struct udevice **devp)
+{
+	struct pci_child_plat *pplat;
+	struct udevice *dev;
+	int ret;
+
+	debug("%s: bus %d/%s: found device %x, function %d", __func__,
+	      dev_seq(bus), bus->name, PCI_DEV(bdf), PCI_FUNC(bdf));
+
+	/* Find this device in the device tree */
+	ret = pci_bus_find_devfn(bus, PCI_MASK_BUS(bdf), &dev);
+	debug(": find ret=%d\n", ret);
+
+	/* If nothing in the device tree, bind a device */
+	if (ret == -ENODEV) {
+		struct pci_device_id find_id;
+		ulong val;
+
+		memset(&find_id, '\0', sizeof(find_id));
+		find_id.vendor = vendor;
+		find_id.device = device;
+		find_id.class = class;
+		if ((header_type & 0x7f) == PCI_HEADER_TYPE_NORMAL) {
+			pci_bus_read_config(bus, bdf, PCI_SUBSYSTEM_VENDOR_ID,
+					    &val, PCI_SIZE_32);
+			find_id.subvendor = val & 0xffff;
+			find_id.subdevice = val >> 16;
+		}
+		ret = pci_find_and_bind_driver(bus, &find_id, bdf, &dev);
+	}
+	if (ret)
+		return ret;
+
+	/* Update the platform data */
+	pplat = dev_get_parent_plat(dev);
+	pplat->devfn = PCI_MASK_BUS(bdf);
+	pplat->vendor = vendor;
+	pplat->device = device;
+	pplat->class = class;
+	*devp = dev;
+
+	return 0;
+}
+
+/**
+ * pci_bind_cached() - Bind the devices on a bus from the enumeration cache
+ *
+ * Each function recorded for the bus is checked with a single read of its
+ * IDs. If any of them has changed, the bus record is marked stale so that the
+ * bus is scanned again.
+ *
+ * @bus:	Bus to bind devices for
+ * @cache:	Enumeration cache
+ * @return 0 if OK, -ENOENT if the bus must be scanned instead, other -ve on
+ *	error
+ */
+static int pci_bind_cached(struct udevice *bus, struct pci_enum_cache *cache)
+{
+	struct pci_enum_bus *rec;
+	struct pci_enum_func *func;
+	struct udevice *dev;
+	int i, ret;
+	ulong id;
+
+	rec = pci_enum_find_bus(cache, bus);
+	if (!rec)
+		return -ENOENT;
+
+	for (i = 0; i < rec->count; i++) {
+		func = &cache->func[rec->first + i];
+		ret = pci_bus_read_config(bus, func->bdf, PCI_VENDOR_ID, &id,
+					  PCI_SIZE_32);
+		if (ret || id != func->id) {
+			debug("%s: bus %d/%s: cache is stale\n", __func__,
+			      dev_seq(bus), bus->name);
+			rec->busno = PCI_ENUM_STALE;
+			return -ENOENT;
+		}
+	}
+
+	for (i = 0; i < rec->count; i++) {
+		func = &cache->func[rec->first + i];
+		ret = pci_bind_function(bus, func->bdf, func->id & 0xffff,
+					func->id >> 16, func->class >> 8,
+					func->class & 0xff, &dev);
+		if (ret && ret != -EPERM)
+			return ret;
+	}
+
+	return 0;
+}
+
 int pci_bind_bus_devices(struct udevice *bus)
 {
+	struct pci_enum_cache *cache = NULL;
 	ulong vendor, device;
 	ulong header_type;
 	pci_dev_t bdf, end;
 	bool found_multi;
+	int first_func;
 	int ari_off;
 	int ret;
 
+	if (CONFIG_IS_ENABLED(PCI_ENUM_CACHE)) {
+		cache = pci_enum_cache_get();
+		if (cache) {
+			ret = pci_bind_cached(bus, cache);
+			if (ret != -ENOENT)
+				return ret;
+			if (cache->num_buses == PCI_ENUM_MAX_BUSES)
+				cache = NULL;
+		}
+	}
+	first_func = cache ? cache->num_funcs : 0;
+
 	found_multi = false;
 	end = PCI_BDF(dev_seq(bus), PCI_MAX_PCI_DEVICES - 1,
 		      PCI_MAX_PCI_FUNCTIONS - 1);
 	for (bdf = PCI_BDF(dev_seq(bus), 0, 0); bdf <= end;
 	     bdf += PCI_BDF(0, 0, 1)) {
-		struct pci_child_plat *pplat;
 		struct udevice *dev;
 		ulong class;
 
@@ -825,49 +1078,26 @@ int pci_bind_bus_devices(struct udevice *bus)
 		if (!PCI_FUNC(bdf))
 			found_multi = header_type & 0x80;
 
-		debug("%s: bus %d/%s: found device %x, function %d", __func__,
-		      dev_seq(bus), bus->name, PCI_DEV(bdf), PCI_FUNC(bdf));
 		pci_bus_read_config(bus, bdf, PCI_DEVICE_ID, &device,
 				    PCI_SIZE_16);
 		pci_bus_read_config(bus, bdf, PCI_CLASS_REVISION, &class,
 				    PCI_SIZE_32);
 		class >>= 8;
 
-		/* Find this device in the device tree */
-		ret = pci_bus_find_devfn(bus, PCI_MASK_BUS(bdf), &dev);
-		debug(": find ret=%d\n", ret);
-
-		/* If nothing in the device tree, bind a device */
-		if (ret == -ENODEV) {
-			struct pci_device_id find_id;
-			ulong val;
-
-			memset(&find_id, '\0', sizeof(find_id));
-			find_id.vendor = vendor;
-			find_id.device = device;
-			find_id.class = class;
-			if ((header_type & 0x7f) == PCI_HEADER_TYPE_NORMAL) {
-				pci_bus_read_config(bus, bdf,
-						    PCI_SUBSYSTEM_VENDOR_ID,
-						    &val, PCI_SIZE_32);
-				find_id.subvendor = val & 0xffff;
-				find_id.subdevice = val >> 16;
-			}
-			ret = pci_find_and_bind_driver(bus, &find_id, bdf,
-						       &dev);
+		/* Stop recording if the cache fills up */
+		if (cache && pci_enum_record(cache, bdf, vendor, device, class,
+					     header_type)) {
+			cache->num_funcs = first_func;
+			cache = NULL;
 		}
+
+		ret = pci_bind_function(bus, bdf, vendor, device, class,
+					header_type, &dev);
 		if (ret == -EPERM)
 			continue;
 		else if (ret)
 			return ret;
 
-		/* Update the platform data */
-		pplat = dev_get_parent_plat(dev);
-		pplat->devfn = PCI_MASK_BUS(bdf);
-		pplat->vendor = vendor;
-		pplat->device = device;
-		pplat->class = class;
-
 		if (IS_ENABLED(CONFIG_PCI_ARID)) {
 			ari_off = dm_pci_find_ext_capability(dev,
 							     PCI_EXT_CAP_ID_ARI);
@@ -894,6 +1124,15 @@ int pci_bind_bus_devices(struct udevice *bus)
 		}
 	}
 
+	if (cache) {
+		struct pci_enum_bus *rec = &cache->bus[cache->num_buses++];
+
+		rec->parent = pci_enum_parent(bus);
+		rec->busno = dev_seq(bus);
+		rec->first = first_func;
+		rec->count = cache->num_funcs - first_func;
+	}
+
 	return 0;
 error:
 	printf("Cannot read bus configuration: %d\n", ret);
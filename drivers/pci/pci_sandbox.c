@@ -9,6 +9,7 @@
 #include <fdtdec.h>
 #include <log.h>
 #include <pci.h>
+#include <asm/test.h>
 
 #define FDT_DEV_INFO_CELLS	4
 #define FDT_DEV_INFO_SIZE	(FDT_DEV_INFO_CELLS * sizeof(u32))
@@ -20,6 +21,7 @@ struct sandbox_pci_priv {
 		u16 vendor;
 		u16 device;
 	} vendev[256];
+	uint id_reads;
 };
 
 static int sandbox_pci_write_config(struct udevice *bus, pci_dev_t devfn,
@@ -49,6 +51,9 @@ static int sandbox_pci_read_config(const struct udevice *bus, pci_dev_t devfn,
 	struct sandbox_pci_priv *priv = dev_get_priv(bus);
 	int ret;
 
+	if (offset == PCI_VENDOR_ID)
+		priv->id_reads++;
+
 	/* Prepare the default response */
 	*valuep = pci_get_ff(size);
 	ret = sandbox_pci_get_emul(bus, devfn, &container, &emul);
@@ -60,10 +65,14 @@ static int sandbox_pci_read_config(const struct udevice *bus, pci_dev_t devfn,
 						  PCI_FUNC(devfn));
 			vendor = priv->vendev[devfn].vendor;
 			device = priv->vendev[devfn].device;
-			if (offset == PCI_VENDOR_ID && vendor)
+			if (offset == PCI_VENDOR_ID && vendor) {
+				/* A 32-bit read returns both IDs */
 				*valuep = vendor;
-			else if (offset == PCI_DEVICE_ID && device)
+				if (size == PCI_SIZE_32)
+					*valuep |= device << 16;
+			} else if (offset == PCI_DEVICE_ID && device) {
 				*valuep = device;
+			}
 
 			return 0;
 		} else {
@@ -77,6 +86,13 @@ static int sandbox_pci_read_config(const struct udevice *bus, pci_dev_t devfn,
 	return ops->read_config(emul, offset, valuep, size);
 }
 
+uint sandbox_pci_get_id_reads(struct udevice *bus)
+{
+	struct sandbox_pci_priv *priv = dev_get_priv(bus);
+
+	return priv->id_reads;
+}
+
 static int sandbox_pci_probe(struct udevice *dev)
 {
 	struct sandbox_pci_priv *priv = dev_get_priv(dev);
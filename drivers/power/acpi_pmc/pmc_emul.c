@@ -57,6 +57,8 @@ static int sandbox_pmc_emul_read_config(const struct udevice *emul, uint offset,
 		break;
 	case PCI_VENDOR_ID:
 		*valuep = SANDBOX_PCI_VENDOR_ID;
+		if (size == PCI_SIZE_32)
+			*valuep |= SANDBOX_PCI_PMC_EMUL_ID << 16;
 		break;
 	case PCI_DEVICE_ID:
 		*valuep = SANDBOX_PCI_PMC_EMUL_ID;
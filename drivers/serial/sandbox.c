@@ -20,6 +20,7 @@
 #include <linux/compiler.h>
 #include <asm/serial.h>
 #include <asm/state.h>
+#include <asm/test.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -72,6 +73,9 @@ static int sandbox_serial_putc(struct udevice *dev, const char ch)
 	struct sandbox_serial_priv *priv = dev_get_priv(dev);
 	struct sandbox_serial_plat *plat = dev_get_plat(dev);
 
+	if (priv->busy)
+		return -EAGAIN;
+
 	/* With of-platdata we don't real the colour correctly, so disable it */
 	if (!CONFIG_IS_ENABLED(OF_PLATDATA) && priv->start_of_line &&
 	    plat->colour != -1) {
@@ -86,6 +90,13 @@ static int sandbox_serial_putc(struct udevice *dev, const char ch)
 	return 0;
 }
 
+void sandbox_serial_set_busy(struct udevice *dev, bool busy)
+{
+	struct sandbox_serial_priv *priv = dev_get_priv(dev);
+
+	priv->busy = busy;
+}
+
 static int sandbox_serial_pending(struct udevice *dev, bool input)
 {
 	struct sandbox_serial_priv *priv = dev_get_priv(dev);
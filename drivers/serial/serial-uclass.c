@@ -185,6 +185,78 @@ int serial_initialize(void)
 	return serial_init();
 }
 
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+/**
+ * serial_tx_drain() - Send characters from the TX buffer to the UART
+ *
+ * Nothing is done if this is called from within the driver while the buffer
+ * is already being sent, e.g. from udelay().
+ *
+ * @dev: Device to send to
+ * @wait: true to wait for the UART until the buffer is empty, false to stop
+ *	as soon as the UART has no room
+ */
+static void serial_tx_drain(struct udevice *dev, bool wait)
+{
+	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+	struct dm_serial_ops *ops = serial_get_ops(dev);
+	int err;
+
+	if (!upriv->tx_buf || upriv->tx_busy)
+		return;
+
+	upriv->tx_busy = true;
+	while (upriv->tx_rd_ptr != upriv->tx_wr_ptr) {
+		err = ops->putc(dev, upriv->tx_buf[upriv->tx_rd_ptr]);
+		if (err == -EAGAIN) {
+			if (!wait)
+				break;
+			WATCHDOG_RESET();
+			continue;
+		}
+		upriv->tx_rd_ptr++;
+		upriv->tx_rd_ptr %= CONFIG_SERIAL_TX_BUFFER_SIZE;
+	}
+	upriv->tx_busy = false;
+}
+
+/**
+ * serial_tx_queue() - Add a character to the TX buffer
+ *
+ * If the buffer is full this waits for the UART to take enough characters to
+ * make room.
+ *
+ * @dev: Device to send to
+ * @ch: Character to send
+ * @return 0 if OK, -ENOSPC if there is no buffer to use
+ */
+static int serial_tx_queue(struct udevice *dev, char ch)
+{
+	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+	int next;
+
+	if (!upriv->tx_buf || upriv->tx_busy || upriv->tx_stopped)
+		return -ENOSPC;
+
+	next = (upriv->tx_wr_ptr + 1) % CONFIG_SERIAL_TX_BUFFER_SIZE;
+	while (next == upriv->tx_rd_ptr)
+		serial_tx_drain(dev, false);
+	upriv->tx_buf[upriv->tx_wr_ptr] = ch;
+	upriv->tx_wr_ptr = next;
+
+	return 0;
+}
+#else
+static void serial_tx_drain(struct udevice *dev, bool wait)
+{
+}
+
+static int serial_tx_queue(struct udevice *dev, char ch)
+{
+	return -ENOSPC;
+}
+#endif /* CONFIG_IS_ENABLED(SERIAL_TX_BUFFER) */
+
 static void _serial_putc(struct udevice *dev, char ch)
 {
 	struct dm_serial_ops *ops = serial_get_ops(dev);
@@ -193,6 +265,11 @@ static void _serial_putc(struct udevice *dev, char ch)
 	if (ch == '\n')
 		_serial_putc(dev, '\r');
 
+	if (!serial_tx_queue(dev, ch)) {
+		serial_tx_drain(dev, false);
+		return;
+	}
+
 	do {
 		err = ops->putc(dev, ch);
 	} while (err == -EAGAIN);
@@ -211,8 +288,10 @@ static int __serial_getc(struct udevice *dev)
 
 	do {
 		err = ops->getc(dev);
-		if (err == -EAGAIN)
+		if (err == -EAGAIN) {
+			serial_tx_drain(dev, false);
 			WATCHDOG_RESET();
+		}
 	} while (err == -EAGAIN);
 
 	return err >= 0 ? err : 0;
@@ -222,6 +301,7 @@ static int __serial_tstc(struct udevice *dev)
 {
 	struct dm_serial_ops *ops = serial_get_ops(dev);
 
+	serial_tx_drain(dev, false);
 	if (ops->pending)
 		return ops->pending(dev, true);
 
@@ -297,6 +377,69 @@ int serial_tstc(void)
 	return _serial_tstc(gd->cur_serial_dev);
 }
 
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+void serial_tx_poll(void)
+{
+	struct udevice *dev = gd->cur_serial_dev;
+
+	/* This is called from udelay(), which may run before probe */
+	if (!dev || !device_active(dev) || !dev_get_uclass_priv(dev))
+		return;
+
+	serial_tx_drain(dev, false);
+}
+
+void serial_flush(void)
+{
+	struct udevice *dev;
+	struct uclass *uc;
+
+	/* There is no buffer before relocation */
+	if (!(gd->flags & GD_FLG_RELOC))
+		return;
+
+	/* Output may have gone to any UART registered with stdio */
+	uclass_id_foreach_dev(UCLASS_SERIAL, dev, uc) {
+		if (device_active(dev))
+			serial_tx_drain(dev, true);
+	}
+}
+
+/**
+ * serial_tx_set_stopped() - Stop or resume buffering on all active UARTs
+ *
+ * @stopped: true to send all buffered output and then bypass the buffer,
+ *	false to use the buffer again
+ */
+static void serial_tx_set_stopped(bool stopped)
+{
+	struct serial_dev_priv *upriv;
+	struct udevice *dev;
+	struct uclass *uc;
+
+	if (!(gd->flags & GD_FLG_RELOC))
+		return;
+
+	uclass_id_foreach_dev(UCLASS_SERIAL, dev, uc) {
+		if (!device_active(dev))
+			continue;
+		serial_tx_drain(dev, true);
+		upriv = dev_get_uclass_priv(dev);
+		upriv->tx_stopped = stopped;
+	}
+}
+
+void serial_tx_stop(void)
+{
+	serial_tx_set_stopped(true);
+}
+
+void serial_tx_start(void)
+{
+	serial_tx_set_stopped(false);
+}
+#endif
+
 void serial_setbrg(void)
 {
 	struct dm_serial_ops *ops;
@@ -304,6 +447,8 @@ void serial_setbrg(void)
 	if (!gd->cur_serial_dev)
 		return;
 
+	/* Send what is queued at the old baud rate */
+	serial_tx_drain(gd->cur_serial_dev, true);
 	ops = serial_get_ops(gd->cur_serial_dev);
 	if (ops->setbrg)
 		ops->setbrg(gd->cur_serial_dev, gd->baudrate);
@@ -324,6 +469,7 @@ int serial_setconfig(struct udevice *dev, uint config)
 {
 	struct dm_serial_ops *ops;
 
+	serial_tx_drain(dev, true);
 	ops = serial_get_ops(dev);
 	if (ops->setconfig)
 		return ops->setconfig(dev, config);
@@ -493,6 +639,10 @@ static int serial_post_probe(struct udevice *dev)
 	/* Allocate the RX buffer */
 	upriv->buf = malloc(CONFIG_SERIAL_RX_BUFFER_SIZE);
 #endif
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+	/* Allocate the TX buffer, falling back to unbuffered output */
+	upriv->tx_buf = malloc(CONFIG_SERIAL_TX_BUFFER_SIZE);
+#endif
 
 	stdio_register_dev(&sdev, &upriv->sdev);
 #endif
@@ -501,12 +651,15 @@ static int serial_post_probe(struct udevice *dev)
 
 static int serial_pre_remove(struct udevice *dev)
 {
-#if CONFIG_IS_ENABLED(SYS_STDIO_DEREGISTER)
 	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
 
+#if CONFIG_IS_ENABLED(SYS_STDIO_DEREGISTER)
 	if (stdio_deregister_dev(upriv->sdev, true))
 		return -EPERM;
 #endif
+	serial_tx_drain(dev, true);
+	free(upriv->tx_buf);
+	upriv->tx_buf = NULL;
 
 	return 0;
 }
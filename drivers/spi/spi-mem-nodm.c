@@ -7,6 +7,7 @@
 #include <malloc.h>
 #include <spi.h>
 #include <spi-mem.h>
+#include <linux/err.h>
 
 int spi_mem_exec_op(struct spi_slave *slave,
 		    const struct spi_mem_op *op)
@@ -105,3 +106,24 @@ int spi_mem_adjust_op_size(struct spi_slave *slave,
 
 	return 0;
 }
+
+/*
+ * Without driver model there is no controller to provide a memory-mapped
+ * window, so callers keep using spi_mem_exec_op().
+ */
+struct spi_mem_dirmap_desc *
+spi_mem_dirmap_create(struct spi_slave *slave,
+		      const struct spi_mem_dirmap_info *info)
+{
+	return ERR_PTR(-ENOTSUPP);
+}
+
+void spi_mem_dirmap_destroy(struct spi_mem_dirmap_desc *desc)
+{
+}
+
+ssize_t spi_mem_dirmap_read(struct spi_mem_dirmap_desc *desc,
+			    u64 offs, size_t len, void *buf)
+{
+	return -ENOTSUPP;
+}
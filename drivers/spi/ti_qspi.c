@@ -354,6 +354,37 @@ static int ti_qspi_exec_mem_op(struct spi_slave *slave,
 	return ret;
 }
 
+static int ti_qspi_dirmap_create(struct spi_mem_dirmap_desc *desc)
+{
+	struct ti_qspi_priv *priv = dev_get_priv(desc->slave->dev->parent);
+	const struct spi_mem_op *op = &desc->info.op_tmpl;
+
+	/* Only reads fitting in the MMIO window can be mapped. */
+	if (op->addr.nbytes > 4 ||
+	    desc->info.offset + desc->info.length > priv->mmap_size)
+		return -ENOTSUPP;
+
+	return 0;
+}
+
+static ssize_t ti_qspi_dirmap_read(struct spi_mem_dirmap_desc *desc,
+				   u64 offs, size_t len, void *buf)
+{
+	struct udevice *dev = desc->slave->dev;
+	struct dm_spi_slave_plat *slave_plat = dev_get_parent_plat(dev);
+	struct ti_qspi_priv *priv = dev_get_priv(dev->parent);
+	const struct spi_mem_op *op = &desc->info.op_tmpl;
+
+	ti_qspi_setup_mmap_read(priv, slave_plat->cs, op->cmd.opcode,
+				op->data.buswidth, op->addr.nbytes,
+				op->dummy.nbytes);
+
+	ti_qspi_copy_mmap(buf, priv->memory_map + desc->info.offset + offs,
+			  len);
+
+	return len;
+}
+
 static int ti_qspi_claim_bus(struct udevice *dev)
 {
 	struct dm_spi_slave_plat *slave_plat = dev_get_parent_plat(dev);
@@ -483,6 +514,8 @@ static int ti_qspi_of_to_plat(struct udevice *bus)
 
 static const struct spi_controller_mem_ops ti_qspi_mem_ops = {
 	.exec_op = ti_qspi_exec_mem_op,
+	.dirmap_create = ti_qspi_dirmap_create,
+	.dirmap_read = ti_qspi_dirmap_read,
 };
 
 static const struct dm_spi_ops ti_qspi_ops = {
@@ -14,6 +14,7 @@
 #include <hang.h>
 #include <log.h>
 #include <regmap.h>
+#include <serial.h>
 #include <spl.h>
 #include <sysreset.h>
 #include <dm/device-internal.h>
@@ -96,6 +97,7 @@ void sysreset_walk_halt(enum sysreset_t type)
 {
 	int ret;
 
+	serial_flush();
 	ret = sysreset_walk(type);
 
 	/* Wait for the reset to take effect */
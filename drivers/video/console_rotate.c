@@ -53,6 +53,9 @@ static int console_set_row_1(struct udevice *dev, uint row, int clr)
 		}
 		line += vid_priv->line_length;
 	}
+	video_damage(dev->parent,
+		     vid_priv->xsize - (row + 1) * VIDEO_FONT_HEIGHT, 0,
+		     VIDEO_FONT_HEIGHT, vid_priv->ysize);
 	ret = vidconsole_sync_copy(dev, start, line);
 	if (ret)
 		return ret;
@@ -73,6 +76,9 @@ static int console_move_rows_1(struct udevice *dev, uint rowdst, uint rowsrc,
 		(rowdst + count) * VIDEO_FONT_HEIGHT * pbytes;
 	src = vid_priv->fb + vid_priv->line_length -
 		(rowsrc + count) * VIDEO_FONT_HEIGHT * pbytes;
+	video_damage(dev->parent,
+		     vid_priv->xsize - (rowdst + count) * VIDEO_FONT_HEIGHT, 0,
+		     count * VIDEO_FONT_HEIGHT, vid_priv->ysize);
 
 	for (j = 0; j < vid_priv->ysize; j++) {
 		ret = vidconsole_memmove(dev, dst, src,
@@ -145,6 +151,9 @@ static int console_putc_xy_1(struct udevice *dev, uint x_frac, uint y, char ch)
 		line += vid_priv->line_length;
 		mask >>= 1;
 	}
+	video_damage(vid, vid_priv->xsize - y - VIDEO_FONT_HEIGHT, linenum - 1,
+		     VIDEO_FONT_HEIGHT, VIDEO_FONT_HEIGHT);
+
 	/* We draw backwards from 'start, so account for the first line */
 	ret = vidconsole_sync_copy(dev, start - vid_priv->line_length, line);
 	if (ret)
@@ -195,6 +204,9 @@ static int console_set_row_2(struct udevice *dev, uint row, int clr)
 	default:
 		return -ENOSYS;
 	}
+	video_damage(dev->parent, 0,
+		     vid_priv->ysize - (row + 1) * VIDEO_FONT_HEIGHT,
+		     vid_priv->xsize, VIDEO_FONT_HEIGHT);
 	ret = vidconsole_sync_copy(dev, start, end);
 	if (ret)
 		return ret;
@@ -215,6 +227,9 @@ static int console_move_rows_2(struct udevice *dev, uint rowdst, uint rowsrc,
 		vid_priv->line_length;
 	src = end - (rowsrc + count) * VIDEO_FONT_HEIGHT *
 		vid_priv->line_length;
+	video_damage(dev->parent, 0,
+		     vid_priv->ysize - (rowdst + count) * VIDEO_FONT_HEIGHT,
+		     vid_priv->xsize, count * VIDEO_FONT_HEIGHT);
 	vidconsole_memmove(dev, dst, src,
 			   VIDEO_FONT_HEIGHT * vid_priv->line_length * count);
 
@@ -283,6 +298,10 @@ static int console_putc_xy_2(struct udevice *dev, uint x_frac, uint y, char ch)
 		}
 		line -= vid_priv->line_length;
 	}
+	video_damage(vid, x - VIDEO_FONT_WIDTH + 1,
+		     linenum - VIDEO_FONT_HEIGHT + 1, VIDEO_FONT_WIDTH,
+		     VIDEO_FONT_HEIGHT);
+
 	/* Add 4 bytes to allow for the first pixel writen */
 	ret = vidconsole_sync_copy(dev, start + 4, line);
 	if (ret)
@@ -331,6 +350,8 @@ static int console_set_row_3(struct udevice *dev, uint row, int clr)
 		}
 		line += vid_priv->line_length;
 	}
+	video_damage(dev->parent, row * VIDEO_FONT_HEIGHT, 0, VIDEO_FONT_HEIGHT,
+		     vid_priv->ysize);
 	ret = vidconsole_sync_copy(dev, start, line);
 	if (ret)
 		return ret;
@@ -349,6 +370,8 @@ static int console_move_rows_3(struct udevice *dev, uint rowdst, uint rowsrc,
 
 	dst = vid_priv->fb + rowdst * VIDEO_FONT_HEIGHT * pbytes;
 	src = vid_priv->fb + rowsrc * VIDEO_FONT_HEIGHT * pbytes;
+	video_damage(dev->parent, rowdst * VIDEO_FONT_HEIGHT, 0,
+		     count * VIDEO_FONT_HEIGHT, vid_priv->ysize);
 
 	for (j = 0; j < vid_priv->ysize; j++) {
 		ret = vidconsole_memmove(dev, dst, src,
@@ -419,6 +442,9 @@ static int console_putc_xy_3(struct udevice *dev, uint x_frac, uint y, char ch)
 		line -= vid_priv->line_length;
 		mask >>= 1;
 	}
+	video_damage(vid, y, x - VIDEO_FONT_HEIGHT + 1, VIDEO_FONT_HEIGHT,
+		     VIDEO_FONT_HEIGHT);
+
 	/* Add a line to allow for the first pixels writen */
 	ret = vidconsole_sync_copy(dev, start + vid_priv->line_length, line);
 	if (ret)
@@ -93,6 +93,37 @@ struct pos_info {
  */
 #define POS_HISTORY_SIZE	(CONFIG_SYS_CBSIZE * 11 / 10)
 
+/*
+ * Number of sub-pixel positions at which each character is rendered in the
+ * glyph cache. The horizontal start of a glyph is rounded down to one of
+ * these.
+ */
+#define GLYPH_PHASES		4
+
+/**
+ * struct tt_glyph - A character image held in the glyph cache
+ *
+ * The image holds the coverage of each pixel, so it does not depend on the
+ * colours in use. The font and size are fixed for each console device, so
+ * the cache only needs to be indexed by character and sub-pixel position.
+ *
+ * @data:	8-bit-per-pixel image of the character, or NULL if it has no
+ *		visible pixels (e.g. ' ')
+ * @width:	Width of the image in pixels
+ * @height:	Height of the image in pixels
+ * @xoff:	X offset of the image from the cursor position
+ * @yoff:	Y offset of the image from the baseline
+ * @valid:	true if this entry has been rendered
+ */
+struct tt_glyph {
+	u8 *data;
+	short width;
+	short height;
+	short xoff;
+	short yoff;
+	bool valid;
+};
+
 /**
  * struct console_tt_priv - Private data for this driver
  *
@@ -112,6 +143,9 @@ struct pos_info {
  * @scale:	Scale of the font. This is calculated from the pixel height
  *		of the font. It is used by the STB library to generate images
  *		of the correct size.
+ * @glyphs:	Glyph cache, indexed by character and sub-pixel position
+ * @glyph_cache: true to use the glyph cache, false to render every character
+ * @glyph_hits:	Number of characters found in the glyph cache
  */
 struct console_tt_priv {
 	int font_size;
@@ -121,6 +155,11 @@ struct console_tt_priv {
 	int pos_ptr;
 	int baseline;
 	double scale;
+#ifdef CONFIG_CONSOLE_TRUETYPE_GLYPH_CACHE
+	struct tt_glyph glyphs[256][GLYPH_PHASES];
+	bool glyph_cache;
+	int glyph_hits;
+#endif
 };
 
 static int console_truetype_set_row(struct udevice *dev, uint row, int clr)
@@ -166,6 +205,8 @@ static int console_truetype_set_row(struct udevice *dev, uint row, int clr)
 	default:
 		return -ENOSYS;
 	}
+	video_damage(dev->parent, 0, priv->font_size * row, vid_priv->xsize,
+		     priv->font_size);
 	ret = vidconsole_sync_copy(dev, line, end);
 	if (ret)
 		return ret;
@@ -184,6 +225,8 @@ static int console_truetype_move_rows(struct udevice *dev, uint rowdst,
 
 	dst = vid_priv->fb + rowdst * priv->font_size * vid_priv->line_length;
 	src = vid_priv->fb + rowsrc * priv->font_size * vid_priv->line_length;
+	video_damage(dev->parent, 0, priv->font_size * rowdst, vid_priv->xsize,
+		     priv->font_size * count);
 	ret = vidconsole_memmove(dev, dst, src, priv->font_size *
 				 vid_priv->line_length * count);
 	if (ret)
@@ -197,6 +240,45 @@ static int console_truetype_move_rows(struct udevice *dev, uint rowdst,
 	return 0;
 }
 
+#ifdef CONFIG_CONSOLE_TRUETYPE_GLYPH_CACHE
+/**
+ * console_truetype_get_glyph() - Get the image of a character from the cache
+ *
+ * The character is rendered and added to the cache if not already there.
+ *
+ * @priv:	Console private data
+ * @ch:		Character to look up
+ * @x_shift:	Sub-pixel position of the character (0 to just below 1)
+ * @return glyph-cache entry, or NULL if out of memory
+ */
+static struct tt_glyph *console_truetype_get_glyph(struct console_tt_priv *priv,
+						   char ch, double x_shift)
+{
+	int phase = (int)(x_shift * GLYPH_PHASES);
+	struct tt_glyph *glyph;
+	int width, height, xoff, yoff;
+
+	glyph = &priv->glyphs[(u8)ch][phase];
+	if (glyph->valid) {
+		priv->glyph_hits++;
+		return glyph;
+	}
+
+	glyph->data = stbtt_GetCodepointBitmapSubpixel(&priv->font,
+			priv->scale, priv->scale, (double)phase / GLYPH_PHASES,
+			0, ch, &width, &height, &xoff, &yoff);
+	if (!glyph->data && width && height)
+		return NULL;
+	glyph->width = width;
+	glyph->height = height;
+	glyph->xoff = xoff;
+	glyph->yoff = yoff;
+	glyph->valid = true;
+
+	return glyph;
+}
+#endif
+
 static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 				    char ch)
 {
@@ -214,6 +296,10 @@ static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 	int advance;
 	void *start, *end, *line;
 	int row, ret;
+	bool cached = false;
+#ifdef CONFIG_CONSOLE_TRUETYPE_GLYPH_CACHE
+	struct tt_glyph *glyph;
+#endif
 
 	/* First get some basic metrics about this character */
 	stbtt_GetCodepointHMetrics(font, ch, &advance, &lsb);
@@ -254,9 +340,24 @@ static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 	 * image of the character. For empty characters, like ' ', data will
 	 * return NULL;
 	 */
-	data = stbtt_GetCodepointBitmapSubpixel(font, priv->scale, priv->scale,
-						x_shift, 0, ch, &width, &height,
-						&xoff, &yoff);
+#ifdef CONFIG_CONSOLE_TRUETYPE_GLYPH_CACHE
+	if (priv->glyph_cache) {
+		glyph = console_truetype_get_glyph(priv, ch, x_shift);
+		if (!glyph)
+			return -ENOMEM;
+		data = glyph->data;
+		width = glyph->width;
+		height = glyph->height;
+		xoff = glyph->xoff;
+		yoff = glyph->yoff;
+		cached = true;
+	}
+#endif
+	if (!cached)
+		data = stbtt_GetCodepointBitmapSubpixel(font, priv->scale,
+							priv->scale, x_shift, 0,
+							ch, &width, &height,
+							&xoff, &yoff);
 	if (!data)
 		return width_frac;
 
@@ -323,16 +424,20 @@ static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 		}
 #endif
 		default:
-			free(data);
+			if (!cached)
+				free(data);
 			return -ENOSYS;
 		}
 
 		line += vid_priv->line_length;
 	}
+	video_damage(vid, VID_TO_PIXEL(x) + xoff, y + max(linenum, 0), width,
+		     height);
 	ret = vidconsole_sync_copy(dev, start, line);
 	if (ret)
 		return ret;
-	free(data);
+	if (!cached)
+		free(data);
 
 	return width_frac;
 }
@@ -396,6 +501,7 @@ static int console_truetype_erase(struct udevice *dev, int xstart, int ystart,
 		}
 		line += vid_priv->line_length;
 	}
+	video_damage(dev->parent, xstart, ystart, xend - xstart, yend - ystart);
 	ret = vidconsole_sync_copy(dev, start, line);
 	if (ret)
 		return ret;
@@ -570,11 +676,45 @@ static int console_truetype_probe(struct udevice *dev)
 	priv->scale = stbtt_ScaleForPixelHeight(font, priv->font_size);
 	stbtt_GetFontVMetrics(font, &ascent, 0, 0);
 	priv->baseline = (int)(ascent * priv->scale);
+#ifdef CONFIG_CONSOLE_TRUETYPE_GLYPH_CACHE
+	priv->glyph_cache = true;
+#endif
 	debug("%s: ready\n", __func__);
 
 	return 0;
 }
 
+#ifdef CONFIG_CONSOLE_TRUETYPE_GLYPH_CACHE
+static int console_truetype_remove(struct udevice *dev)
+{
+	struct console_tt_priv *priv = dev_get_priv(dev);
+	int ch, phase;
+
+	for (ch = 0; ch < ARRAY_SIZE(priv->glyphs); ch++) {
+		for (phase = 0; phase < GLYPH_PHASES; phase++)
+			free(priv->glyphs[ch][phase].data);
+	}
+
+	return 0;
+}
+
+int console_truetype_set_glyph_cache(struct udevice *dev, bool enable)
+{
+	struct console_tt_priv *priv = dev_get_priv(dev);
+
+	priv->glyph_cache = enable;
+
+	return 0;
+}
+
+int console_truetype_get_glyph_hits(struct udevice *dev)
+{
+	struct console_tt_priv *priv = dev_get_priv(dev);
+
+	return priv->glyph_hits;
+}
+#endif
+
 struct vidconsole_ops console_truetype_ops = {
 	.putc_xy	= console_truetype_putc_xy,
 	.move_rows	= console_truetype_move_rows,
@@ -588,5 +728,8 @@ U_BOOT_DRIVER(vidconsole_truetype) = {
 	.id	= UCLASS_VIDEO_CONSOLE,
 	.ops	= &console_truetype_ops,
 	.probe	= console_truetype_probe,
+#ifdef CONFIG_CONSOLE_TRUETYPE_GLYPH_CACHE
+	.remove	= console_truetype_remove,
+#endif
 	.priv_auto	= sizeof(struct console_tt_priv),
 };
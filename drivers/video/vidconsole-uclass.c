@@ -92,14 +92,17 @@ static int vidconsole_back(struct udevice *dev)
 	return video_sync(dev->parent, false);
 }
 
-/* Move to a newline, scrolling the display if necessary */
+/*
+ * Move to a newline, scrolling the display if necessary. This does not sync
+ * the display, so that a string covering several lines is synced only once
+ */
 static void vidconsole_newline(struct udevice *dev)
 {
 	struct vidconsole_priv *priv = dev_get_uclass_priv(dev);
 	struct udevice *vid_dev = dev->parent;
 	struct video_priv *vid_priv = dev_get_uclass_priv(vid_dev);
 	const int rows = CONFIG_CONSOLE_SCROLL_LINES;
-	int i, ret;
+	int i;
 
 	priv->xcur_frac = priv->xstart_frac;
 	priv->ycur += priv->y_charsize;
@@ -113,13 +116,6 @@ static void vidconsole_newline(struct udevice *dev)
 		priv->ycur -= rows * priv->y_charsize;
 	}
 	priv->last_ch = 0;
-
-	ret = video_sync(dev->parent, false);
-	if (ret) {
-#ifdef DEBUG
-		console_puts_select_stderr(true, "[vc err: video_sync]");
-#endif
-	}
 }
 
 static const struct vid_rgb colors[VID_COLOR_COUNT] = {
@@ -140,6 +140,7 @@ int video_clear(struct udevice *dev)
 		memset(priv->fb, priv->colour_bg, priv->fb_size);
 		break;
 	}
+	video_damage(dev, 0, 0, priv->xsize, priv->ysize);
 	ret = video_sync_copy(dev, priv->fb, priv->fb + priv->fb_size);
 	if (ret)
 		return ret;
@@ -173,9 +174,72 @@ void video_set_default_colors(struct udevice *dev, bool invert)
 	priv->colour_bg = vid_console_color(priv, back);
 }
 
+#ifdef CONFIG_VIDEO_DAMAGE
+void video_damage(struct udevice *vid, int x, int y, int width, int height)
+{
+	struct video_priv *priv = dev_get_uclass_priv(vid);
+	int xend = min(x + width, (int)priv->xsize);
+	int yend = min(y + height, (int)priv->ysize);
+
+	x = max(x, 0);
+	y = max(y, 0);
+	if (x >= xend || y >= yend)
+		return;
+
+	if (priv->damage.xend <= priv->damage.xstart) {
+		priv->damage.xstart = x;
+		priv->damage.ystart = y;
+		priv->damage.xend = xend;
+		priv->damage.yend = yend;
+	} else {
+		priv->damage.xstart = min(priv->damage.xstart, x);
+		priv->damage.ystart = min(priv->damage.ystart, y);
+		priv->damage.xend = max(priv->damage.xend, xend);
+		priv->damage.yend = max(priv->damage.yend, yend);
+	}
+}
+#endif
+
+#if defined(CONFIG_ARM) && !CONFIG_IS_ENABLED(SYS_DCACHE_OFF)
+/* Flush the changed part of the frame buffer out of the data cache */
+static void video_flush_dcache(struct video_priv *priv)
+{
+	ulong fb = (ulong)priv->fb;
+#ifdef CONFIG_VIDEO_DAMAGE
+	ulong line, start, end;
+	int y;
+
+	if (priv->damage.xend <= priv->damage.xstart)
+		return;
+
+	line = fb + priv->damage.ystart * priv->line_length;
+	if (!priv->damage.xstart && priv->damage.xend == priv->xsize) {
+		/* Whole lines are contiguous so can be flushed in one go */
+		end = fb + priv->damage.yend * priv->line_length;
+		flush_dcache_range(ALIGN_DOWN(line, CONFIG_SYS_CACHELINE_SIZE),
+				   ALIGN(end, CONFIG_SYS_CACHELINE_SIZE));
+		return;
+	}
+
+	for (y = priv->damage.ystart; y < priv->damage.yend; y++) {
+		start = line + priv->damage.xstart * VNBITS(priv->bpix) / 8;
+		end = line + DIV_ROUND_UP(priv->damage.xend *
+					  VNBITS(priv->bpix), 8);
+		flush_dcache_range(ALIGN_DOWN(start, CONFIG_SYS_CACHELINE_SIZE),
+				   ALIGN(end, CONFIG_SYS_CACHELINE_SIZE));
+		line += priv->line_length;
+	}
+#else
+	flush_dcache_range(fb, ALIGN(fb + priv->fb_size,
+				     CONFIG_SYS_CACHELINE_SIZE));
+#endif
+}
+#endif
+
 /* Flush video activity to the caches */
 int video_sync(struct udevice *vid, bool force)
 {
+	struct video_priv *priv __maybe_unused = dev_get_uclass_priv(vid);
 	struct video_ops *ops = video_get_ops(vid);
 	int ret;
 
@@ -191,22 +255,26 @@ int video_sync(struct udevice *vid, bool force)
 	 * out whether it exists? For now, ARM is safe.
 	 */
 #if defined(CONFIG_ARM) && !CONFIG_IS_ENABLED(SYS_DCACHE_OFF)
-	struct video_priv *priv = dev_get_uclass_priv(vid);
-
-	if (priv->flush_dcache) {
-		flush_dcache_range((ulong)priv->fb,
-				   ALIGN((ulong)priv->fb + priv->fb_size,
-					 CONFIG_SYS_CACHELINE_SIZE));
-	}
+	if (priv->flush_dcache)
+		video_flush_dcache(priv);
 #elif defined(CONFIG_VIDEO_SANDBOX_SDL)
-	struct video_priv *priv = dev_get_uclass_priv(vid);
 	static ulong last_sync;
 
-	if (force || get_timer(last_sync) > 10) {
-		sandbox_sdl_sync(priv->fb);
-		last_sync = get_timer(0);
-	}
+	/* Keep collecting damage until the display is actually updated */
+	if (!force && get_timer(last_sync) <= 10)
+		return 0;
+#ifdef CONFIG_VIDEO_DAMAGE
+	sandbox_sdl_sync(priv->fb, priv->damage.xstart, priv->damage.ystart,
+			 priv->damage.xend, priv->damage.yend);
+#else
+	sandbox_sdl_sync(priv->fb, 0, 0, priv->xsize, priv->ysize);
 #endif
+	last_sync = get_timer(0);
+#endif
+#ifdef CONFIG_VIDEO_DAMAGE
+	memset(&priv->damage, '\0', sizeof(priv->damage));
+#endif
+
 	return 0;
 }
 
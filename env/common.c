@@ -241,6 +241,10 @@ int env_export(env_t *env_out)
 		return 1;
 	}
 
+	/* Without room for an index, the environment is still usable */
+	if (CONFIG_IS_ENABLED(ENV_INDEX) && env_index_add(env_out->data))
+		debug("%s: Environment saved without an index\n", __func__);
+
 	env_out->crc = crc32(0, env_out->data, ENV_SIZE);
 
 #ifdef CONFIG_SYS_REDUNDAND_ENVIRONMENT
@@ -0,0 +1,189 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Index of a sorted environment, for finding variables before relocation
+ */
+
+#include <common.h>
+#include <env.h>
+#include <env_internal.h>
+#include <asm/global_data.h>
+#include <linux/errno.h>
+#include <u-boot/crc.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Compare the names of two name=value strings, as strcmp() would */
+static int env_index_cmp(const char *a, const char *b)
+{
+	int ca, cb;
+
+	for (;; a++, b++) {
+		ca = *a == '=' ? 0 : (uchar)*a;
+		cb = *b == '=' ? 0 : (uchar)*b;
+		if (ca != cb || !ca)
+			return ca - cb;
+	}
+}
+
+int env_index_add(unsigned char *data)
+{
+	struct env_index idx;
+	const char *prev = NULL;
+	uint32_t offset;
+	int count, pos, i;
+
+	/* Count the variables, checking that they are in order */
+	count = 0;
+	for (pos = 0; data[pos]; pos += strlen((char *)data + pos) + 1) {
+		if (prev && env_index_cmp(prev, (char *)data + pos) >= 0)
+			return -EINVAL;
+		prev = (char *)data + pos;
+		count++;
+	}
+	idx.size = pos + 1;
+	if (idx.size + ENV_INDEX_SIZE(count) > ENV_SIZE)
+		return -ENOSPC;
+
+	pos = ENV_SIZE - ENV_INDEX_SIZE(count);
+	for (i = 0, offset = 0; i < count; i++, pos += sizeof(offset)) {
+		memcpy(data + pos, &offset, sizeof(offset));
+		offset += strlen((char *)data + offset) + 1;
+	}
+	idx.crc = crc32(0, data, idx.size);
+	idx.count = count;
+	idx.magic = ENV_INDEX_MAGIC;
+	memcpy(data + pos, &idx, sizeof(idx));
+
+	return 0;
+}
+
+/* Read a 32-bit word from the early environment */
+static int env_index_read(int pos, uint32_t *valp)
+{
+	uchar *p = (uchar *)valp;
+	int i, c;
+
+	for (i = 0; i < sizeof(*valp); i++) {
+		c = env_get_char(pos + i);
+		if (c < 0)
+			return c;
+		p[i] = c;
+	}
+
+	return 0;
+}
+
+/**
+ * env_index_get() - read the index trailer of the early environment
+ *
+ * The environment does not change before relocation, so the CRC of the text
+ * is only checked the first time an index is seen at a particular address.
+ * The default environment is shorter than ENV_SIZE and never has an index.
+ *
+ * @idx: returns the trailer
+ * Return: 0 if OK, -ENODATA if there is no index, -EINVAL if it is not valid,
+ * other -ve on read error
+ */
+static int env_index_get(struct env_index *idx)
+{
+	uint32_t *word = (uint32_t *)idx;
+	uchar buf[32];
+	uint32_t crc;
+	int pos, i, n, c, ret;
+
+	if (gd->env_valid == ENV_INVALID ||
+	    gd->env_addr == (ulong)default_environment)
+		return -ENODATA;
+	pos = ENV_SIZE - sizeof(*idx);
+	for (i = 0; i < sizeof(*idx) / sizeof(*word); i++) {
+		ret = env_index_read(pos + i * sizeof(*word), &word[i]);
+		if (ret)
+			return ret;
+	}
+	if (idx->magic != ENV_INDEX_MAGIC)
+		return -ENODATA;
+	if (idx->size < 1 || idx->count > ENV_SIZE / sizeof(uint32_t) ||
+	    idx->size + ENV_INDEX_SIZE(idx->count) > ENV_SIZE)
+		return -EINVAL;
+	if (gd->env_index_addr == gd->env_addr && gd->env_index_crc == idx->crc)
+		return 0;
+
+	for (crc = 0, pos = 0; pos < idx->size; pos += n) {
+		n = min_t(int, idx->size - pos, sizeof(buf));
+		for (i = 0; i < n; i++) {
+			c = env_get_char(pos + i);
+			if (c < 0)
+				return c;
+			buf[i] = c;
+		}
+		crc = crc32(crc, buf, n);
+	}
+	if (crc != idx->crc)
+		return -EINVAL;
+	gd->env_index_addr = gd->env_addr;
+	gd->env_index_crc = crc;
+
+	return 0;
+}
+
+/**
+ * env_index_match() - compare a name with a variable in the early environment
+ *
+ * @name: name to look for
+ * @pos: offset of the name=value string
+ * @cmpp: returns <0, 0 or >0 as @name sorts before, equal to or after the
+ *	variable
+ * @valp: returns offset of the value, or -1 if the string has no '='
+ * Return: 0 if OK, -ve on read error
+ */
+static int env_index_match(const char *name, int pos, int *cmpp, int *valp)
+{
+	int c;
+
+	for (;; name++, pos++) {
+		c = env_get_char(pos);
+		if (c < 0)
+			return c;
+		*valp = c == '=' ? pos + 1 : -1;
+		if (c == '=')
+			c = 0;
+		*cmpp = (uchar)*name - c;
+		if (*cmpp || !c)
+			return 0;
+	}
+}
+
+int env_index_find(const char *name)
+{
+	struct env_index idx;
+	uint32_t offset;
+	int lo, hi, mid, base;
+	int cmp, val, ret;
+
+	ret = env_index_get(&idx);
+	if (ret)
+		return ret;
+
+	base = ENV_SIZE - ENV_INDEX_SIZE(idx.count);
+	lo = 0;
+	hi = idx.count;
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		ret = env_index_read(base + mid * sizeof(offset), &offset);
+		if (ret)
+			return ret;
+		if (offset >= idx.size)
+			return -EINVAL;
+		ret = env_index_match(name, offset, &cmp, &val);
+		if (ret)
+			return ret;
+		if (!cmp)
+			return val < 0 ? -ENOENT : val;
+		if (cmp < 0)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	return -ENOENT;
+}
@@ -1375,6 +1375,122 @@ void fat_closedir(struct fs_dir_stream *dirs)
 	free(dir);
 }
 
+typedef struct {
+	struct fs_file_stream parent;
+	struct blk_desc *dev;
+	struct disk_partition part_info;
+	fsdata fsdata;
+	dir_entry dent;
+	__u32 clust;		/* cluster holding byte 'clust_pos' of the file */
+	loff_t clust_pos;	/* file offset of the start of 'clust' */
+} fat_file;
+
+int fat_openfile(const char *filename, struct fs_file_stream **filep)
+{
+	fat_file *file;
+	fat_itr *itr;
+	fsdata *mydata;
+	int ret;
+
+	itr = malloc_cache_aligned(sizeof(fat_itr));
+	if (!itr)
+		return -ENOMEM;
+	file = malloc_cache_aligned(sizeof(*file));
+	if (!file) {
+		ret = -ENOMEM;
+		goto out_free_itr;
+	}
+	memset(file, 0, sizeof(*file));
+	mydata = &file->fsdata;
+
+	ret = fat_itr_root(itr, mydata);
+	if (ret)
+		goto fail_free_file;
+
+	ret = fat_itr_resolve(itr, filename, TYPE_FILE);
+	if (ret)
+		goto fail_free_both;
+
+	file->dev = cur_dev;
+	file->part_info = cur_part_info;
+	file->dent = *itr->dent;
+	file->clust = START(&file->dent);
+	file->parent.size = FAT2CPU32(file->dent.size);
+
+	*filep = (struct fs_file_stream *)file;
+	free(itr);
+	return 0;
+
+fail_free_both:
+	free(mydata->fatbuf);
+fail_free_file:
+	free(file);
+out_free_itr:
+	free(itr);
+	return ret;
+}
+
+int fat_readfile(struct fs_file_stream *stream, void *buf, loff_t offset,
+		 loff_t len, loff_t *actread)
+{
+	fat_file *file = (fat_file *)stream;
+	fsdata *mydata = &file->fsdata;
+	unsigned int bytesperclust = mydata->clust_size * mydata->sect_size;
+	loff_t size = file->parent.size;
+	dir_entry dent;
+	__u32 next;
+	loff_t end;
+	int ret;
+
+	/* The file was resolved on this device, no need to probe it again */
+	cur_dev = file->dev;
+	cur_part_info = file->part_info;
+
+	/* The cluster chain can only be followed forwards */
+	if (offset < file->clust_pos) {
+		file->clust = START(&file->dent);
+		file->clust_pos = 0;
+	}
+
+	/*
+	 * Present the rest of the chain, from the cluster reached by the
+	 * previous read, as a file of its own. This way a sequential read
+	 * does not have to walk the chain from the start of the file.
+	 */
+	dent = file->dent;
+	dent.start = cpu_to_le16(file->clust & 0xffff);
+	dent.starthi = cpu_to_le16(file->clust >> 16);
+	dent.size = cpu_to_le32(size - file->clust_pos);
+
+	ret = get_contents(mydata, &dent, offset - file->clust_pos, buf, len,
+			   actread);
+	if (ret)
+		return ret;
+
+	/* Move to the cluster holding the end of what was read */
+	end = offset + *actread;
+	while (end < size && end - file->clust_pos >= bytesperclust) {
+		next = get_fatent(mydata, file->clust);
+		if (CHECK_CLUST(next, mydata->fatsize)) {
+			file->clust = START(&file->dent);
+			file->clust_pos = 0;
+			break;
+		}
+		file->clust = next;
+		file->clust_pos += bytesperclust;
+	}
+
+	return 0;
+}
+
+void fat_closefile(struct fs_file_stream *stream)
+{
+	fat_file *file = (fat_file *)stream;
+
+	free(file->fsdata.fatbuf);
+	free(file);
+}
+
 void fat_close(void)
 {
 }
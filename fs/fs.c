@@ -33,6 +33,8 @@ static struct blk_desc *fs_dev_desc;
 static int fs_dev_part;
 static struct disk_partition fs_partition;
 static int fs_type = FS_TYPE_ANY;
+/* Bumped on every modification, to invalidate open file streams */
+static unsigned int fs_gen;
 
 static inline int fs_probe_unsupported(struct blk_desc *fs_dev_desc,
 				      struct disk_partition *fs_partition)
@@ -169,6 +171,17 @@ struct fstype_info {
 	int (*readdir)(struct fs_dir_stream *dirs, struct fs_dirent **dentp);
 	/* see fs_closedir() */
 	void (*closedir)(struct fs_dir_stream *dirs);
+	/*
+	 * Open a file for reading.  On success return 0 and file stream
+	 * pointer via 'filep'.  On error, return -errno.  Optional, see
+	 * fs_openfile().
+	 */
+	int (*openfile)(const char *filename, struct fs_file_stream **filep);
+	/* see fs_readfile() */
+	int (*readfile)(struct fs_file_stream *file, void *buf, loff_t offset,
+			loff_t len, loff_t *actread);
+	/* see fs_closefile() */
+	void (*closefile)(struct fs_file_stream *file);
 	int (*unlink)(const char *filename);
 	int (*mkdir)(const char *dirname);
 	int (*ln)(const char *filename, const char *target);
@@ -199,6 +212,9 @@ static struct fstype_info fstypes[] = {
 		.opendir = fat_opendir,
 		.readdir = fat_readdir,
 		.closedir = fat_closedir,
+		.openfile = fat_openfile,
+		.readfile = fat_readfile,
+		.closefile = fat_closefile,
 		.ln = fs_ln_unsupported,
 	},
 #endif
@@ -570,6 +586,7 @@ int fs_write(const char *filename, ulong addr, loff_t offset, loff_t len,
 	buf = map_sysmem(addr, len);
 	ret = info->write(filename, buf, offset, len, actwrite);
 	unmap_sysmem(buf);
+	fs_gen++;
 
 	if (ret < 0 && len != *actwrite) {
 		log_err("** Unable to write file %s **\n", filename);
@@ -632,6 +649,53 @@ void fs_closedir(struct fs_dir_stream *dirs)
 	fs_close();
 }
 
+struct fs_file_stream *fs_openfile(const char *filename)
+{
+	struct fstype_info *info = fs_get_info(fs_type);
+	struct fs_file_stream *file = NULL;
+	int ret = -ENOSYS;
+
+	if (info->openfile)
+		ret = info->openfile(filename, &file);
+	fs_close();
+	if (ret) {
+		errno = -ret;
+		return NULL;
+	}
+
+	file->fstype = info->fstype;
+	file->gen = fs_gen;
+	file->desc = fs_dev_desc;
+	if (fs_dev_desc)
+		file->write_gen = fs_dev_desc->write_gen;
+
+	return file;
+}
+
+int fs_readfile(struct fs_file_stream *file, void *buf, loff_t offset,
+		loff_t len, loff_t *actread)
+{
+	struct fstype_info *info = fs_get_info(file->fstype);
+
+	/* Raw writes to the device, e.g. from 'mmc write' or ums, count too */
+	if (file->gen != fs_gen ||
+	    (file->desc && file->desc->write_gen != file->write_gen))
+		return -ESTALE;
+
+	return info->readfile(file, buf, offset, len, actread);
+}
+
+void fs_closefile(struct fs_file_stream *file)
+{
+	struct fstype_info *info;
+
+	if (!file)
+		return;
+
+	info = fs_get_info(file->fstype);
+	info->closefile(file);
+}
+
 int fs_unlink(const char *filename)
 {
 	int ret;
@@ -639,6 +703,7 @@ int fs_unlink(const char *filename)
 	struct fstype_info *info = fs_get_info(fs_type);
 
 	ret = info->unlink(filename);
+	fs_gen++;
 
 	fs_close();
 
@@ -652,6 +717,7 @@ int fs_mkdir(const char *dirname)
 	struct fstype_info *info = fs_get_info(fs_type);
 
 	ret = info->mkdir(dirname);
+	fs_gen++;
 
 	fs_close();
 
@@ -664,6 +730,7 @@ int fs_ln(const char *fname, const char *target)
 	int ret;
 
 	ret = info->ln(fname, target);
+	fs_gen++;
 
 	if (ret < 0) {
 		log_err("** Unable to create link %s -> %s **\n", fname, target);
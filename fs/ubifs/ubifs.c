@@ -672,25 +672,13 @@ static inline void *kmap(struct page *page)
 	return page->addr;
 }
 
-static int read_block(struct inode *inode, void *addr, unsigned int block,
-		      struct ubifs_data_node *dn)
+static int decompress_block(struct ubifs_info *c, void *addr,
+			    struct ubifs_data_node *dn, unsigned int block,
+			    struct inode *inode)
 {
-	struct ubifs_info *c = inode->i_sb->s_fs_info;
 	int err, len, out_len;
-	union ubifs_key key;
 	unsigned int dlen;
 
-	data_key_init(c, &key, inode->i_ino, block);
-	err = ubifs_tnc_lookup(c, &key, dn);
-	if (err) {
-		if (err == -ENOENT)
-			/* Not found, so it must be a hole */
-			memset(addr, 0, UBIFS_BLOCK_SIZE);
-		return err;
-	}
-
-	ubifs_assert(le64_to_cpu(dn->ch.sqnum) > ubifs_inode(inode)->creat_sqnum);
-
 	len = le32_to_cpu(dn->size);
 	if (len <= 0 || len > UBIFS_BLOCK_SIZE)
 		goto dump;
@@ -719,6 +707,84 @@ dump:
 	return -EINVAL;
 }
 
+static int read_block(struct inode *inode, void *addr, unsigned int block,
+		      struct ubifs_data_node *dn)
+{
+	struct ubifs_info *c = inode->i_sb->s_fs_info;
+	union ubifs_key key;
+	int err;
+
+	data_key_init(c, &key, inode->i_ino, block);
+	err = ubifs_tnc_lookup(c, &key, dn);
+	if (err) {
+		if (err == -ENOENT)
+			/* Not found, so it must be a hole */
+			memset(addr, 0, UBIFS_BLOCK_SIZE);
+		return err;
+	}
+
+	ubifs_assert(le64_to_cpu(dn->ch.sqnum) > ubifs_inode(inode)->creat_sqnum);
+
+	return decompress_block(c, addr, dn, block, inode);
+}
+
+/**
+ * read_bulk - read a run of blocks with a single LEB read
+ * @c: UBIFS file-system description object
+ * @inode: inode to read from
+ * @addr: buffer for the first block
+ * @block: first block to read
+ * @count: maximum number of blocks to read
+ * @bu: bulk-read information, with @bu->buf and @bu->buf_len set up
+ *
+ * This looks up the data nodes of @block and the blocks after it which sit
+ * next to each other in the same LEB, reads them all in one go and then
+ * decompresses them in order. Holes between the nodes are zeroed.
+ *
+ * Return: number of blocks read, 0 if there is no data node to bulk-read, or
+ * a negative error code
+ */
+static int read_bulk(struct ubifs_info *c, struct inode *inode, void *addr,
+		     unsigned int block, unsigned int count, struct bu_info *bu)
+{
+	unsigned int next = block;
+	void *buf;
+	int err, i;
+
+	data_key_init(c, &bu->key, inode->i_ino, block);
+	err = ubifs_tnc_get_bu_keys(c, bu);
+	if (err)
+		return err;
+
+	/* Drop the nodes beyond the requested blocks */
+	while (bu->cnt &&
+	       key_block(c, &bu->zbranch[bu->cnt - 1].key) >= block + count)
+		bu->cnt--;
+	if (!bu->cnt)
+		return 0;
+
+	err = ubifs_tnc_bulk_read(c, bu);
+	if (err)
+		return err == -EAGAIN ? 0 : err;
+
+	buf = bu->buf;
+	for (i = 0; i < bu->cnt; i++) {
+		unsigned int n = key_block(c, &bu->zbranch[i].key);
+
+		/* Anything skipped must be a hole */
+		memset(addr + (next - block) * UBIFS_BLOCK_SIZE, 0,
+		       (n - next) * UBIFS_BLOCK_SIZE);
+		err = decompress_block(c, addr + (n - block) * UBIFS_BLOCK_SIZE,
+				       buf, n, inode);
+		if (err)
+			return err;
+		buf += ALIGN(bu->zbranch[i].len, 8);
+		next = n + 1;
+	}
+
+	return next - block;
+}
+
 static int do_readpage(struct ubifs_info *c, struct inode *inode,
 		       struct page *page, int last_block_size)
 {
@@ -837,6 +903,7 @@ int ubifs_read(const char *filename, void *buf, loff_t offset,
 	unsigned long inum;
 	struct inode *inode;
 	struct page page;
+	struct bu_info *bu;
 	int err = 0;
 	int i;
 	int count;
@@ -885,10 +952,45 @@ int ubifs_read(const char *filename, void *buf, loff_t offset,
 
 	count = (size + UBIFS_BLOCK_SIZE - 1) >> UBIFS_BLOCK_SHIFT;
 
+	/* Without memory for bulk-reads, fall back to a block at a time */
+	bu = malloc(sizeof(*bu));
+	if (bu) {
+		bu->buf_len = c->max_bu_buf_len;
+		bu->buf = malloc(bu->buf_len);
+		if (!bu->buf) {
+			free(bu);
+			bu = NULL;
+		}
+	}
+
 	page.addr = buf;
 	page.index = offset / PAGE_SIZE;
 	page.inode = inode;
 	for (i = 0; i < count; i++) {
+		/*
+		 * Read all but the last page in bulk where the data nodes
+		 * allow it, so that they only need one LEB read
+		 */
+		if (bu && i + 1 < count) {
+			int n;
+
+			n = read_bulk(c, inode, page.addr,
+				      page.index << UBIFS_BLOCKS_PER_PAGE_SHIFT,
+				      (count - i - 1) <<
+				      UBIFS_BLOCKS_PER_PAGE_SHIFT, bu);
+			if (n < 0) {
+				err = n;
+				break;
+			}
+			n >>= UBIFS_BLOCKS_PER_PAGE_SHIFT;
+			if (n) {
+				page.addr += n * PAGE_SIZE;
+				page.index += n;
+				i += n - 1;
+				continue;
+			}
+		}
+
 		/*
 		 * Make sure to not read beyond the requested size
 		 */
@@ -902,6 +1004,10 @@ int ubifs_read(const char *filename, void *buf, loff_t offset,
 		page.addr += PAGE_SIZE;
 		page.index++;
 	}
+	if (bu) {
+		free(bu->buf);
+		free(bu);
+	}
 
 	if (err) {
 		printf("Error reading file '%s'\n", filename);
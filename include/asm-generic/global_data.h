@@ -262,6 +262,16 @@ struct global_data {
 	 * @env_buf: buffer for env_get() before reloc
 	 */
 	char env_buf[32];
+#if CONFIG_IS_ENABLED(ENV_INDEX)
+	/**
+	 * @env_index_addr: value of @env_addr when the index was checked
+	 */
+	unsigned long env_index_addr;
+	/**
+	 * @env_index_crc: text CRC of the last index found to be valid
+	 */
+	unsigned int env_index_crc;
+#endif
 #ifdef CONFIG_TRACE
 	/**
 	 * @trace_buff: trace buffer
@@ -86,6 +86,7 @@ struct blk_desc {
 		uint32_t mbr_sig;	/* MBR integer signature */
 		efi_guid_t guid_sig;	/* GPT GUID Signature */
 	};
+	unsigned int	write_gen;	/* bumped by every write or erase */
 #if CONFIG_IS_ENABLED(BLK)
 	/*
 	 * For now we have a few functions which take struct blk_desc as a
@@ -457,6 +458,7 @@ static inline ulong blk_dwrite(struct blk_desc *block_dev, lbaint_t start,
 			       lbaint_t blkcnt, const void *buffer)
 {
 	blkcache_invalidate(block_dev->if_type, block_dev->devnum);
+	block_dev->write_gen++;
 	return block_dev->block_write(block_dev, start, blkcnt, buffer);
 }
 
@@ -464,6 +466,7 @@ static inline ulong blk_derase(struct blk_desc *block_dev, lbaint_t start,
 			       lbaint_t blkcnt)
 {
 	blkcache_invalidate(block_dev->if_type, block_dev->devnum);
+	block_dev->write_gen++;
 	return block_dev->block_erase(block_dev, start, blkcnt);
 }
 
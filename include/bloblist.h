@@ -38,6 +38,9 @@ enum bloblist_tag_t {
 	BLOBLISTT_TCPA_LOG,		/* TPM log space */
 	BLOBLISTT_ACPI_TABLES,		/* ACPI tables for x86 */
 	BLOBLISTT_SMBIOS_TABLES,	/* SMBIOS tables for x86 */
+	BLOBLISTT_UBI_ATTACH,		/* UBI attach snapshot from ubispl */
+	BLOBLISTT_PCI_ENUM,		/* PCI functions found by bus scans */
+	BLOBLISTT_NAND_BBT,		/* Bad blocks found by SPL NAND loaders */
 
 	BLOBLISTT_COUNT
 };
@@ -80,6 +80,9 @@ struct driver_info;
  */
 #define DM_FLAG_VITAL			(1 << 14)
 
+/* Device priv, uclass_priv and parent_priv share one allocation */
+#define DM_FLAG_ALLOC_PRIV_COMBINED	(1 << 15)
+
 /*
  * One or multiple of these flags are passed to device_remove() so that
  * a selective device removal as specified by the remove-stage and the
@@ -165,6 +165,8 @@ extern const efi_guid_t efi_guid_host_dev;
 #endif
 /* GUID of the EFI_BLOCK_IO_PROTOCOL */
 extern const efi_guid_t efi_block_io_guid;
+/* GUID of the EFI_BLOCK_IO2_PROTOCOL */
+extern const efi_guid_t efi_block_io2_guid;
 extern const efi_guid_t efi_global_variable_guid;
 extern const efi_guid_t efi_guid_console_control;
 extern const efi_guid_t efi_guid_device_path;
@@ -430,6 +432,8 @@ int efi_disk_create_partitions(efi_handle_t parent, struct blk_desc *desc,
 			       const char *pdevname);
 /* Check if it is EFI system partition */
 bool efi_disk_is_system_part(efi_handle_t handle);
+/* Called by efi_timer_check() to advance non-blocking disk transfers */
+void efi_disk_process_requests(void);
 /* Called by bootefi to make GOP (graphical) interface available */
 efi_status_t efi_gop_register(void);
 /* Called by bootefi to make the network interface available */
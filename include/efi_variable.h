@@ -133,6 +133,30 @@ struct efi_var_file {
 	struct efi_var_entry var[];
 };
 
+/*
+ * This constant identifies a record appended to the variable file, see
+ * struct efi_var_journal.
+ */
+#define EFI_VAR_JOURNAL_MAGIC 0x6c6e724a /* Jrnl */
+
+/**
+ * struct efi_var_journal - record appended to the file for storing variables
+ *
+ * Changes of single variables are appended to the file behind the
+ * struct efi_var_file snapshot. When reading the file they are applied in
+ * order on top of the snapshot.
+ *
+ * @magic:	identifies a record, takes value %EFI_VAR_JOURNAL_MAGIC
+ * @crc32:	CRC32 of @var, including the name, the data and the padding
+ *		to a multiple of 8 bytes
+ * @var:	new value of the variable, a length of 0 deletes the variable
+ */
+struct efi_var_journal {
+	u32 magic;
+	u32 crc32;
+	struct efi_var_entry var[];
+};
+
 /**
  * efi_var_to_file() - save non-volatile variables as file
  *
@@ -142,6 +166,22 @@ struct efi_var_file {
  */
 efi_status_t efi_var_to_file(void);
 
+/**
+ * efi_var_append_to_file() - save a changed non-volatile variable
+ *
+ * With CONFIG_EFI_VARIABLE_FILE_JOURNAL a struct efi_var_journal record with
+ * the current value of the variable is appended to file ubootefi.var. The
+ * whole file is rewritten instead if that option is disabled, if the state
+ * of the file is not known or if the record would not fit into
+ * %EFI_VAR_BUF_SIZE.
+ *
+ * @variable_name:	name of the variable
+ * @vendor:		vendor GUID
+ * Return:		status code
+ */
+efi_status_t efi_var_append_to_file(u16 *variable_name,
+				    const efi_guid_t *vendor);
+
 /**
  * efi_var_collect() - collect variables in buffer
  *
@@ -107,6 +107,27 @@ typedef struct environment_s {
 	unsigned char	data[ENV_SIZE]; /* Environment data		*/
 } env_t;
 
+/*
+ * The environment data may end with an index of its variables. The text is
+ * sorted by name and the index gives the offset of each name=value string, in
+ * the same order, so that a variable can be found with a binary search before
+ * relocation. The offsets come just before this trailer, which uses the last
+ * bytes of the data. All fields are in the byte order of the target. Code
+ * which does not know about the index ignores it, since it comes after the
+ * end of the text.
+ */
+#define ENV_INDEX_MAGIC		0x58444e45	/* "ENDX" */
+
+struct env_index {
+	uint32_t	crc;		/* CRC32 over the text		*/
+	uint32_t	size;		/* size of text, with final '\0's */
+	uint32_t	count;		/* number of offsets		*/
+	uint32_t	magic;		/* ENV_INDEX_MAGIC		*/
+};
+
+#define ENV_INDEX_SIZE(count) \
+	(sizeof(struct env_index) + (count) * sizeof(uint32_t))
+
 #ifdef ENV_IS_EMBEDDED
 extern env_t embedded_environment;
 #endif /* ENV_IS_EMBEDDED */
@@ -245,6 +266,27 @@ const char *env_ext4_get_dev_part(void);
  * @return  an enum env_location value on success, or -ve error code.
  */
 enum env_location env_get_location(enum env_operation op, int prio);
+
+/**
+ * env_index_add() - Add an index to exported environment data
+ *
+ * @data: environment data holding sorted text, with the rest zeroed
+ * @return 0 if OK, -EINVAL if the text is not sorted, -ENOSPC if there is
+ *	no room for the index
+ */
+int env_index_add(unsigned char *data);
+
+/**
+ * env_index_find() - Find a variable in the early environment using its index
+ *
+ * The index is only used if its CRC matches the text, so that an index left
+ * behind by a tool which changed the text is ignored.
+ *
+ * @name: name of variable
+ * @return offset of the value in the environment data, -ENOENT if there is
+ *	no such variable, or other -ve error if the index cannot be used
+ */
+int env_index_find(const char *name);
 #endif /* DO_DEPS_ONLY */
 
 #endif /* _ENV_INTERNAL_H_ */
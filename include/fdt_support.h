@@ -119,6 +119,8 @@ static inline int fdt_fixup_memory_banks(void *blob, u64 start[], u64 size[],
 #endif
 
 void fdt_fixup_ethernet(void *fdt);
+int fdt_update_prop(void *fdt, int nodeoffset, const char *name,
+		    const void *val, int len);
 int fdt_find_and_setprop(void *fdt, const char *node, const char *prop,
 			 const void *val, int len, int create);
 void fdt_fixup_qe_firmware(void *fdt);
@@ -342,6 +344,42 @@ int fdt_setup_simplefb_node(void *fdt, int node, u64 base_address, u32 width,
 
 int fdt_overlay_apply_verbose(void *fdt, void *fdto);
 
+/**
+ * fdt_overlay_index_alloc() - Set up an index for applying several overlays
+ *
+ * This allocates and fills in a phandle index for the base device tree, so
+ * that fdt_overlay_apply_index_verbose() need not walk the whole tree for
+ * each overlay. If there is not enough memory, the index is set up without
+ * a phandle table, which is slower but still works.
+ *
+ * @fdt: Base device tree
+ * @idx: Returns the index, which must be freed with fdt_overlay_index_free()
+ * @return 0 if OK, -ve FDT_ERR_... on error
+ */
+int fdt_overlay_index_alloc(const void *fdt, struct fdt_overlay_index *idx);
+
+/**
+ * fdt_overlay_index_free() - Free an index set up by fdt_overlay_index_alloc()
+ *
+ * @idx: Index to free
+ */
+void fdt_overlay_index_free(struct fdt_overlay_index *idx);
+
+/**
+ * fdt_overlay_apply_index_verbose() - Apply an overlay using an index
+ *
+ * This is the same as fdt_overlay_apply_verbose() but uses and updates @idx.
+ * Between calls the base tree may be moved or resized, e.g. with
+ * fdt_shrink_to_minimum(), but not otherwise changed.
+ *
+ * @fdt: Base device tree
+ * @fdto: Overlay to apply
+ * @idx: Index from fdt_overlay_index_alloc(), or NULL
+ * @return 0 if OK, -ve FDT_ERR_... on error
+ */
+int fdt_overlay_apply_index_verbose(void *fdt, void *fdto,
+				    struct fdt_overlay_index *idx);
+
 /**
  * fdt_get_cells_len() - Get the length of a type of cell in top-level nodes
  *
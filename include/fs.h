@@ -208,6 +208,59 @@ struct fs_dirent *fs_readdir(struct fs_dir_stream *dirs);
  */
 void fs_closedir(struct fs_dir_stream *dirs);
 
+/*
+ * Note: apart from 'size', fs_file_stream should be treated as opaque to
+ * the user of fs layer
+ */
+struct fs_file_stream {
+	/* private to fs. layer: */
+	int fstype;
+	unsigned int gen;
+	struct blk_desc *desc;
+	unsigned int write_gen;
+	/* size of the file in bytes */
+	loff_t size;
+};
+
+/*
+ * fs_openfile - Open a file for repeated reads
+ *
+ * The path is resolved once and the filesystem keeps whatever it needs to
+ * locate the file data, so that subsequent fs_readfile() calls neither
+ * probe the filesystem again nor walk the path.
+ *
+ * @filename: the path to the file to open
+ * @return a pointer to the file stream or NULL on error and errno set
+ *    appropriately. errno is ENOSYS if the filesystem does not support
+ *    file streams, in which case fs_read() must be used instead.
+ */
+struct fs_file_stream *fs_openfile(const char *filename);
+
+/*
+ * fs_readfile - Read from a file stream
+ *
+ * Reading sequentially is cheap, filesystems may keep a cursor to the
+ * location of the end of the previous read.
+ *
+ * @file: the file stream
+ * @buf: buffer to read into
+ * @offset: offset in the file from where to start reading
+ * @len: the number of bytes to read
+ * @actread: returns the actual number of bytes read
+ * @return 0 if ok, -ESTALE if the filesystem or its block device has been
+ *    written to since the stream was opened (close it and open it again),
+ *    other -ve on error
+ */
+int fs_readfile(struct fs_file_stream *file, void *buf, loff_t offset,
+		loff_t len, loff_t *actread);
+
+/*
+ * fs_closefile - close a file stream
+ *
+ * @file: the file stream, may be NULL
+ */
+void fs_closefile(struct fs_file_stream *file);
+
 /*
  * fs_unlink - delete a file or directory
  *
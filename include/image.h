@@ -1031,6 +1031,9 @@ int booti_setup(ulong image, ulong *relocated_addr, ulong *size,
 #define FIT_FIRMWARE_PROP	"firmware"
 #define FIT_STANDALONE_PROP	"standalone"
 
+/* configurations node */
+#define FIT_COMPAT_INDEX_PROP	"compatible-index"
+
 #define FIT_MAX_HASH_LEN	HASH_MAX_DIGEST_SIZE
 
 #if IMAGE_ENABLE_FIT
@@ -1165,6 +1168,22 @@ int fit_check_format(const void *fit, ulong size);
 
 int fit_conf_find_compat(const void *fit, const void *fdt);
 
+/**
+ * fit_conf_get_compat_node() - Find the compatible strings of a configuration
+ *
+ * A configuration's compatible strings are taken from its own 'compatible'
+ * property if it has one, otherwise from the root node of its (uncompressed)
+ * FDT image.
+ *
+ * @fit: FIT to check
+ * @noffset: Offset of the configuration node
+ * @fdtp: Returns the device tree holding the 'compatible' property, i.e.
+ *	either @fit or the configuration's FDT
+ * @return offset of the node in *@fdtp holding the property, or -ENOENT if
+ *	the configuration has no usable compatible strings
+ */
+int fit_conf_get_compat_node(const void *fit, int noffset, const void **fdtp);
+
 /**
  * fit_conf_get_node - get node offset for configuration of a given unit name
  * @fit: pointer to the FIT format image header
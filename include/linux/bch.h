@@ -26,6 +26,7 @@
  * @a_pow_tab:  Galois field GF(2^m) exponentiation lookup table
  * @a_log_tab:  Galois field GF(2^m) log lookup table
  * @mod8_tab:   remainder generator polynomial lookup tables
+ * @syn_tab:    syndrome byte evaluation lookup tables
  * @ecc_buf:    ecc parity words buffer
  * @ecc_buf2:   ecc parity words buffer
  * @xi_tab:     GF(2^m) base for solving degree 2 polynomial roots
@@ -44,6 +45,7 @@ struct bch_control {
 	uint16_t       *a_pow_tab;
 	uint16_t       *a_log_tab;
 	uint32_t       *mod8_tab;
+	uint16_t       *syn_tab;
 	uint32_t       *ecc_buf;
 	uint32_t       *ecc_buf2;
 	unsigned int   *xi_tab;
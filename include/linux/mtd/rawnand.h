@@ -102,6 +102,8 @@ void nand_wait_ready(struct mtd_info *mtd);
 #define NAND_CMD_READSTART	0x30
 #define NAND_CMD_RNDOUTSTART	0xE0
 #define NAND_CMD_CACHEDPROG	0x15
+#define NAND_CMD_READCACHESEQ	0x31
+#define NAND_CMD_READCACHEEND	0x3f
 
 /* Extended commands for AG-AND device */
 /*
@@ -192,6 +194,8 @@ enum nand_ecc_algo {
 #define NAND_CACHEPRG		0x00000008
 /* Chip has copy back function */
 #define NAND_COPYBACK		0x00000010
+/* Chip has read cache function */
+#define NAND_CACHEREAD		0x00000020
 /*
  * Chip requires ready check on read (for auto-incremented sequential read).
  * True only for small page devices; large page devices do not support
@@ -225,6 +229,7 @@ enum nand_ecc_algo {
 
 /* Macros to identify the above */
 #define NAND_HAS_CACHEPROG(chip) ((chip->options & NAND_CACHEPRG))
+#define NAND_HAS_CACHEREAD(chip) ((chip->options & NAND_CACHEREAD))
 #define NAND_HAS_SUBPAGE_READ(chip) ((chip->options & NAND_SUBPAGE_READ))
 #define NAND_HAS_SUBPAGE_WRITE(chip) !((chip)->options & NAND_NO_SUBPAGE_WRITE)
 
@@ -284,6 +289,9 @@ enum nand_ecc_algo {
 /* ONFI subfeature parameters length */
 #define ONFI_SUBFEATURE_PARAM_LEN	4
 
+/* ONFI optional commands READ CACHE supported? */
+#define ONFI_OPT_CMD_READ_CACHE		(1 << 1)
+
 /* ONFI optional commands SET/GET FEATURES supported? */
 #define ONFI_OPT_CMD_SET_GET_FEATURES	(1 << 2)
 
@@ -874,6 +882,10 @@ nand_get_sdr_timings(const struct nand_data_interface *conf)
  *			  means the configuration should not be applied but
  *			  only checked.
  * @bbt:		[INTERN] bad block table pointer
+ * @bbt_scanned:	[INTERN] bitmap of the blocks whose bad block marker has
+ *			been read, when a memory based bad block table is filled
+ *			in on demand (CONFIG_SYS_NAND_LAZY_BBT). NULL otherwise.
+ *			This shares the allocation of @bbt.
  * @bbt_td:		[REPLACEABLE] bad block table descriptor for flash
  *			lookup.
  * @bbt_md:		[REPLACEABLE] bad block table mirror descriptor
@@ -962,6 +974,7 @@ struct nand_chip {
 	struct nand_hw_control hwcontrol;
 
 	uint8_t *bbt;
+	uint8_t *bbt_scanned;
 	struct nand_bbt_descr *bbt_td;
 	struct nand_bbt_descr *bbt_md;
 
@@ -255,6 +255,50 @@ enum spi_nor_option_flags {
  */
 struct flash_info;
 
+struct spi_mem_dirmap_desc;
+
+#define SNOR_ERASE_TYPE_MAX	4
+#define SNOR_ERASE_TYPE_MASK	GENMASK(SNOR_ERASE_TYPE_MAX - 1, 0)
+
+/**
+ * struct spi_nor_erase_type - Structure to describe a SPI NOR erase type
+ * @size:		the size of the sector/block erased by the erase type,
+ *			0 if the erase type is not supported
+ * @opcode:		the SPI command op code to erase the sector/block
+ */
+struct spi_nor_erase_type {
+	u32	size;
+	u8	opcode;
+};
+
+/**
+ * struct spi_nor_erase_region - Structure to describe a SPI NOR erase region
+ * @offset:		the offset in the data array of erase region start
+ * @size:		the size of the region in bytes
+ * @erase_mask:		the erase types supported in the region, bit n stands
+ *			for erase type n of the erase map
+ */
+struct spi_nor_erase_region {
+	u64	offset;
+	u64	size;
+	u8	erase_mask;
+};
+
+/**
+ * struct spi_nor_erase_map - Structure to describe the SPI NOR erase map
+ * @regions:		the erase regions of a non-uniform flash, as described
+ *			by the SFDP Sector Map Parameter Table, or NULL if all
+ *			erase types can be used anywhere
+ * @n_regions:		the number of erase regions
+ * @types:		the erase types, in the order of the JESD216 Basic Flash
+ *			Parameter Table when it is available
+ */
+struct spi_nor_erase_map {
+	struct spi_nor_erase_region	*regions;
+	unsigned int			n_regions;
+	struct spi_nor_erase_type	types[SNOR_ERASE_TYPE_MAX];
+};
+
 /*
  * TODO: Remove, once all users of spi_flash interface are moved to MTD
  *
@@ -276,6 +320,8 @@ struct spi_flash {
  * @page_size:		the page size of the SPI NOR
  * @addr_width:		number of address bytes
  * @erase_opcode:	the opcode for erasing a sector
+ * @erase_map:		the erase types and regions used to erase ranges with
+ *			as few commands as possible
  * @read_opcode:	the read opcode
  * @read_dummy:		the dummy needed by the read operation
  * @program_opcode:	the program opcode
@@ -304,6 +350,8 @@ struct spi_flash {
  * @flash_is_locked:	[FLASH-SPECIFIC] check if a region of the SPI NOR is
  *			completely locked
  * @quad_enable:	[FLASH-SPECIFIC] enables SPI NOR quad mode
+ * @dirmap.rdesc:	direct mapping descriptor used by the default read
+ *			implementation, NULL if none could be created
  * @priv:		the private data
  */
 struct spi_nor {
@@ -315,6 +363,7 @@ struct spi_nor {
 	u32			page_size;
 	u8			addr_width;
 	u8			erase_opcode;
+	struct spi_nor_erase_map	erase_map;
 	u8			read_opcode;
 	u8			read_dummy;
 	u8			program_opcode;
@@ -346,6 +395,10 @@ struct spi_nor {
 	int (*flash_is_locked)(struct spi_nor *nor, loff_t ofs, uint64_t len);
 	int (*quad_enable)(struct spi_nor *nor);
 
+	struct {
+		struct spi_mem_dirmap_desc *rdesc;
+	} dirmap;
+
 	void *priv;
 /* Compatibility for spi_flash, remove once sf layer is merged with mtd */
 	const char *name;
@@ -441,4 +494,12 @@ struct spi_nor_hwcaps {
  */
 int spi_nor_scan(struct spi_nor *nor);
 
+/**
+ * spi_nor_remove() - release the resources allocated by spi_nor_scan()
+ * @nor:	the spi_nor structure
+ *
+ * Return: 0 for success, others for failure.
+ */
+int spi_nor_remove(struct spi_nor *nor);
+
 #endif
@@ -120,6 +120,28 @@ int nand_unlock(struct mtd_info *mtd, loff_t start, size_t length,
 		int allexcept);
 int nand_get_lock_status(struct mtd_info *mtd, loff_t offset);
 
+/* Bad block state of each block in struct nand_bbt_handoff */
+#define NAND_BBT_HANDOFF_UNKNOWN	0
+#define NAND_BBT_HANDOFF_GOOD		1
+#define NAND_BBT_HANDOFF_BAD		2
+
+/**
+ * struct nand_bbt_handoff - Bad blocks found by the SPL NAND loaders
+ *
+ * This is kept in a bloblist so that a loader in a later phase can reuse the
+ * checks made by one in an earlier phase.
+ *
+ * @block_size:	Size of an eraseblock in bytes
+ * @num_blocks:	Number of blocks covered, from the start of the device
+ * @state:	State of each block (NAND_BBT_HANDOFF_...), two bits each
+ *		with four blocks per byte
+ */
+struct nand_bbt_handoff {
+	u32 block_size;
+	u32 num_blocks;
+	u8 state[0];
+};
+
 u32 nand_spl_adjust_offset(u32 sector, u32 offs);
 int nand_spl_load_image(uint32_t offs, unsigned int size, void *dst);
 int nand_spl_read_block(int block, int offset, int len, void *dst);
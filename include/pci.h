@@ -990,6 +990,16 @@ pci_dev_t dm_pci_get_bdf(const struct udevice *dev);
  */
 int pci_bind_bus_devices(struct udevice *bus);
 
+/**
+ * pci_enum_cache_reset() - forget the buses recorded by earlier scans
+ *
+ * With PCI_ENUM_CACHE, pci_bind_bus_devices() binds the functions recorded
+ * when a bus was last scanned instead of scanning it again. After this call,
+ * the next probe of each bus scans it, e.g. because devices may have been
+ * added since.
+ */
+void pci_enum_cache_reset(void);
+
 /**
  * pci_auto_config_devices() - configure bus devices ready for use
  *
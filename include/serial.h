@@ -273,6 +273,12 @@ struct dm_serial_ops {
  * @buf:	Pointer to the RX buffer
  * @rd_ptr:	Read pointer in the RX buffer
  * @wr_ptr:	Write pointer in the RX buffer
+ *
+ * @tx_buf:	Pointer to the TX buffer
+ * @tx_rd_ptr:	Read pointer in the TX buffer
+ * @tx_wr_ptr:	Write pointer in the TX buffer
+ * @tx_busy:	true while the TX buffer is being sent to the UART
+ * @tx_stopped:	true while output bypasses the TX buffer, see serial_tx_stop()
  */
 struct serial_dev_priv {
 	struct stdio_dev *sdev;
@@ -280,6 +286,12 @@ struct serial_dev_priv {
 	char *buf;
 	int rd_ptr;
 	int wr_ptr;
+
+	char *tx_buf;
+	int tx_rd_ptr;
+	int tx_wr_ptr;
+	bool tx_busy;
+	bool tx_stopped;
 };
 
 /* Access the serial operations for a device */
@@ -346,4 +358,43 @@ void serial_puts(const char *str);
 int serial_getc(void);
 int serial_tstc(void);
 
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+/**
+ * serial_tx_poll() - Send buffered output which the UART has room for
+ *
+ * This does not wait for the UART, so it can be called from polling loops.
+ */
+void serial_tx_poll(void);
+
+/**
+ * serial_flush() - Wait until all buffered output has been sent to the UART
+ *
+ * This should be called before anything which stops U-Boot using the UART,
+ * such as resetting the board.
+ */
+void serial_flush(void);
+
+/**
+ * serial_tx_stop() - Send all buffered output and stop buffering
+ *
+ * This should be called before handing control to other software, such as
+ * an OS or a stand-alone application. Anything printed afterwards goes
+ * straight to the UART, since U-Boot may not get to send it later.
+ *
+ * The buffer is kept, so buffering can be resumed with serial_tx_start() if
+ * control comes back to U-Boot.
+ */
+void serial_tx_stop(void);
+
+/**
+ * serial_tx_start() - Go back to buffering output after serial_tx_stop()
+ */
+void serial_tx_start(void);
+#else
+static inline void serial_tx_poll(void) {}
+static inline void serial_flush(void) {}
+static inline void serial_tx_stop(void) {}
+static inline void serial_tx_start(void) {}
+#endif
+
 #endif
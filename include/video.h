@@ -88,6 +88,9 @@ enum video_log2_bpp {
  * @cmap:	Colour map for 8-bit-per-pixel displays
  * @fg_col_idx:	Foreground color code (bit 3 = bold, bit 0-2 = color)
  * @bg_col_idx:	Background color code (bit 3 = bold, bit 0-2 = color)
+ * @damage:	Bounding box of the frame buffer area changed since the last
+ *		sync, in pixels (xend and yend are exclusive). This is empty
+ *		when xend <= xstart. See video_damage()
  */
 struct video_priv {
 	/* Things set up by the driver: */
@@ -112,6 +115,14 @@ struct video_priv {
 	ushort *cmap;
 	u8 fg_col_idx;
 	u8 bg_col_idx;
+#ifdef CONFIG_VIDEO_DAMAGE
+	struct {
+		int xstart;
+		int ystart;
+		int xend;
+		int yend;
+	} damage;
+#endif
 };
 
 /**
@@ -171,6 +182,28 @@ int video_clear(struct udevice *dev);
  */
 int video_sync(struct udevice *vid, bool force);
 
+#ifdef CONFIG_VIDEO_DAMAGE
+/**
+ * video_damage() - Record that a region of the frame buffer has changed
+ *
+ * The next call to video_sync() only flushes or copies the bounding box of
+ * all the regions recorded since the previous sync. The region is clipped to
+ * the display, so callers need not do this themselves.
+ *
+ * @vid:	Device whose frame buffer was changed
+ * @x:		X position of the region in pixels from the left
+ * @y:		Y position of the region in pixels from the top
+ * @width:	Width of the region in pixels
+ * @height:	Height of the region in pixels
+ */
+void video_damage(struct udevice *vid, int x, int y, int width, int height);
+#else
+static inline void video_damage(struct udevice *vid, int x, int y, int width,
+				int height)
+{
+}
+#endif
+
 /**
  * video_sync_all() - Sync all devices' frame buffers with there hardware
  *
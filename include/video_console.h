@@ -210,6 +210,9 @@ int vidconsole_set_row(struct udevice *dev, uint row, int clr);
  * The device always starts with the cursor at position 0,0 (top left). It
  * can be adjusted manually using vidconsole_position_cursor().
  *
+ * The display is not synced, so call video_sync() on the parent device
+ * once all output is written.
+ *
  * @dev:	Device to adjust
  * @ch:		Character to write
  * @return 0 if OK, -ve on error
@@ -226,6 +229,9 @@ int vidconsole_put_char(struct udevice *dev, char ch);
  * The device always starts with the cursor at position 0,0 (top left). It
  * can be adjusted manually using vidconsole_position_cursor().
  *
+ * The display is not synced, so call video_sync() on the parent device
+ * once all output is written.
+ *
  * @dev:	Device to adjust
  * @str:	String to write
  * @return 0 if OK, -ve on error
@@ -305,4 +311,34 @@ static inline int vidconsole_memmove(struct udevice *dev, void *dst,
 
 #endif
 
+#ifdef CONFIG_CONSOLE_TRUETYPE_GLYPH_CACHE
+/**
+ * console_truetype_set_glyph_cache() - Turn the TrueType glyph cache on or off
+ *
+ * The cache is on after the console is probed. Turning it off makes every
+ * character render exactly at its position, as without the cache. This is
+ * used by tests to compare the two.
+ *
+ * @dev: TrueType console device
+ * @enable: true to use the cache, false to render every character
+ * @return 0
+ */
+int console_truetype_set_glyph_cache(struct udevice *dev, bool enable);
+
+/**
+ * console_truetype_get_glyph_hits() - Get the number of glyph-cache hits
+ *
+ * @dev: TrueType console device
+ * @return number of characters found in the cache since the console was
+ *	probed
+ */
+int console_truetype_get_glyph_hits(struct udevice *dev);
+#else
+static inline int console_truetype_set_glyph_cache(struct udevice *dev,
+						   bool enable)
+{
+	return 0;
+}
+#endif
+
 #endif
@@ -104,6 +104,9 @@
 #define BCH_ECC_WORDS(_p)      DIV_ROUND_UP(GF_M(_p)*GF_T(_p), 32)
 #define BCH_ECC_BYTES(_p)      DIV_ROUND_UP(GF_M(_p)*GF_T(_p), 8)
 
+/* syndrome table entry for polynomials vanishing at a^j */
+#define BCH_SYN_ZERO           0xffff
+
 #ifndef dbg
 #define dbg(_fmt, args...)     do {} while (0)
 #endif
@@ -382,14 +385,22 @@ static inline int a_ilog(struct bch_control *bch, unsigned int x)
 
 /*
  * compute 2t syndromes of ecc polynomial, i.e. ecc(a^j) for j=1..2t
+ *
+ * Odd syndromes are computed one ecc byte at a time: a byte b holding the
+ * coefficients of x^k..x^(k+7) contributes b(a^j)*a^(j*k) to ecc(a^j). The
+ * log of b(a^j) is looked up in syn_tab, so each byte costs one addition and
+ * one exponentiation table lookup, independent from the other bytes.
  */
 static void compute_syndromes(struct bch_control *bch, uint32_t *ecc,
 			      unsigned int *syn)
 {
 	int i, j, s;
-	unsigned int m;
+	unsigned int m, v, l, off, step;
+	const uint16_t *tab;
 	uint32_t poly;
 	const int t = GF_T(bch);
+	const int words = DIV_ROUND_UP(bch->ecc_bits, 32);
+	const unsigned int pad = 32*words-bch->ecc_bits;
 
 	s = bch->ecc_bits;
 
@@ -397,20 +408,25 @@ static void compute_syndromes(struct bch_control *bch, uint32_t *ecc,
 	m = ((unsigned int)s) & 31;
 	if (m)
 		ecc[s/32] &= ~((1u << (32-m))-1);
-	memset(syn, 0, 2*t*sizeof(*syn));
 
 	/* compute v(a^j) for j=1 .. 2t-1 */
-	do {
-		poly = *ecc++;
-		s -= 32;
-		while (poly) {
-			i = deg(poly);
-			for (j = 0; j < 2*t; j += 2)
-				syn[j] ^= a_pow(bch, (j+1)*(i+s));
-
-			poly ^= (1 << i);
+	for (j = 0; j < t; j++) {
+		tab = bch->syn_tab+256*j;
+		step = modulo(bch, 8*(2*j+1));
+		/* last ecc word is padded with zero bits below x^0 */
+		off = mod_s(bch, GF_N(bch)-modulo(bch, (2*j+1)*pad));
+		v = 0;
+		for (i = words-1; i >= 0; i--) {
+			poly = ecc[i];
+			for (s = 0; s < 32; s += 8) {
+				l = tab[(poly >> s) & 0xff];
+				if (l != BCH_SYN_ZERO)
+					v ^= bch->a_pow_tab[mod_s(bch, l+off)];
+				off = mod_s(bch, off+step);
+			}
 		}
-	} while (s > 0);
+		syn[2*j] = v;
+	}
 
 	/* v(a^(2j)) = v(a^j)^2 */
 	for (j = 0; j < t; j++)
@@ -1121,6 +1137,27 @@ static int build_gf_tables(struct bch_control *bch, unsigned int poly)
 	return 0;
 }
 
+/*
+ * compute byte evaluation tables for fast syndrome computation: entry b of
+ * table j is the log of the value at a^(2j+1) of the polynomial whose
+ * coefficients are the bits of b, or BCH_SYN_ZERO if this value is zero
+ */
+static void build_syn_tables(struct bch_control *bch)
+{
+	unsigned int b, j, v[256];
+	uint16_t *tab;
+
+	for (j = 0; j < GF_T(bch); j++) {
+		tab = bch->syn_tab+256*j;
+		v[0] = 0;
+		tab[0] = BCH_SYN_ZERO;
+		for (b = 1; b < 256; b++) {
+			v[b] = v[b & (b-1)]^a_pow(bch, (2*j+1)*deg(b & -b));
+			tab[b] = v[b] ? a_log(bch, v[b]) : BCH_SYN_ZERO;
+		}
+	}
+}
+
 /*
  * compute generator polynomial remainder tables for fast encoding
  */
@@ -1347,6 +1384,7 @@ struct bch_control *init_bch(int m, int t, unsigned int prim_poly)
 	bch->a_pow_tab = bch_alloc((1+bch->n)*sizeof(*bch->a_pow_tab), &err);
 	bch->a_log_tab = bch_alloc((1+bch->n)*sizeof(*bch->a_log_tab), &err);
 	bch->mod8_tab  = bch_alloc(words*1024*sizeof(*bch->mod8_tab), &err);
+	bch->syn_tab   = bch_alloc(t*256*sizeof(*bch->syn_tab), &err);
 	bch->ecc_buf   = bch_alloc(words*sizeof(*bch->ecc_buf), &err);
 	bch->ecc_buf2  = bch_alloc(words*sizeof(*bch->ecc_buf2), &err);
 	bch->xi_tab    = bch_alloc(m*sizeof(*bch->xi_tab), &err);
@@ -1372,6 +1410,8 @@ struct bch_control *init_bch(int m, int t, unsigned int prim_poly)
 	build_mod8_tables(bch, genpoly);
 	kfree(genpoly);
 
+	build_syn_tables(bch);
+
 	err = build_deg2_base(bch);
 	if (err)
 		goto fail;
@@ -1395,6 +1435,7 @@ void free_bch(struct bch_control *bch)
 		kfree(bch->a_pow_tab);
 		kfree(bch->a_log_tab);
 		kfree(bch->mod8_tab);
+		kfree(bch->syn_tab);
 		kfree(bch->ecc_buf);
 		kfree(bch->ecc_buf2);
 		kfree(bch->xi_tab);
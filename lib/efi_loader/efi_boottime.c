@@ -15,6 +15,7 @@
 #include <log.h>
 #include <malloc.h>
 #include <pe.h>
+#include <serial.h>
 #include <time.h>
 #include <u-boot/crc.h>
 #include <usb.h>
@@ -798,6 +799,7 @@ static efi_status_t EFIAPI efi_create_event_ext(
  *
  * Our timers have to work without interrupts, so we check whenever keyboard
  * input or disk accesses happen if enough time elapsed for them to fire.
+ * Non-blocking disk transfers are advanced here for the same reason.
  */
 void efi_timer_check(void)
 {
@@ -822,6 +824,8 @@ void efi_timer_check(void)
 		evt->is_signaled = false;
 		efi_signal_event(evt);
 	}
+	if (IS_ENABLED(CONFIG_PARTITIONS))
+		efi_disk_process_requests();
 	efi_process_event_queue();
 	WATCHDOG_RESET();
 }
@@ -2165,6 +2169,7 @@ static efi_status_t EFIAPI efi_exit_boot_services(efi_handle_t image_handle,
 			list_del(&evt->link);
 	}
 
+	serial_tx_stop();
 	if (!efi_st_keep_devices) {
 		if (IS_ENABLED(CONFIG_USB_DEVICE))
 			udc_disconnect();
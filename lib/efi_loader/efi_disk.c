@@ -15,10 +15,12 @@
 #include <log.h>
 #include <part.h>
 #include <malloc.h>
+#include <linux/sizes.h>
 
 struct efi_system_partition efi_system_partition;
 
 const efi_guid_t efi_block_io_guid = EFI_BLOCK_IO_PROTOCOL_GUID;
+const efi_guid_t efi_block_io2_guid = EFI_BLOCK_IO2_PROTOCOL_GUID;
 const efi_guid_t efi_system_partition_guid = PARTITION_SYSTEM_GUID;
 
 /**
@@ -26,6 +28,7 @@ const efi_guid_t efi_system_partition_guid = PARTITION_SYSTEM_GUID;
  *
  * @header:	EFI object header
  * @ops:	EFI disk I/O protocol interface
+ * @ops2:	EFI disk I/O 2 protocol interface
  * @ifname:	interface name for block device
  * @dev_index:	device index of block device
  * @media:	block I/O media information
@@ -38,6 +41,7 @@ const efi_guid_t efi_system_partition_guid = PARTITION_SYSTEM_GUID;
 struct efi_disk_obj {
 	struct efi_object header;
 	struct efi_block_io ops;
+	struct efi_block_io2 ops2;
 	const char *ifname;
 	int dev_index;
 	struct efi_block_io_media media;
@@ -75,6 +79,69 @@ enum efi_disk_direction {
 	EFI_DISK_WRITE,
 };
 
+/* Number of bytes transferred per step of a non-blocking request */
+#define EFI_DISK_REQ_CHUNK	SZ_64K
+
+/**
+ * struct efi_disk_req - non-blocking EFI_BLOCK_IO2_PROTOCOL request
+ *
+ * @link:	entry in the request queue
+ * @diskobj:	disk to be accessed
+ * @token:	token of the request
+ * @lba:	next logical block to be transferred
+ * @buffer:	next part of the buffer to be transferred
+ * @size:	number of bytes left, 0 for a flush
+ * @direction:	direction of the transfer
+ */
+struct efi_disk_req {
+	struct list_head link;
+	struct efi_disk_obj *diskobj;
+	struct efi_block_io2_token *token;
+	u64 lba;
+	void *buffer;
+	efi_uintn_t size;
+	enum efi_disk_direction direction;
+};
+
+/* Requests are processed in order across all disks */
+static LIST_HEAD(efi_disk_reqs);
+/* Set while a transfer or its bounce buffer copy is in progress */
+static bool efi_disk_busy;
+
+/**
+ * efi_disk_check_rw() - check the parameters of a block transfer
+ *
+ * @media:		media information of the disk
+ * @media_id:		id of the medium to be accessed
+ * @lba:		starting logical block
+ * @buffer_size:	size of the buffer
+ * @buffer:		pointer to the buffer
+ * @direction:		direction of the transfer
+ * Return:		status code
+ */
+static efi_status_t efi_disk_check_rw(struct efi_block_io_media *media,
+				      u32 media_id, u64 lba,
+				      efi_uintn_t buffer_size, void *buffer,
+				      enum efi_disk_direction direction)
+{
+	if (direction == EFI_DISK_WRITE && media->read_only)
+		return EFI_WRITE_PROTECTED;
+	/* TODO: check for media changes */
+	if (media_id != media->media_id)
+		return EFI_MEDIA_CHANGED;
+	if (!media->media_present)
+		return EFI_NO_MEDIA;
+	/* media->io_align is a power of 2 or 0 */
+	if (media->io_align &&
+	    (uintptr_t)buffer & (media->io_align - 1))
+		return EFI_INVALID_PARAMETER;
+	if (lba * media->block_size + buffer_size >
+	    (media->last_block + 1) * media->block_size)
+		return EFI_INVALID_PARAMETER;
+
+	return EFI_SUCCESS;
+}
+
 static efi_status_t efi_disk_rw_blocks(struct efi_block_io *this,
 			u32 media_id, u64 lba, unsigned long buffer_size,
 			void *buffer, enum efi_disk_direction direction)
@@ -134,22 +201,15 @@ static efi_status_t EFIAPI efi_disk_read_blocks(struct efi_block_io *this,
 			void *buffer)
 {
 	void *real_buffer = buffer;
+	bool busy = efi_disk_busy;
 	efi_status_t r;
 
 	if (!this)
 		return EFI_INVALID_PARAMETER;
-	/* TODO: check for media changes */
-	if (media_id != this->media->media_id)
-		return EFI_MEDIA_CHANGED;
-	if (!this->media->media_present)
-		return EFI_NO_MEDIA;
-	/* media->io_align is a power of 2 or 0 */
-	if (this->media->io_align &&
-	    (uintptr_t)buffer & (this->media->io_align - 1))
-		return EFI_INVALID_PARAMETER;
-	if (lba * this->media->block_size + buffer_size >
-	    (this->media->last_block + 1) * this->media->block_size)
-		return EFI_INVALID_PARAMETER;
+	r = efi_disk_check_rw(this->media, media_id, lba, buffer_size, buffer,
+			      EFI_DISK_READ);
+	if (r != EFI_SUCCESS)
+		return r;
 
 #ifdef CONFIG_EFI_LOADER_BOUNCE_BUFFER
 	if (buffer_size > EFI_LOADER_BOUNCE_BUFFER_SIZE) {
@@ -169,12 +229,14 @@ static efi_status_t EFIAPI efi_disk_read_blocks(struct efi_block_io *this,
 	EFI_ENTRY("%p, %x, %llx, %zx, %p", this, media_id, lba,
 		  buffer_size, buffer);
 
+	efi_disk_busy = true;
 	r = efi_disk_rw_blocks(this, media_id, lba, buffer_size, real_buffer,
 			       EFI_DISK_READ);
 
 	/* Copy from bounce buffer to real buffer if necessary */
 	if ((r == EFI_SUCCESS) && (real_buffer != buffer))
 		memcpy(buffer, real_buffer, buffer_size);
+	efi_disk_busy = busy;
 
 	return EFI_EXIT(r);
 }
@@ -200,24 +262,15 @@ static efi_status_t EFIAPI efi_disk_write_blocks(struct efi_block_io *this,
 			void *buffer)
 {
 	void *real_buffer = buffer;
+	bool busy = efi_disk_busy;
 	efi_status_t r;
 
 	if (!this)
 		return EFI_INVALID_PARAMETER;
-	if (this->media->read_only)
-		return EFI_WRITE_PROTECTED;
-	/* TODO: check for media changes */
-	if (media_id != this->media->media_id)
-		return EFI_MEDIA_CHANGED;
-	if (!this->media->media_present)
-		return EFI_NO_MEDIA;
-	/* media->io_align is a power of 2 or 0 */
-	if (this->media->io_align &&
-	    (uintptr_t)buffer & (this->media->io_align - 1))
-		return EFI_INVALID_PARAMETER;
-	if (lba * this->media->block_size + buffer_size >
-	    (this->media->last_block + 1) * this->media->block_size)
-		return EFI_INVALID_PARAMETER;
+	r = efi_disk_check_rw(this->media, media_id, lba, buffer_size, buffer,
+			      EFI_DISK_WRITE);
+	if (r != EFI_SUCCESS)
+		return r;
 
 #ifdef CONFIG_EFI_LOADER_BOUNCE_BUFFER
 	if (buffer_size > EFI_LOADER_BOUNCE_BUFFER_SIZE) {
@@ -238,11 +291,13 @@ static efi_status_t EFIAPI efi_disk_write_blocks(struct efi_block_io *this,
 		  buffer_size, buffer);
 
 	/* Populate bounce buffer if necessary */
+	efi_disk_busy = true;
 	if (real_buffer != buffer)
 		memcpy(real_buffer, buffer, buffer_size);
 
 	r = efi_disk_rw_blocks(this, media_id, lba, buffer_size, real_buffer,
 			       EFI_DISK_WRITE);
+	efi_disk_busy = busy;
 
 	return EFI_EXIT(r);
 }
@@ -274,6 +329,343 @@ static const struct efi_block_io block_io_disk_template = {
 	.flush_blocks = &efi_disk_flush_blocks,
 };
 
+/**
+ * efi_disk_complete_req() - complete a non-blocking request
+ *
+ * The request is freed and the event of its token is signaled.
+ *
+ * @req:	request, not on any list
+ * @status:	status of the transaction
+ */
+static void efi_disk_complete_req(struct efi_disk_req *req,
+				  efi_status_t status)
+{
+	struct efi_block_io2_token *token = req->token;
+
+	free(req);
+	token->transaction_status = status;
+	efi_signal_event(token->event);
+}
+
+/**
+ * efi_disk_process_requests() - advance the non-blocking disk requests
+ *
+ * Transfers the next chunk of the oldest queued request and completes the
+ * request when it is done or has failed. U-Boot's block drivers cannot queue
+ * work, so requests make progress whenever efi_timer_check() is called, e.g.
+ * while the application checks or waits for events.
+ */
+void efi_disk_process_requests(void)
+{
+	struct efi_disk_req *req;
+	efi_uintn_t size;
+	void *real_buffer;
+	u32 blksz;
+	efi_status_t ret = EFI_SUCCESS;
+
+	if (efi_disk_busy || list_empty(&efi_disk_reqs))
+		return;
+
+	/* Dequeue the request so that a reset cannot free it under us */
+	req = list_first_entry(&efi_disk_reqs, struct efi_disk_req, link);
+	list_del(&req->link);
+	blksz = req->diskobj->media.block_size;
+
+	size = max_t(efi_uintn_t, EFI_DISK_REQ_CHUNK / blksz, 1) * blksz;
+	size = min(req->size, size);
+	if (size) {
+		real_buffer = req->buffer;
+#ifdef CONFIG_EFI_LOADER_BOUNCE_BUFFER
+		real_buffer = efi_bounce_buffer;
+#endif
+		efi_disk_busy = true;
+		if (req->direction == EFI_DISK_WRITE &&
+		    real_buffer != req->buffer)
+			memcpy(real_buffer, req->buffer, size);
+		ret = efi_disk_rw_blocks(&req->diskobj->ops,
+					 req->diskobj->media.media_id,
+					 req->lba, size, real_buffer,
+					 req->direction);
+		if (ret == EFI_SUCCESS && req->direction == EFI_DISK_READ &&
+		    real_buffer != req->buffer)
+			memcpy(req->buffer, real_buffer, size);
+		efi_disk_busy = false;
+
+		req->lba += size / blksz;
+		req->buffer += size;
+		req->size -= size;
+	}
+
+	if (ret == EFI_SUCCESS && req->size)
+		list_add(&req->link, &efi_disk_reqs);
+	else
+		efi_disk_complete_req(req, ret);
+}
+
+/**
+ * efi_disk_pending() - check for queued requests of a disk
+ *
+ * @diskobj:	disk
+ * Return:	true if a request of the disk is queued
+ */
+static bool efi_disk_pending(struct efi_disk_obj *diskobj)
+{
+	struct efi_disk_req *req;
+
+	list_for_each_entry(req, &efi_disk_reqs, link) {
+		if (req->diskobj == diskobj)
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * efi_disk_drain() - complete the queued requests of a disk
+ *
+ * Blocking accesses wait for the queued requests of the disk so that the
+ * order of the accesses is kept.
+ *
+ * @diskobj:	disk
+ */
+static void efi_disk_drain(struct efi_disk_obj *diskobj)
+{
+	while (!efi_disk_busy && efi_disk_pending(diskobj))
+		efi_disk_process_requests();
+}
+
+/**
+ * efi_disk_queue_req() - queue a non-blocking request
+ *
+ * @diskobj:	disk
+ * @token:	token of the request
+ * @lba:	starting logical block
+ * @size:	size of the buffer, 0 for a flush
+ * @buffer:	pointer to the buffer
+ * @direction:	direction of the transfer
+ * Return:	status code
+ */
+static efi_status_t efi_disk_queue_req(struct efi_disk_obj *diskobj,
+				       struct efi_block_io2_token *token,
+				       u64 lba, efi_uintn_t size, void *buffer,
+				       enum efi_disk_direction direction)
+{
+	struct efi_disk_req *req;
+
+	req = calloc(1, sizeof(*req));
+	if (!req)
+		return EFI_OUT_OF_RESOURCES;
+
+	req->diskobj = diskobj;
+	req->token = token;
+	req->lba = lba;
+	req->buffer = buffer;
+	req->size = size;
+	req->direction = direction;
+	list_add_tail(&req->link, &efi_disk_reqs);
+
+	return EFI_SUCCESS;
+}
+
+/**
+ * efi_disk_reset_ex() - reset block device
+ *
+ * This function implements the Reset service of the EFI_BLOCK_IO2_PROTOCOL.
+ *
+ * Queued requests of the device are aborted.
+ *
+ * See the Unified Extensible Firmware Interface (UEFI) specification for
+ * details.
+ *
+ * @this:			pointer to the BLOCK_IO2_PROTOCOL
+ * @extended_verification:	extended verification
+ * Return:			status code
+ */
+static efi_status_t EFIAPI efi_disk_reset_ex(struct efi_block_io2 *this,
+					     char extended_verification)
+{
+	struct efi_disk_obj *diskobj;
+	struct efi_disk_req *req, *next;
+	LIST_HEAD(aborted);
+
+	EFI_ENTRY("%p, %x", this, extended_verification);
+
+	if (!this)
+		return EFI_EXIT(EFI_INVALID_PARAMETER);
+
+	diskobj = container_of(this, struct efi_disk_obj, ops2);
+	list_for_each_entry_safe(req, next, &efi_disk_reqs, link) {
+		if (req->diskobj == diskobj)
+			list_move_tail(&req->link, &aborted);
+	}
+	/* Notification functions may queue new requests */
+	while (!list_empty(&aborted)) {
+		req = list_first_entry(&aborted, struct efi_disk_req, link);
+		list_del(&req->link);
+		efi_disk_complete_req(req, EFI_ABORTED);
+	}
+
+	return EFI_EXIT(EFI_SUCCESS);
+}
+
+/**
+ * efi_disk_rw_blocks_ex() - read or write blocks, possibly non-blocking
+ *
+ * Without a token or an event in the token the transfer is done immediately.
+ * Otherwise it is queued and the event is signaled when it is completed.
+ *
+ * @this:		pointer to the BLOCK_IO2_PROTOCOL
+ * @media_id:		id of the medium to be accessed
+ * @lba:		starting logical block
+ * @token:		token of the request
+ * @buffer_size:	size of the buffer
+ * @buffer:		pointer to the buffer
+ * @direction:		direction of the transfer
+ * Return:		status code
+ */
+static efi_status_t efi_disk_rw_blocks_ex(struct efi_block_io2 *this,
+					  u32 media_id, u64 lba,
+					  struct efi_block_io2_token *token,
+					  efi_uintn_t buffer_size, void *buffer,
+					  enum efi_disk_direction direction)
+{
+	struct efi_disk_obj *diskobj;
+	efi_status_t ret;
+
+	if (!this)
+		return EFI_INVALID_PARAMETER;
+	diskobj = container_of(this, struct efi_disk_obj, ops2);
+
+	if (!token || !token->event) {
+		efi_disk_drain(diskobj);
+		if (direction == EFI_DISK_READ)
+			return EFI_CALL(efi_disk_read_blocks(&diskobj->ops,
+							     media_id, lba,
+							     buffer_size,
+							     buffer));
+		return EFI_CALL(efi_disk_write_blocks(&diskobj->ops, media_id,
+						      lba, buffer_size,
+						      buffer));
+	}
+
+	ret = efi_disk_check_rw(this->media, media_id, lba, buffer_size,
+				buffer, direction);
+	if (ret != EFI_SUCCESS)
+		return ret;
+	/* We only support full block access */
+	if (buffer_size & (this->media->block_size - 1))
+		return EFI_BAD_BUFFER_SIZE;
+
+	return efi_disk_queue_req(diskobj, token, lba, buffer_size, buffer,
+				  direction);
+}
+
+/**
+ * efi_disk_read_blocks_ex() - reads blocks from device
+ *
+ * This function implements the ReadBlocksEx service of the
+ * EFI_BLOCK_IO2_PROTOCOL.
+ *
+ * See the Unified Extensible Firmware Interface (UEFI) specification for
+ * details.
+ *
+ * @this:			pointer to the BLOCK_IO2_PROTOCOL
+ * @media_id:			id of the medium to be read from
+ * @lba:			starting logical block for reading
+ * @token:			token of the request, may be NULL
+ * @buffer_size:		size of the read buffer
+ * @buffer:			pointer to the destination buffer
+ * Return:			status code
+ */
+static efi_status_t EFIAPI efi_disk_read_blocks_ex(struct efi_block_io2 *this,
+			u32 media_id, u64 lba,
+			struct efi_block_io2_token *token,
+			efi_uintn_t buffer_size, void *buffer)
+{
+	EFI_ENTRY("%p, %x, %llx, %p, %zx, %p", this, media_id, lba, token,
+		  buffer_size, buffer);
+
+	return EFI_EXIT(efi_disk_rw_blocks_ex(this, media_id, lba, token,
+					      buffer_size, buffer,
+					      EFI_DISK_READ));
+}
+
+/**
+ * efi_disk_write_blocks_ex() - writes blocks to device
+ *
+ * This function implements the WriteBlocksEx service of the
+ * EFI_BLOCK_IO2_PROTOCOL.
+ *
+ * See the Unified Extensible Firmware Interface (UEFI) specification for
+ * details.
+ *
+ * @this:			pointer to the BLOCK_IO2_PROTOCOL
+ * @media_id:			id of the medium to be written to
+ * @lba:			starting logical block for writing
+ * @token:			token of the request, may be NULL
+ * @buffer_size:		size of the write buffer
+ * @buffer:			pointer to the source buffer
+ * Return:			status code
+ */
+static efi_status_t EFIAPI efi_disk_write_blocks_ex(struct efi_block_io2 *this,
+			u32 media_id, u64 lba,
+			struct efi_block_io2_token *token,
+			efi_uintn_t buffer_size, void *buffer)
+{
+	EFI_ENTRY("%p, %x, %llx, %p, %zx, %p", this, media_id, lba, token,
+		  buffer_size, buffer);
+
+	return EFI_EXIT(efi_disk_rw_blocks_ex(this, media_id, lba, token,
+					      buffer_size, buffer,
+					      EFI_DISK_WRITE));
+}
+
+/**
+ * efi_disk_flush_blocks_ex() - flushes modified data to the device
+ *
+ * This function implements the FlushBlocksEx service of the
+ * EFI_BLOCK_IO2_PROTOCOL.
+ *
+ * As we always write synchronously the flush completes once the requests
+ * queued before it are done.
+ *
+ * See the Unified Extensible Firmware Interface (UEFI) specification for
+ * details.
+ *
+ * @this:			pointer to the BLOCK_IO2_PROTOCOL
+ * @token:			token of the request, may be NULL
+ * Return:			status code
+ */
+static efi_status_t EFIAPI efi_disk_flush_blocks_ex(struct efi_block_io2 *this,
+			struct efi_block_io2_token *token)
+{
+	struct efi_disk_obj *diskobj;
+	efi_status_t ret = EFI_SUCCESS;
+
+	EFI_ENTRY("%p, %p", this, token);
+
+	if (!this) {
+		ret = EFI_INVALID_PARAMETER;
+		goto out;
+	}
+	diskobj = container_of(this, struct efi_disk_obj, ops2);
+
+	if (token && token->event)
+		ret = efi_disk_queue_req(diskobj, token, 0, 0, NULL,
+					 EFI_DISK_WRITE);
+	else
+		efi_disk_drain(diskobj);
+out:
+	return EFI_EXIT(ret);
+}
+
+static const struct efi_block_io2 block_io2_disk_template = {
+	.reset = &efi_disk_reset_ex,
+	.read_blocks_ex = &efi_disk_read_blocks_ex,
+	.write_blocks_ex = &efi_disk_write_blocks_ex,
+	.flush_blocks_ex = &efi_disk_flush_blocks_ex,
+};
+
 /**
  * efi_fs_from_path() - retrieve simple file system protocol
  *
@@ -422,6 +814,7 @@ static efi_status_t efi_disk_add_dev(
 	ret = EFI_CALL(efi_install_multiple_protocol_interfaces(
 			&handle, &efi_guid_device_path, diskobj->dp,
 			&efi_block_io_guid, &diskobj->ops,
+			&efi_block_io2_guid, &diskobj->ops2,
 			guid, NULL, NULL));
 	if (ret != EFI_SUCCESS)
 		return ret;
@@ -441,6 +834,7 @@ static efi_status_t efi_disk_add_dev(
 			return ret;
 	}
 	diskobj->ops = block_io_disk_template;
+	diskobj->ops2 = block_io2_disk_template;
 	diskobj->ifname = if_typename;
 	diskobj->dev_index = dev_index;
 	diskobj->desc = desc;
@@ -458,6 +852,7 @@ static efi_status_t efi_disk_add_dev(
 	if (part)
 		diskobj->media.logical_partition = 1;
 	diskobj->ops.media = &diskobj->media;
+	diskobj->ops2.media = &diskobj->media;
 	if (disk)
 		*disk = diskobj;
 
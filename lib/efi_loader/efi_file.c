@@ -35,6 +35,9 @@ struct file_handle {
 	int isdir;
 	u64 open_mode;
 
+	/* for reading a file, opened on the first read: */
+	struct fs_file_stream *file;
+
 	/* for reading a directory: */
 	struct fs_dir_stream *dirs;
 	struct fs_dirent *dent;
@@ -364,6 +367,7 @@ out:
 
 static efi_status_t file_close(struct file_handle *fh)
 {
+	fs_closefile(fh->file);
 	fs_closedir(fh->dirs);
 	free(fh);
 	return EFI_SUCCESS;
@@ -409,18 +413,72 @@ static efi_status_t efi_get_file_size(struct file_handle *fh,
 	return EFI_SUCCESS;
 }
 
+/**
+ * file_read_stream() - read from the file stream of a file handle
+ *
+ * The file stream is opened on the first read and keeps the file system
+ * mounted and the file located, so that the many small reads issued by
+ * boot loaders only cost the data transfer.
+ *
+ * @fh:			file handle
+ * @buffer_size:	size of @buffer, on return number of bytes read
+ * @buffer:		buffer to read into
+ * Return:		0 on success, -ENOSYS if the file system does not
+ *			support file streams, other negative error otherwise
+ */
+static int file_read_stream(struct file_handle *fh, u64 *buffer_size,
+			    void *buffer)
+{
+	loff_t actread;
+	int ret;
+
+	if (!fh->file) {
+		if (set_blk_dev(fh))
+			return -EIO;
+		fh->file = fs_openfile(fh->path);
+		if (!fh->file)
+			return -errno;
+	}
+
+	if (fh->file->size < fh->offset)
+		return -EINVAL;
+
+	ret = fs_readfile(fh->file, buffer, fh->offset, *buffer_size,
+			  &actread);
+	if (ret == -ESTALE) {
+		/* The file system was written to, locate the file again */
+		fs_closefile(fh->file);
+		fh->file = NULL;
+		return file_read_stream(fh, buffer_size, buffer);
+	}
+	if (ret)
+		return ret;
+
+	*buffer_size = actread;
+	fh->offset += actread;
+
+	return 0;
+}
+
 static efi_status_t file_read(struct file_handle *fh, u64 *buffer_size,
 		void *buffer)
 {
 	loff_t actread;
 	efi_status_t ret;
 	loff_t file_size;
+	int err;
 
 	if (!buffer) {
 		ret = EFI_INVALID_PARAMETER;
 		return ret;
 	}
 
+	err = file_read_stream(fh, buffer_size, buffer);
+	if (!err)
+		return EFI_SUCCESS;
+	if (err != -ENOSYS)
+		return EFI_DEVICE_ERROR;
+
 	ret = efi_get_file_size(fh, &file_size);
 	if (ret != EFI_SUCCESS)
 		return ret;
@@ -27,6 +27,7 @@ static const efi_guid_t efi_gop_guid = EFI_GRAPHICS_OUTPUT_PROTOCOL_GUID;
  * @mode:	graphical output mode
  * @bpix:	bits per pixel
  * @fb:		frame buffer
+ * @vdev:	video device
  */
 struct efi_gop_obj {
 	struct efi_object header;
@@ -36,6 +37,9 @@ struct efi_gop_obj {
 	/* Fields we only have access to during init */
 	u32 bpix;
 	void *fb;
+#ifdef CONFIG_DM_VIDEO
+	struct udevice *vdev;
+#endif
 };
 
 static efi_status_t EFIAPI gop_query_mode(struct efi_gop *this, u32 mode_number,
@@ -312,6 +316,34 @@ static efi_status_t gop_blt_vid_to_buf(struct efi_gop *this,
 			   dx, dy, width, height, delta, vid_bpp);
 }
 
+#ifdef CONFIG_DM_VIDEO
+/**
+ * gop_damage() - tell the video device which region a Blt() operation changed
+ *
+ * @this:	EFI_GRAPHICS_OUTPUT_PROTOCOL
+ * @operation:	Blt() operation that was carried out
+ * @dx:		destination x-coordinate
+ * @dy:		destination y-coordinate
+ * @width:	width of rectangle
+ * @height:	height of rectangle
+ */
+static void gop_damage(struct efi_gop *this, u32 operation, efi_uintn_t dx,
+		       efi_uintn_t dy, efi_uintn_t width, efi_uintn_t height)
+{
+	struct efi_gop_obj *gopobj = container_of(this, struct efi_gop_obj, ops);
+	struct video_priv *priv = dev_get_uclass_priv(gopobj->vdev);
+	void *line;
+
+	/* Reading back into the Blt buffer leaves the display untouched */
+	if (operation == EFI_BLT_VIDEO_TO_BLT_BUFFER)
+		return;
+
+	video_damage(gopobj->vdev, dx, dy, width, height);
+	line = gopobj->fb + dy * priv->line_length;
+	video_sync_copy(gopobj->vdev, line, line + height * priv->line_length);
+}
+#endif
+
 /**
  * gop_set_mode() - set graphical output mode
  *
@@ -415,7 +447,8 @@ efi_status_t EFIAPI gop_blt(struct efi_gop *this, struct efi_gop_pixel *buffer,
 		return EFI_EXIT(ret);
 
 #ifdef CONFIG_DM_VIDEO
-	video_sync_all();
+	gop_damage(this, operation, dx, dy, width, height);
+	video_sync(container_of(this, struct efi_gop_obj, ops)->vdev, true);
 #else
 	lcd_sync();
 #endif
@@ -527,6 +560,9 @@ efi_status_t efi_gop_register(void)
 	gopobj->info.pixels_per_scanline = col;
 	gopobj->bpix = bpix;
 	gopobj->fb = fb;
+#ifdef CONFIG_DM_VIDEO
+	gopobj->vdev = vdev;
+#endif
 
 	return EFI_SUCCESS;
 }
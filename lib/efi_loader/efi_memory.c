@@ -13,7 +13,8 @@
 #include <watchdog.h>
 #include <asm/cache.h>
 #include <asm/global_data.h>
-#include <linux/list_sort.h>
+#include <linux/build_bug.h>
+#include <linux/rbtree_augmented.h>
 #include <linux/sizes.h>
 
 DECLARE_GLOBAL_DATA_PTR;
@@ -21,19 +22,29 @@ DECLARE_GLOBAL_DATA_PTR;
 /* Magic number identifying memory allocated from pool */
 #define EFI_ALLOC_POOL_MAGIC 0x1fe67ddf6491caa2
 
+/* Pool pages are split into blocks of 64, 128, ..., 1024 bytes */
+#define EFI_POOL_MIN_SHIFT	6
+#define EFI_POOL_CLASSES	5
+
 efi_uintn_t efi_memory_map_key;
 
+/**
+ * struct efi_mem_list - memory map entry
+ *
+ * @rb:		node in the memory map tree, ordered by start address
+ * @desc:	memory descriptor
+ * @max_free:	size in pages of the largest free RAM entry in the subtree
+ */
 struct efi_mem_list {
-	struct list_head link;
+	struct rb_node rb;
 	struct efi_mem_desc desc;
+	u64 max_free;
 };
 
-#define EFI_CARVE_NO_OVERLAP		-1
-#define EFI_CARVE_LOOP_AGAIN		-2
-#define EFI_CARVE_OVERLAPS_NONRAM	-3
-
-/* This list contains all memory map items */
-LIST_HEAD(efi_mem);
+/* This tree contains all memory map items */
+static struct rb_root efi_mem = RB_ROOT;
+/* Number of memory map items */
+static efi_uintn_t efi_mem_entries;
 
 #ifdef CONFIG_EFI_LOADER_BOUNCE_BUFFER
 void *efi_bounce_buffer;
@@ -42,13 +53,14 @@ void *efi_bounce_buffer;
 /**
  * struct efi_pool_allocation - memory block allocated from pool
  *
- * @num_pages:	number of pages allocated
+ * @num_pages:	number of pages allocated, 0 for a block of a pool page
  * @checksum:	checksum
  * @data:	allocated pool memory
  *
- * U-Boot services each UEFI AllocatePool() request as a separate
- * (multiple) page allocation. We have to track the number of pages
- * to be able to free the correct amount later.
+ * U-Boot services small UEFI AllocatePool() requests from pool pages (see
+ * struct efi_pool_page) and larger ones as a separate (multiple) page
+ * allocation. We have to track the number of pages to be able to free the
+ * correct amount later.
  *
  * The checksum calculated in function checksum() is used in FreePool() to avoid
  * freeing memory not allocated by AllocatePool() and duplicate freeing.
@@ -62,6 +74,28 @@ struct efi_pool_allocation {
 	char data[] __aligned(ARCH_DMA_MINALIGN);
 };
 
+/**
+ * struct efi_pool_page - page split into pool blocks of equal size
+ *
+ * @link:	entry in the list of pool pages with free blocks
+ * @free:	first free block, the link to the next one is kept in its data
+ * @used:	number of blocks in use
+ * @class:	block size class, the block size is 64 << @class bytes
+ * @type:	memory type of the page
+ *
+ * The header occupies the first block of the page.
+ */
+struct efi_pool_page {
+	struct list_head link;
+	struct efi_pool_allocation *free;
+	u32 used;
+	u16 class;
+	u16 type;
+};
+
+/* Pool pages with free blocks for each memory type and size class */
+static struct list_head efi_pool_pages[EFI_MAX_MEMORY_TYPE][EFI_POOL_CLASSES];
+
 /**
  * checksum() - calculate checksum for memory allocated from pool
  *
@@ -78,156 +112,224 @@ static u64 checksum(struct efi_pool_allocation *alloc)
 	return ret;
 }
 
-/*
- * Sorts the memory list from highest address to lowest address
- *
- * When allocating memory we should always start from the highest
- * address chunk, so sort the memory list such that the first list
- * iterator gets the highest address and goes lower from there.
- */
-static int efi_mem_cmp(void *priv, struct list_head *a, struct list_head *b)
+static uint64_t desc_get_end(struct efi_mem_desc *desc)
 {
-	struct efi_mem_list *mema = list_entry(a, struct efi_mem_list, link);
-	struct efi_mem_list *memb = list_entry(b, struct efi_mem_list, link);
+	return desc->physical_start + (desc->num_pages << EFI_PAGE_SHIFT);
+}
 
-	if (mema->desc.physical_start == memb->desc.physical_start)
+static u64 efi_mem_free_pages(struct efi_mem_list *item)
+{
+	if (item->desc.type != EFI_CONVENTIONAL_MEMORY)
 		return 0;
-	else if (mema->desc.physical_start < memb->desc.physical_start)
-		return 1;
-	else
-		return -1;
+	return item->desc.num_pages;
 }
 
-static uint64_t desc_get_end(struct efi_mem_desc *desc)
+static u64 efi_mem_compute_max_free(struct efi_mem_list *item)
 {
-	return desc->physical_start + (desc->num_pages << EFI_PAGE_SHIFT);
+	u64 max_free = efi_mem_free_pages(item);
+	struct efi_mem_list *child;
+
+	if (item->rb.rb_left) {
+		child = rb_entry(item->rb.rb_left, struct efi_mem_list, rb);
+		max_free = max(max_free, child->max_free);
+	}
+	if (item->rb.rb_right) {
+		child = rb_entry(item->rb.rb_right, struct efi_mem_list, rb);
+		max_free = max(max_free, child->max_free);
+	}
+	return max_free;
 }
 
-static void efi_mem_sort(void)
+RB_DECLARE_CALLBACKS(static, efi_mem_cb, struct efi_mem_list, rb, u64,
+		     max_free, efi_mem_compute_max_free)
+
+static struct efi_mem_list *efi_mem_entry(struct rb_node *node)
 {
-	struct list_head *lhandle;
-	struct efi_mem_list *prevmem = NULL;
-	bool merge_again = true;
-
-	list_sort(NULL, &efi_mem, efi_mem_cmp);
-
-	/* Now merge entries that can be merged */
-	while (merge_again) {
-		merge_again = false;
-		list_for_each(lhandle, &efi_mem) {
-			struct efi_mem_list *lmem;
-			struct efi_mem_desc *prev = &prevmem->desc;
-			struct efi_mem_desc *cur;
-			uint64_t pages;
-
-			lmem = list_entry(lhandle, struct efi_mem_list, link);
-			if (!prevmem) {
-				prevmem = lmem;
-				continue;
-			}
+	return node ? rb_entry(node, struct efi_mem_list, rb) : NULL;
+}
 
-			cur = &lmem->desc;
-
-			if ((desc_get_end(cur) == prev->physical_start) &&
-			    (prev->type == cur->type) &&
-			    (prev->attribute == cur->attribute)) {
-				/* There is an existing map before, reuse it */
-				pages = cur->num_pages;
-				prev->num_pages += pages;
-				prev->physical_start -= pages << EFI_PAGE_SHIFT;
-				prev->virtual_start -= pages << EFI_PAGE_SHIFT;
-				list_del(&lmem->link);
-				free(lmem);
-
-				merge_again = true;
-				break;
-			}
+/**
+ * efi_mem_floor() - find the memory map item at or below an address
+ *
+ * @addr:	address
+ * Return:	item with the highest start address not above @addr or NULL
+ */
+static struct efi_mem_list *efi_mem_floor(u64 addr)
+{
+	struct rb_node *node = efi_mem.rb_node;
+	struct efi_mem_list *ret = NULL;
 
-			prevmem = lmem;
+	while (node) {
+		struct efi_mem_list *item = efi_mem_entry(node);
+
+		if (item->desc.physical_start <= addr) {
+			ret = item;
+			node = node->rb_right;
+		} else {
+			node = node->rb_left;
 		}
 	}
+
+	return ret;
+}
+
+/**
+ * efi_mem_insert() - insert an item into the memory map tree
+ *
+ * @item:	memory map item, must not overlap any other item
+ */
+static void efi_mem_insert(struct efi_mem_list *item)
+{
+	struct rb_node **link = &efi_mem.rb_node;
+	struct rb_node *parent = NULL;
+
+	while (*link) {
+		parent = *link;
+		if (item->desc.physical_start <
+		    efi_mem_entry(parent)->desc.physical_start)
+			link = &parent->rb_left;
+		else
+			link = &parent->rb_right;
+	}
+
+	item->max_free = efi_mem_free_pages(item);
+	rb_link_node(&item->rb, parent, link);
+	efi_mem_cb_propagate(parent, NULL);
+	rb_insert_augmented(&item->rb, &efi_mem, &efi_mem_cb);
+	++efi_mem_entries;
+}
+
+/**
+ * efi_mem_remove() - remove an item from the memory map tree and free it
+ *
+ * @item:	memory map item
+ */
+static void efi_mem_remove(struct efi_mem_list *item)
+{
+	rb_erase_augmented(&item->rb, &efi_mem, &efi_mem_cb);
+	--efi_mem_entries;
+	free(item);
+}
+
+/**
+ * efi_mem_merge() - merge a memory map item with its neighbours
+ *
+ * @item:	memory map item
+ *
+ * Adjacent items with the same type and attributes are combined. As this is
+ * done for each item added, the rest of the map never needs to be merged.
+ */
+static void efi_mem_merge(struct efi_mem_list *item)
+{
+	struct efi_mem_list *prev = efi_mem_entry(rb_prev(&item->rb));
+	struct efi_mem_list *next = efi_mem_entry(rb_next(&item->rb));
+
+	if (prev && desc_get_end(&prev->desc) == item->desc.physical_start &&
+	    prev->desc.type == item->desc.type &&
+	    prev->desc.attribute == item->desc.attribute) {
+		prev->desc.num_pages += item->desc.num_pages;
+		efi_mem_remove(item);
+		efi_mem_cb_propagate(&prev->rb, NULL);
+		item = prev;
+	}
+
+	if (next && desc_get_end(&item->desc) == next->desc.physical_start &&
+	    next->desc.type == item->desc.type &&
+	    next->desc.attribute == item->desc.attribute) {
+		item->desc.num_pages += next->desc.num_pages;
+		efi_mem_remove(next);
+		efi_mem_cb_propagate(&item->rb, NULL);
+	}
 }
 
-/** efi_mem_carve_out - unmap memory region
+/**
+ * efi_mem_carve_out() - unmap memory region
  *
- * @map:		memory map
- * @carve_desc:		memory region to unmap
+ * @carve_start:	start address of the region to unmap
+ * @carve_end:		end address of the region to unmap
  * @overlap_only_ram:	the carved out region may only overlap RAM
- * Return Value:	the number of overlapping pages which have been
- *			removed from the map,
- *			EFI_CARVE_NO_OVERLAP, if the regions don't overlap,
- *			EFI_CARVE_OVERLAPS_NONRAM, if the carve and map overlap,
- *			and the map contains anything but free ram
- *			(only when overlap_only_ram is true),
- *			EFI_CARVE_LOOP_AGAIN, if the mapping list should be
- *			traversed again, as it has been altered.
- *
- * Unmaps all memory occupied by the carve_desc region from the list entry
- * pointed to by map.
- *
- * In case of EFI_CARVE_OVERLAPS_NONRAM it is the callers responsibility
- * to re-add the already carved out pages to the mapping.
+ * Return:		status code
+ *
+ * Unmaps all memory occupied by the region, shrinking, splitting or removing
+ * the map items it overlaps. If @overlap_only_ram is true and the region is
+ * not completely covered by free RAM, EFI_NO_MAPPING is returned and the map
+ * is left unchanged.
  */
-static s64 efi_mem_carve_out(struct efi_mem_list *map,
-			     struct efi_mem_desc *carve_desc,
-			     bool overlap_only_ram)
+static efi_status_t efi_mem_carve_out(u64 carve_start, u64 carve_end,
+				      bool overlap_only_ram)
 {
-	struct efi_mem_list *newmap;
-	struct efi_mem_desc *map_desc = &map->desc;
-	uint64_t map_start = map_desc->physical_start;
-	uint64_t map_end = map_start + (map_desc->num_pages << EFI_PAGE_SHIFT);
-	uint64_t carve_start = carve_desc->physical_start;
-	uint64_t carve_end = carve_start +
-			     (carve_desc->num_pages << EFI_PAGE_SHIFT);
-
-	/* check whether we're overlapping */
-	if ((carve_end <= map_start) || (carve_start >= map_end))
-		return EFI_CARVE_NO_OVERLAP;
-
-	/* We're overlapping with non-RAM, warn the caller if desired */
-	if (overlap_only_ram && (map_desc->type != EFI_CONVENTIONAL_MEMORY))
-		return EFI_CARVE_OVERLAPS_NONRAM;
-
-	/* Sanitize carve_start and carve_end to lie within our bounds */
-	carve_start = max(carve_start, map_start);
-	carve_end = min(carve_end, map_end);
-
-	/* Carving at the beginning of our map? Just move it! */
-	if (carve_start == map_start) {
-		if (map_end == carve_end) {
-			/* Full overlap, just remove map */
-			list_del(&map->link);
-			free(map);
-		} else {
-			map->desc.physical_start = carve_end;
-			map->desc.virtual_start = carve_end;
-			map->desc.num_pages = (map_end - carve_end)
-					      >> EFI_PAGE_SHIFT;
+	struct efi_mem_list *first, *item, *next;
+
+	/* Find the first item overlapping the region */
+	first = efi_mem_floor(carve_start);
+	if (!first)
+		first = efi_mem_entry(rb_first(&efi_mem));
+	else if (desc_get_end(&first->desc) <= carve_start)
+		first = efi_mem_entry(rb_next(&first->rb));
+
+	if (overlap_only_ram) {
+		u64 pos = carve_start;
+
+		for (item = first;
+		     item && item->desc.physical_start < carve_end;
+		     item = efi_mem_entry(rb_next(&item->rb))) {
+			/*
+			 * We hit a non-RAM region or a hole between the map
+			 * items. Error out.
+			 */
+			if (item->desc.physical_start > pos ||
+			    item->desc.type != EFI_CONVENTIONAL_MEMORY)
+				return EFI_NO_MAPPING;
+			pos = desc_get_end(&item->desc);
 		}
-
-		return (carve_end - carve_start) >> EFI_PAGE_SHIFT;
+		if (pos < carve_end)
+			return EFI_NO_MAPPING;
 	}
 
-	/*
-	 * Overlapping maps, just split the list map at carve_start,
-	 * it will get moved or removed in the next iteration.
-	 *
-	 * [ map_desc |__carve_start__| newmap ]
-	 */
+	for (item = first;
+	     item && item->desc.physical_start < carve_end;
+	     item = next) {
+		struct efi_mem_desc *desc = &item->desc;
+		u64 map_start = desc->physical_start;
+		u64 map_end = desc_get_end(desc);
 
-	/* Create a new map from [ carve_start ... map_end ] */
-	newmap = calloc(1, sizeof(*newmap));
-	newmap->desc = map->desc;
-	newmap->desc.physical_start = carve_start;
-	newmap->desc.virtual_start = carve_start;
-	newmap->desc.num_pages = (map_end - carve_start) >> EFI_PAGE_SHIFT;
-	/* Insert before current entry (descending address order) */
-	list_add_tail(&newmap->link, &map->link);
+		next = efi_mem_entry(rb_next(&item->rb));
 
-	/* Shrink the map to [ map_start ... carve_start ] */
-	map_desc->num_pages = (carve_start - map_start) >> EFI_PAGE_SHIFT;
+		if (map_start < carve_start) {
+			if (map_end > carve_end) {
+				struct efi_mem_list *newmap;
 
-	return EFI_CARVE_LOOP_AGAIN;
+				/*
+				 * Carving out of the middle of the map, create
+				 * a new map from [ carve_end ... map_end ]
+				 */
+				newmap = calloc(1, sizeof(*newmap));
+				if (!newmap)
+					return EFI_OUT_OF_RESOURCES;
+				newmap->desc = *desc;
+				newmap->desc.physical_start = carve_end;
+				newmap->desc.virtual_start = carve_end;
+				newmap->desc.num_pages = (map_end - carve_end)
+							 >> EFI_PAGE_SHIFT;
+				efi_mem_insert(newmap);
+			}
+			/* Shrink the map to [ map_start ... carve_start ] */
+			desc->num_pages = (carve_start - map_start)
+					  >> EFI_PAGE_SHIFT;
+			efi_mem_cb_propagate(&item->rb, NULL);
+		} else if (map_end > carve_end) {
+			/* Carving at the beginning of our map? Just move it! */
+			desc->physical_start = carve_end;
+			desc->virtual_start = carve_end;
+			desc->num_pages = (map_end - carve_end) >> EFI_PAGE_SHIFT;
+			efi_mem_cb_propagate(&item->rb, NULL);
+		} else {
+			/* Full overlap, just remove map */
+			efi_mem_remove(item);
+		}
+	}
+
+	return EFI_SUCCESS;
 }
 
 /**
@@ -243,11 +345,9 @@ static efi_status_t efi_add_memory_map_pg(u64 start, u64 pages,
 					  int memory_type,
 					  bool overlap_only_ram)
 {
-	struct list_head *lhandle;
-	struct efi_mem_list *newlist;
-	bool carve_again;
-	uint64_t carved_pages = 0;
+	struct efi_mem_list *newmap;
 	struct efi_event *evt;
+	efi_status_t ret;
 
 	EFI_PRINT("%s: 0x%llx 0x%llx %d %s\n", __func__,
 		  start, pages, memory_type, overlap_only_ram ? "yes" : "no");
@@ -259,79 +359,38 @@ static efi_status_t efi_add_memory_map_pg(u64 start, u64 pages,
 		return EFI_SUCCESS;
 
 	++efi_memory_map_key;
-	newlist = calloc(1, sizeof(*newlist));
-	newlist->desc.type = memory_type;
-	newlist->desc.physical_start = start;
-	newlist->desc.virtual_start = start;
-	newlist->desc.num_pages = pages;
+	newmap = calloc(1, sizeof(*newmap));
+	if (!newmap)
+		return EFI_OUT_OF_RESOURCES;
+	newmap->desc.type = memory_type;
+	newmap->desc.physical_start = start;
+	newmap->desc.virtual_start = start;
+	newmap->desc.num_pages = pages;
 
 	switch (memory_type) {
 	case EFI_RUNTIME_SERVICES_CODE:
 	case EFI_RUNTIME_SERVICES_DATA:
-		newlist->desc.attribute = EFI_MEMORY_WB | EFI_MEMORY_RUNTIME;
+		newmap->desc.attribute = EFI_MEMORY_WB | EFI_MEMORY_RUNTIME;
 		break;
 	case EFI_MMAP_IO:
-		newlist->desc.attribute = EFI_MEMORY_RUNTIME;
+		newmap->desc.attribute = EFI_MEMORY_RUNTIME;
 		break;
 	default:
-		newlist->desc.attribute = EFI_MEMORY_WB;
+		newmap->desc.attribute = EFI_MEMORY_WB;
 		break;
 	}
 
-	/* Add our new map */
-	do {
-		carve_again = false;
-		list_for_each(lhandle, &efi_mem) {
-			struct efi_mem_list *lmem;
-			s64 r;
-
-			lmem = list_entry(lhandle, struct efi_mem_list, link);
-			r = efi_mem_carve_out(lmem, &newlist->desc,
-					      overlap_only_ram);
-			switch (r) {
-			case EFI_CARVE_OVERLAPS_NONRAM:
-				/*
-				 * The user requested to only have RAM overlaps,
-				 * but we hit a non-RAM region. Error out.
-				 */
-				return EFI_NO_MAPPING;
-			case EFI_CARVE_NO_OVERLAP:
-				/* Just ignore this list entry */
-				break;
-			case EFI_CARVE_LOOP_AGAIN:
-				/*
-				 * We split an entry, but need to loop through
-				 * the list again to actually carve it.
-				 */
-				carve_again = true;
-				break;
-			default:
-				/* We carved a number of pages */
-				carved_pages += r;
-				carve_again = true;
-				break;
-			}
-
-			if (carve_again) {
-				/* The list changed, we need to start over */
-				break;
-			}
-		}
-	} while (carve_again);
-
-	if (overlap_only_ram && (carved_pages != pages)) {
-		/*
-		 * The payload wanted to have RAM overlaps, but we overlapped
-		 * with an unallocated region. Error out.
-		 */
-		return EFI_NO_MAPPING;
+	/* Remove whatever is mapped in the region */
+	ret = efi_mem_carve_out(start, desc_get_end(&newmap->desc),
+				overlap_only_ram);
+	if (ret != EFI_SUCCESS) {
+		free(newmap);
+		return ret;
 	}
 
-	/* Add our new map */
-        list_add_tail(&newlist->link, &efi_mem);
-
-	/* And make sure memory is listed in descending order */
-	efi_mem_sort();
+	/* Add our new map and merge it with its neighbours */
+	efi_mem_insert(newmap);
+	efi_mem_merge(newmap);
 
 	/* Notify that the memory map was changed */
 	list_for_each_entry(evt, &efi_events, link) {
@@ -385,64 +444,68 @@ efi_status_t efi_add_memory_map(u64 start, u64 size, int memory_type)
  */
 static efi_status_t efi_check_allocated(u64 addr, bool must_be_allocated)
 {
-	struct efi_mem_list *item;
-
-	list_for_each_entry(item, &efi_mem, link) {
-		u64 start = item->desc.physical_start;
-		u64 end = start + (item->desc.num_pages << EFI_PAGE_SHIFT);
-
-		if (addr >= start && addr < end) {
-			if (must_be_allocated ^
-			    (item->desc.type == EFI_CONVENTIONAL_MEMORY))
-				return EFI_SUCCESS;
-			else
-				return EFI_NOT_FOUND;
+	struct efi_mem_list *item = efi_mem_floor(addr);
+
+	if (!item || addr >= desc_get_end(&item->desc))
+		return EFI_NOT_FOUND;
+
+	if (must_be_allocated ^ (item->desc.type == EFI_CONVENTIONAL_MEMORY))
+		return EFI_SUCCESS;
+	else
+		return EFI_NOT_FOUND;
+}
+
+/**
+ * efi_mem_find_free() - find free memory in a subtree of the memory map
+ *
+ * Subtrees without a large enough free RAM item are skipped, so that the
+ * search only descends along paths that can succeed.
+ *
+ * @node:	root of the subtree
+ * @len:	number of bytes needed, a multiple of EFI_PAGE_SIZE
+ * @max_addr:	highest end address, a multiple of EFI_PAGE_SIZE
+ * Return:	highest suitable start address or 0
+ */
+static u64 efi_mem_find_free(struct rb_node *node, u64 len, u64 max_addr)
+{
+	while (node) {
+		struct efi_mem_list *item = efi_mem_entry(node);
+		struct efi_mem_desc *desc = &item->desc;
+		u64 ret;
+
+		if ((item->max_free << EFI_PAGE_SHIFT) < len)
+			return 0;
+
+		/* Everything to the right starts above max_addr, too */
+		if (desc->physical_start < max_addr) {
+			/* Try the higher addresses first */
+			ret = efi_mem_find_free(node->rb_right, len, max_addr);
+			if (ret)
+				return ret;
+
+			if ((efi_mem_free_pages(item) << EFI_PAGE_SHIFT) >= len) {
+				ret = min(max_addr, desc_get_end(desc));
+				if (ret - desc->physical_start >= len)
+					return ret - len;
+			}
 		}
+
+		node = node->rb_left;
 	}
 
-	return EFI_NOT_FOUND;
+	return 0;
 }
 
 static uint64_t efi_find_free_memory(uint64_t len, uint64_t max_addr)
 {
-	struct list_head *lhandle;
-
 	/*
 	 * Prealign input max address, so we simplify our matching
 	 * logic below and can just reuse it as return pointer.
 	 */
 	max_addr &= ~EFI_PAGE_MASK;
 
-	list_for_each(lhandle, &efi_mem) {
-		struct efi_mem_list *lmem = list_entry(lhandle,
-			struct efi_mem_list, link);
-		struct efi_mem_desc *desc = &lmem->desc;
-		uint64_t desc_len = desc->num_pages << EFI_PAGE_SHIFT;
-		uint64_t desc_end = desc->physical_start + desc_len;
-		uint64_t curmax = min(max_addr, desc_end);
-		uint64_t ret = curmax - len;
-
-		/* We only take memory from free RAM */
-		if (desc->type != EFI_CONVENTIONAL_MEMORY)
-			continue;
-
-		/* Out of bounds for max_addr */
-		if ((ret + len) > max_addr)
-			continue;
-
-		/* Out of bounds for upper map limit */
-		if ((ret + len) > desc_end)
-			continue;
-
-		/* Out of bounds for lower map limit */
-		if (ret < desc->physical_start)
-			continue;
-
-		/* Return the highest address in this map within bounds */
-		return ret;
-	}
-
-	return 0;
+	/* Return the highest address within bounds */
+	return efi_mem_find_free(efi_mem.rb_node, len, max_addr);
 }
 
 /*
@@ -548,6 +611,107 @@ efi_status_t efi_free_pages(uint64_t memory, efi_uintn_t pages)
 	return ret;
 }
 
+/**
+ * efi_pool_class() - get the size class for a pool allocation
+ *
+ * @size:	number of bytes to be allocated
+ * Return:	size class or -1 if the allocation needs pages of its own
+ */
+static int efi_pool_class(efi_uintn_t size)
+{
+	int class;
+
+	if (size >= EFI_PAGE_SIZE)
+		return -1;
+
+	for (class = 0; class < EFI_POOL_CLASSES; ++class) {
+		if (sizeof(struct efi_pool_allocation) + size <=
+		    1UL << (EFI_POOL_MIN_SHIFT + class))
+			return class;
+	}
+
+	return -1;
+}
+
+/**
+ * efi_pool_alloc_block() - allocate a block from a pool page
+ *
+ * A new pool page is allocated if there is none with free blocks left.
+ *
+ * @pool_type:	memory type of the pool
+ * @class:	size class of the block
+ * Return:	allocated block or NULL
+ */
+static struct efi_pool_allocation *efi_pool_alloc_block(int pool_type,
+							int class)
+{
+	struct list_head *head = &efi_pool_pages[pool_type][class];
+	struct efi_pool_allocation *alloc;
+	struct efi_pool_page *page;
+
+	BUILD_BUG_ON(sizeof(struct efi_pool_page) > 1 << EFI_POOL_MIN_SHIFT);
+
+	if (list_empty(head)) {
+		ulong block = 1UL << (EFI_POOL_MIN_SHIFT + class);
+		ulong offset;
+		u64 addr;
+
+		if (efi_allocate_pages(EFI_ALLOCATE_ANY_PAGES, pool_type, 1,
+				       &addr) != EFI_SUCCESS)
+			return NULL;
+
+		page = (struct efi_pool_page *)(uintptr_t)addr;
+		page->free = NULL;
+		page->used = 0;
+		page->class = class;
+		page->type = pool_type;
+		/* The first block holds the page header */
+		for (offset = EFI_PAGE_SIZE - block; offset; offset -= block) {
+			alloc = (void *)page + offset;
+			alloc->num_pages = 0;
+			alloc->checksum = 0;
+			*(struct efi_pool_allocation **)alloc->data = page->free;
+			page->free = alloc;
+		}
+		list_add(&page->link, head);
+	}
+
+	page = list_first_entry(head, struct efi_pool_page, link);
+	alloc = page->free;
+	page->free = *(struct efi_pool_allocation **)alloc->data;
+	if (!page->free)
+		list_del(&page->link);
+	++page->used;
+
+	return alloc;
+}
+
+/**
+ * efi_pool_free_block() - return a block to its pool page
+ *
+ * The page is released when its last block is freed.
+ *
+ * @alloc:	block to be freed
+ * Return:	status code
+ */
+static efi_status_t efi_pool_free_block(struct efi_pool_allocation *alloc)
+{
+	struct efi_pool_page *page;
+
+	page = (struct efi_pool_page *)((uintptr_t)alloc & ~EFI_PAGE_MASK);
+	if (!page->free)
+		list_add(&page->link,
+			 &efi_pool_pages[page->type][page->class]);
+	*(struct efi_pool_allocation **)alloc->data = page->free;
+	page->free = alloc;
+
+	if (--page->used)
+		return EFI_SUCCESS;
+
+	list_del(&page->link);
+	return efi_free_pages((uintptr_t)page, 1);
+}
+
 /**
  * efi_allocate_pool - allocate memory from pool
  *
@@ -563,6 +727,7 @@ efi_status_t efi_allocate_pool(int pool_type, efi_uintn_t size, void **buffer)
 	struct efi_pool_allocation *alloc;
 	u64 num_pages = efi_size_in_pages(size +
 					  sizeof(struct efi_pool_allocation));
+	int class;
 
 	if (!buffer)
 		return EFI_INVALID_PARAMETER;
@@ -572,6 +737,16 @@ efi_status_t efi_allocate_pool(int pool_type, efi_uintn_t size, void **buffer)
 		return EFI_SUCCESS;
 	}
 
+	class = efi_pool_class(size);
+	if ((uint)pool_type < EFI_MAX_MEMORY_TYPE && class >= 0) {
+		alloc = efi_pool_alloc_block(pool_type, class);
+		if (!alloc)
+			return EFI_OUT_OF_RESOURCES;
+		alloc->checksum = checksum(alloc);
+		*buffer = alloc->data;
+		return EFI_SUCCESS;
+	}
+
 	r = efi_allocate_pages(EFI_ALLOCATE_ANY_PAGES, pool_type, num_pages,
 			       &addr);
 	if (r == EFI_SUCCESS) {
@@ -605,7 +780,7 @@ efi_status_t efi_free_pool(void *buffer)
 	alloc = container_of(buffer, struct efi_pool_allocation, data);
 
 	/* Check that this memory was allocated by efi_allocate_pool() */
-	if (((uintptr_t)alloc & EFI_PAGE_MASK) ||
+	if ((alloc->num_pages && ((uintptr_t)alloc & EFI_PAGE_MASK)) ||
 	    alloc->checksum != checksum(alloc)) {
 		printf("%s: illegal free 0x%p\n", __func__, buffer);
 		return EFI_INVALID_PARAMETER;
@@ -613,6 +788,9 @@ efi_status_t efi_free_pool(void *buffer)
 	/* Avoid double free */
 	alloc->checksum = 0;
 
+	if (!alloc->num_pages)
+		return efi_pool_free_block(alloc);
+
 	ret = efi_free_pages((uintptr_t)alloc, alloc->num_pages);
 
 	return ret;
@@ -636,8 +814,7 @@ efi_status_t efi_get_memory_map(efi_uintn_t *memory_map_size,
 				uint32_t *descriptor_version)
 {
 	efi_uintn_t map_size = 0;
-	int map_entries = 0;
-	struct list_head *lhandle;
+	struct rb_node *node;
 	efi_uintn_t provided_map_size;
 
 	if (!memory_map_size)
@@ -645,10 +822,7 @@ efi_status_t efi_get_memory_map(efi_uintn_t *memory_map_size,
 
 	provided_map_size = *memory_map_size;
 
-	list_for_each(lhandle, &efi_mem)
-		map_entries++;
-
-	map_size = map_entries * sizeof(struct efi_mem_desc);
+	map_size = efi_mem_entries * sizeof(struct efi_mem_desc);
 
 	*memory_map_size = map_size;
 
@@ -664,16 +838,9 @@ efi_status_t efi_get_memory_map(efi_uintn_t *memory_map_size,
 	if (!memory_map)
 		return EFI_INVALID_PARAMETER;
 
-	/* Copy list into array */
-	/* Return the list in ascending order */
-	memory_map = &memory_map[map_entries - 1];
-	list_for_each(lhandle, &efi_mem) {
-		struct efi_mem_list *lmem;
-
-		lmem = list_entry(lhandle, struct efi_mem_list, link);
-		*memory_map = lmem->desc;
-		memory_map--;
-	}
+	/* Copy the tree into an array in ascending order */
+	for (node = rb_first(&efi_mem); node; node = rb_next(node))
+		*memory_map++ = efi_mem_entry(node)->desc;
 
 	if (map_key)
 		*map_key = efi_memory_map_key;
@@ -794,6 +961,12 @@ static void add_u_boot_and_runtime(void)
 
 int efi_memory_init(void)
 {
+	int i, j;
+
+	for (i = 0; i < EFI_MAX_MEMORY_TYPE; i++)
+		for (j = 0; j < EFI_POOL_CLASSES; j++)
+			INIT_LIST_HEAD(&efi_pool_pages[i][j]);
+
 	efi_add_known_memory();
 
 	add_u_boot_and_runtime();
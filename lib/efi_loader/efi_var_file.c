@@ -19,6 +19,42 @@
 
 #define PART_STR_LEN 10
 
+/*
+ * Length of file ubootefi.var, i.e. where the next struct efi_var_journal
+ * record goes, or 0 if the file has to be rewritten as a whole
+ */
+static loff_t __maybe_unused efi_var_file_len;
+/* EFI system partition holding the file described by efi_var_file_len */
+static struct efi_system_partition __maybe_unused efi_var_file_esp;
+
+/**
+ * efi_var_file_set_len() - record the length of the variables file
+ *
+ * @len:	length of the file on the current EFI system partition, 0 if
+ *		unknown
+ */
+static void __maybe_unused efi_var_file_set_len(loff_t len)
+{
+	efi_var_file_len = len;
+	efi_var_file_esp = efi_system_partition;
+}
+
+/**
+ * efi_var_file_get_len() - get the length of the variables file
+ *
+ * Return:	length of the file, 0 if it is not known or the EFI system
+ *		partition has changed since it was read or written
+ */
+static loff_t __maybe_unused efi_var_file_get_len(void)
+{
+	if (efi_var_file_esp.if_type != efi_system_partition.if_type ||
+	    efi_var_file_esp.devnum != efi_system_partition.devnum ||
+	    efi_var_file_esp.part != efi_system_partition.part)
+		return 0;
+
+	return efi_var_file_len;
+}
+
 /**
  * efi_set_blk_dev_to_system_partition() - select EFI system partition
  *
@@ -141,6 +177,7 @@ efi_status_t efi_var_to_file(void)
 error:
 	if (ret != EFI_SUCCESS)
 		log_err("Failed to persist EFI variables\n");
+	efi_var_file_set_len(ret == EFI_SUCCESS ? len : 0);
 	free(buf);
 	return ret;
 #else
@@ -148,6 +185,64 @@ error:
 #endif
 }
 
+efi_status_t efi_var_append_to_file(u16 *variable_name,
+				    const efi_guid_t *vendor)
+{
+#ifdef CONFIG_EFI_VARIABLE_FILE_STORE
+	struct efi_var_journal *rec;
+	struct efi_var_entry *var;
+	size_t name_size, size, len;
+	efi_status_t ret;
+	loff_t actlen, pos;
+	int r;
+
+	pos = efi_var_file_get_len();
+	if (!IS_ENABLED(CONFIG_EFI_VARIABLE_FILE_JOURNAL) || !pos)
+		return efi_var_to_file();
+
+	var = efi_var_mem_find(vendor, variable_name, NULL);
+	name_size = (u16_strlen(variable_name) + 1) * sizeof(u16);
+	size = sizeof(struct efi_var_entry) + name_size;
+	if (var)
+		size += var->length;
+	len = ALIGN(sizeof(*rec) + size, 8);
+
+	/* Compact the file once the journal has filled it */
+	if (pos + len > EFI_VAR_BUF_SIZE)
+		return efi_var_to_file();
+
+	rec = calloc(1, len);
+	if (!rec)
+		return EFI_OUT_OF_RESOURCES;
+	rec->magic = EFI_VAR_JOURNAL_MAGIC;
+	if (var) {
+		memcpy(rec->var, var, size);
+	} else {
+		/* The variable has been deleted */
+		guidcpy(&rec->var->guid, vendor);
+		memcpy(rec->var->name, variable_name, name_size);
+	}
+	rec->crc32 = crc32(0, (u8 *)rec->var, len - sizeof(*rec));
+
+	ret = efi_set_blk_dev_to_system_partition();
+	if (ret != EFI_SUCCESS)
+		goto error;
+
+	r = fs_write(EFI_VAR_FILE_NAME, map_to_sysmem(rec), pos, len, &actlen);
+	if (r || len != actlen)
+		ret = EFI_DEVICE_ERROR;
+
+error:
+	if (ret != EFI_SUCCESS)
+		log_err("Failed to persist EFI variables\n");
+	efi_var_file_set_len(ret == EFI_SUCCESS ? pos + len : 0);
+	free(rec);
+	return ret;
+#else
+	return EFI_SUCCESS;
+#endif
+}
+
 efi_status_t efi_var_restore(struct efi_var_file *buf)
 {
 	struct efi_var_entry *var, *last_var;
@@ -179,6 +274,58 @@ efi_status_t efi_var_restore(struct efi_var_file *buf)
 	return EFI_SUCCESS;
 }
 
+/**
+ * efi_var_replay() - apply the journal records of the variables file
+ *
+ * Records are applied until the end of the file or up to the first record
+ * which is incomplete or corrupted, e.g. by a power loss while writing it.
+ *
+ * @buf:	variables file, the snapshot must already have been restored
+ * @len:	length of the file
+ * Return:	length of the file up to the end of the last good record
+ */
+static loff_t __maybe_unused efi_var_replay(struct efi_var_file *buf,
+					    loff_t len)
+{
+	loff_t pos = buf->length;
+
+	while (pos + sizeof(struct efi_var_journal) +
+	       sizeof(struct efi_var_entry) < len) {
+		struct efi_var_journal *rec;
+		struct efi_var_entry *var, *old;
+		size_t max, name_len;
+		loff_t rec_len;
+		u16 *data;
+
+		rec = (struct efi_var_journal *)((u8 *)buf + pos);
+		var = rec->var;
+		max = ((u8 *)buf + len - (u8 *)var->name) / sizeof(u16);
+		name_len = u16_strnlen(var->name, max);
+		if (rec->magic != EFI_VAR_JOURNAL_MAGIC || name_len == max)
+			break;
+		data = var->name + name_len + 1;
+		rec_len = ALIGN((uintptr_t)data + var->length, 8) -
+			  (uintptr_t)rec;
+		if (pos + rec_len > len ||
+		    rec->crc32 != crc32(0, (u8 *)var,
+					rec_len - sizeof(*rec)))
+			break;
+
+		old = efi_var_mem_find(&var->guid, var->name, NULL);
+		if (var->length &&
+		    efi_var_mem_ins(var->name, &var->guid, var->attr,
+				    var->length, data, 0, NULL,
+				    var->time) != EFI_SUCCESS) {
+			log_err("Failed to set EFI variable %ls\n", var->name);
+			break;
+		}
+		efi_var_mem_del(old);
+		pos += rec_len;
+	}
+
+	return pos;
+}
+
 /**
  * efi_var_from_file() - read variables from file
  *
@@ -198,6 +345,7 @@ efi_status_t efi_var_from_file(void)
 	efi_status_t ret;
 	int r;
 
+	efi_var_file_set_len(0);
 	buf = calloc(1, EFI_VAR_BUF_SIZE);
 	if (!buf) {
 		log_err("Out of memory\n");
@@ -213,8 +361,12 @@ efi_status_t efi_var_from_file(void)
 		log_err("Failed to load EFI variables\n");
 		goto error;
 	}
-	if (buf->length != len || efi_var_restore(buf) != EFI_SUCCESS)
+	if (buf->length > len || efi_var_restore(buf) != EFI_SUCCESS) {
 		log_err("Invalid EFI variables file\n");
+		goto error;
+	}
+	/* A damaged journal is discarded on the next write */
+	efi_var_file_set_len(efi_var_replay(buf, len) == len ? len : 0);
 error:
 	free(buf);
 #endif
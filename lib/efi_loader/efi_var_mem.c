@@ -19,6 +19,118 @@
 static struct efi_var_file __efi_runtime_data *efi_var_buf;
 static struct efi_var_entry __efi_runtime_data *efi_current_var;
 
+/*
+ * Hash index over the variables in efi_var_buf, using linear probing. Each
+ * slot holds the offset of a variable relative to efi_var_buf, so that the
+ * index stays valid across SetVirtualAddressMap(), or 0 if it is unused.
+ * A variable entry takes at least 40 bytes, so the table is never more
+ * than 80% full.
+ */
+#define EFI_VAR_IDX_SLOTS	(EFI_VAR_BUF_SIZE / 32)
+
+static u32 __efi_runtime_data *efi_var_idx;
+
+/**
+ * efi_var_mem_hash() - get the index slot for a variable
+ *
+ * @guid:	vendor GUID
+ * @name:	variable name
+ * Return:	first slot to probe
+ */
+static u32 __efi_runtime efi_var_mem_hash(const efi_guid_t *guid,
+					  const u16 *name)
+{
+	const u8 *p = (const u8 *)guid;
+	u32 hash = 2166136261U;
+	int i;
+
+	/* FNV-1a */
+	for (i = 0; i < sizeof(efi_guid_t); ++i)
+		hash = (hash ^ p[i]) * 16777619U;
+	for (; *name; ++name)
+		hash = (hash ^ *name) * 16777619U;
+
+	return hash % EFI_VAR_IDX_SLOTS;
+}
+
+/**
+ * efi_var_mem_idx_add() - add a variable to the hash index
+ *
+ * @var:	variable in efi_var_buf
+ */
+static void __efi_runtime efi_var_mem_idx_add(struct efi_var_entry *var)
+{
+	u32 slot = efi_var_mem_hash(&var->guid, var->name);
+
+	while (efi_var_idx[slot])
+		slot = (slot + 1) % EFI_VAR_IDX_SLOTS;
+	efi_var_idx[slot] = (uintptr_t)var - (uintptr_t)efi_var_buf;
+}
+
+/**
+ * efi_var_mem_idx_del() - remove a variable from the hash index
+ *
+ * The following slots of the probe sequence are moved up, so that no
+ * tombstones are needed. Afterwards the offsets of all variables behind
+ * @var are reduced by @size, as efi_var_mem_del() moves them down.
+ *
+ * @var:	variable in efi_var_buf
+ * @size:	size of the entry of @var
+ */
+static void __efi_runtime efi_var_mem_idx_del(struct efi_var_entry *var,
+					      u32 size)
+{
+	u32 offset = (uintptr_t)var - (uintptr_t)efi_var_buf;
+	u32 hole, slot, home;
+
+	hole = efi_var_mem_hash(&var->guid, var->name);
+	while (efi_var_idx[hole] != offset) {
+		if (!efi_var_idx[hole])
+			return;
+		hole = (hole + 1) % EFI_VAR_IDX_SLOTS;
+	}
+	efi_var_idx[hole] = 0;
+
+	for (slot = (hole + 1) % EFI_VAR_IDX_SLOTS; efi_var_idx[slot];
+	     slot = (slot + 1) % EFI_VAR_IDX_SLOTS) {
+		struct efi_var_entry *moved = (struct efi_var_entry *)
+			((uintptr_t)efi_var_buf + efi_var_idx[slot]);
+
+		home = efi_var_mem_hash(&moved->guid, moved->name);
+		/* Move the entry if the hole lies on its probe sequence */
+		if ((slot > hole && (home <= hole || home > slot)) ||
+		    (slot < hole && home <= hole && home > slot)) {
+			efi_var_idx[hole] = efi_var_idx[slot];
+			efi_var_idx[slot] = 0;
+			hole = slot;
+		}
+	}
+
+	for (slot = 0; slot < EFI_VAR_IDX_SLOTS; ++slot) {
+		if (efi_var_idx[slot] > offset)
+			efi_var_idx[slot] -= size;
+	}
+}
+
+/**
+ * efi_var_mem_idx_rebuild() - rebuild the hash index from efi_var_buf
+ */
+static void efi_var_mem_idx_rebuild(void)
+{
+	struct efi_var_entry *var, *last;
+
+	memset(efi_var_idx, 0, EFI_VAR_IDX_SLOTS * sizeof(u32));
+	last = (struct efi_var_entry *)
+	       ((uintptr_t)efi_var_buf + efi_var_buf->length);
+	for (var = efi_var_buf->var; var < last;) {
+		u16 *data = var->name + u16_strlen(var->name) + 1;
+
+		efi_var_mem_idx_add(var);
+		var = (struct efi_var_entry *)
+		      ALIGN((uintptr_t)data + var->length, 8);
+	}
+}
+
 /**
  * efi_var_mem_compare() - compare GUID and name with a variable
  *
@@ -65,6 +177,7 @@ struct efi_var_entry __efi_runtime
 		  struct efi_var_entry **next)
 {
 	struct efi_var_entry *var, *last;
+	u32 slot;
 
 	last = (struct efi_var_entry *)
 	       ((uintptr_t)efi_var_buf + efi_var_buf->length);
@@ -84,21 +197,14 @@ struct efi_var_entry __efi_runtime
 		return efi_current_var;
 	}
 
-	var = efi_var_buf->var;
-	if (var < last) {
-		for (; var;) {
-			struct efi_var_entry *pos;
-			bool match;
-
-			match = efi_var_mem_compare(var, guid, name, &pos);
-			if (pos >= last)
-				pos = NULL;
-			if (match) {
-				if (next)
-					*next = pos;
-				return var;
-			}
-			var = pos;
+	for (slot = efi_var_mem_hash(guid, name); efi_var_idx[slot];
+	     slot = (slot + 1) % EFI_VAR_IDX_SLOTS) {
+		var = (struct efi_var_entry *)
+		      ((uintptr_t)efi_var_buf + efi_var_idx[slot]);
+		if (efi_var_mem_compare(var, guid, name, next)) {
+			if (next && *next >= last)
+				*next = NULL;
+			return var;
 		}
 	}
 	if (next)
@@ -124,6 +230,7 @@ void __efi_runtime efi_var_mem_del(struct efi_var_entry *var)
 	++data;
 	next = (struct efi_var_entry *)
 	       ALIGN((uintptr_t)data + var->length, 8);
+	efi_var_mem_idx_del(var, (uintptr_t)next - (uintptr_t)var);
 	efi_var_buf->length -= (uintptr_t)next - (uintptr_t)var;
 
 	/* efi_memcpy_runtime() can be used because next >= var. */
@@ -164,6 +271,7 @@ efi_status_t __efi_runtime efi_var_mem_ins(
 			   sizeof(u16) * var_name_len);
 	efi_memcpy_runtime(data, data1, size1);
 	efi_memcpy_runtime((u8 *)data + size1, data2, size2);
+	efi_var_mem_idx_add(var);
 
 	var = (struct efi_var_entry *)
 	      ALIGN((uintptr_t)data + var->length, 8);
@@ -238,6 +346,7 @@ static void EFIAPI __efi_runtime
 efi_var_mem_notify_virtual_address_map(struct efi_event *event, void *context)
 {
 	efi_convert_pointer(0, (void **)&efi_var_buf);
+	efi_convert_pointer(0, (void **)&efi_var_idx);
 	efi_current_var = NULL;
 }
 
@@ -260,6 +369,16 @@ efi_status_t efi_var_mem_init(void)
 			      (uintptr_t)efi_var_buf;
 	/* crc32 for 0 bytes = 0 */
 
+	ret = efi_allocate_pages(EFI_ALLOCATE_ANY_PAGES,
+				 EFI_RUNTIME_SERVICES_DATA,
+				 efi_size_in_pages(EFI_VAR_IDX_SLOTS *
+						   sizeof(u32)),
+				 &memory);
+	if (ret != EFI_SUCCESS)
+		return ret;
+	efi_var_idx = (u32 *)(uintptr_t)memory;
+	memset(efi_var_idx, 0, EFI_VAR_IDX_SLOTS * sizeof(u32));
+
 	ret = efi_create_event(EVT_SIGNAL_EXIT_BOOT_SERVICES, TPL_CALLBACK,
 			       efi_var_mem_notify_exit_boot_services, NULL,
 			       NULL, &event);
@@ -349,4 +468,6 @@ efi_get_next_variable_name_mem(efi_uintn_t *variable_name_size,
 void efi_var_buf_update(struct efi_var_file *var_buf)
 {
 	memcpy(efi_var_buf, var_buf, EFI_VAR_BUF_SIZE);
+	efi_current_var = NULL;
+	efi_var_mem_idx_rebuild();
 }
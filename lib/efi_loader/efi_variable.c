@@ -336,7 +336,7 @@ efi_status_t efi_set_variable_int(u16 *variable_name, const efi_guid_t *vendor,
 	/* Write non-volatile EFI variables to file */
 	if (attributes & EFI_VARIABLE_NON_VOLATILE &&
 	    ret == EFI_SUCCESS && efi_obj_list_initialized == EFI_SUCCESS)
-		efi_var_to_file();
+		efi_var_append_to_file(variable_name, vendor);
 
 	return EFI_SUCCESS;
 }
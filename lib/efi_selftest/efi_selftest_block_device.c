@@ -11,6 +11,7 @@
  * ConnectController is used to setup partitions and to install the simple
  * file protocol.
  * A known file is read from the file system and verified.
+ * A block of the partition is read with the block I/O 2 protocol.
  */
 
 #include <efi_selftest.h>
@@ -26,6 +27,7 @@
 static struct efi_boot_services *boottime;
 
 static const efi_guid_t block_io_protocol_guid = EFI_BLOCK_IO_PROTOCOL_GUID;
+static const efi_guid_t block_io2_protocol_guid = EFI_BLOCK_IO2_PROTOCOL_GUID;
 static const efi_guid_t guid_device_path = EFI_DEVICE_PATH_PROTOCOL_GUID;
 static const efi_guid_t guid_simple_file_system_protocol =
 					EFI_SIMPLE_FILE_SYSTEM_PROTOCOL_GUID;
@@ -53,6 +55,9 @@ static const struct compressed_disk_image img = EFI_ST_DISK_IMG;
 /* Decompressed disk image */
 static u8 *image;
 
+/* Buffer for reading a block, aligned as required by the partition */
+static u8 block[1 << LB_BLOCK_SIZE] __aligned(1 << LB_BLOCK_SIZE);
+
 /*
  * Reset service of the block IO protocol.
  *
@@ -302,6 +307,8 @@ static int execute(void)
 	efi_handle_t handle_partition = NULL;
 	struct efi_device_path *dp_partition;
 	struct efi_block_io *block_io_protocol;
+	struct efi_block_io2 *block_io2_protocol;
+	struct efi_block_io2_token token;
 	struct efi_simple_file_system_protocol *file_system;
 	struct efi_file_handle *root, *file;
 	struct {
@@ -310,7 +317,7 @@ static int execute(void)
 	} system_info;
 	efi_uintn_t buf_size;
 	char buf[16] __aligned(ARCH_DMA_MINALIGN);
-	u32 part1_size;
+	u32 part1_start, part1_size;
 	u64 pos;
 
 	/* Connect controller to virtual disk */
@@ -372,6 +379,49 @@ static int execute(void)
 			     part1_size - 1);
 		return EFI_ST_FAILURE;
 	}
+	/* Read the first block of the partition without blocking */
+	ret = boottime->open_protocol(handle_partition,
+				      &block_io2_protocol_guid,
+				      (void **)&block_io2_protocol, NULL, NULL,
+				      EFI_OPEN_PROTOCOL_GET_PROTOCOL);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to open block IO 2 protocol\n");
+		return EFI_ST_FAILURE;
+	}
+	ret = boottime->create_event(0, TPL_CALLBACK, NULL, NULL, &token.event);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to create event\n");
+		return EFI_ST_FAILURE;
+	}
+	token.transaction_status = EFI_NOT_READY;
+	ret = block_io2_protocol->read_blocks_ex(
+				block_io2_protocol,
+				block_io2_protocol->media->media_id, 0,
+				&token, sizeof(block), block);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("ReadBlocksEx failed\n");
+		return EFI_ST_FAILURE;
+	}
+	ret = boottime->wait_for_event(1, &token.event, &i);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to wait for event\n");
+		return EFI_ST_FAILURE;
+	}
+	ret = boottime->close_event(token.event);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to close event\n");
+		return EFI_ST_FAILURE;
+	}
+	if (token.transaction_status != EFI_SUCCESS) {
+		efi_st_error("ReadBlocksEx transaction failed\n");
+		return EFI_ST_FAILURE;
+	}
+	memcpy(&part1_start, image + 0x1c6, sizeof(u32));
+	if (memcmp(block, image + (part1_start << LB_BLOCK_SIZE),
+		   sizeof(block))) {
+		efi_st_error("Unexpected block content\n");
+		return EFI_ST_FAILURE;
+	}
 	/* Open the simple file system protocol */
 	ret = boottime->open_protocol(handle_partition,
 				      &guid_simple_file_system_protocol,
@@ -11,6 +11,7 @@
 #include <bootstage.h>
 #include <hang.h>
 #include <os.h>
+#include <serial.h>
 
 /**
  * hang - stop processing by staying in an endless loop
@@ -27,6 +28,7 @@ void hang(void)
 		 CONFIG_IS_ENABLED(SERIAL_SUPPORT))
 	puts("### ERROR ### Please RESET the board ###\n");
 #endif
+	serial_flush();
 	bootstage_error(BOOTSTAGE_ID_NEED_RESET);
 	if (IS_ENABLED(CONFIG_SANDBOX))
 		os_exit(1);
@@ -578,7 +578,8 @@ void * memmove(void * dest,const void *src,size_t count)
 	 *          implementation is not doing a forward-copying.
 	 *
 	 * No issue today because memcpy is doing a forward-copying in lib/string.c and for ARM32
-	 * architecture; no other arches use __HAVE_ARCH_MEMCPY without __HAVE_ARCH_MEMMOVE.
+	 * and RISC-V architectures; no other arches use __HAVE_ARCH_MEMCPY without
+	 * __HAVE_ARCH_MEMMOVE.
 	 */
 		memcpy(dest, src, count);
 	} else {
@@ -9,6 +9,7 @@
 #include <dm.h>
 #include <errno.h>
 #include <init.h>
+#include <serial.h>
 #include <spl.h>
 #include <time.h>
 #include <timer.h>
@@ -195,6 +196,7 @@ void udelay(unsigned long usec)
 
 	do {
 		WATCHDOG_RESET();
+		serial_tx_poll();
 		kv = usec > CONFIG_WD_PERIOD ? CONFIG_WD_PERIOD : usec;
 		__udelay(kv);
 		usec -= kv;
@@ -40,12 +40,108 @@ static uint32_t overlay_get_target_phandle(const void *fdto, int fragment)
 	return fdt32_to_cpu(*val);
 }
 
+/**
+ * overlay_index_add - records the offset of a node with a phandle
+ * @idx: phandle index, or NULL
+ * @phandle: phandle of the node
+ * @offset: offset of the node in the base device tree
+ *
+ * overlay_index_add() adds a node to the index, unless its phandle is
+ * already there or the index is three-quarters full. Lookups of phandles
+ * which are not in the index fall back to walking the tree.
+ */
+static void overlay_index_add(struct fdt_overlay_index *idx,
+			      uint32_t phandle, int offset)
+{
+	int i;
+
+	if (!idx || !idx->ents || !phandle || phandle == (uint32_t)-1)
+		return;
+	if (idx->count >= idx->size - idx->size / 4)
+		return;
+
+	for (i = phandle % idx->size; idx->ents[i].phandle;
+	     i = (i + 1) % idx->size) {
+		if (idx->ents[i].phandle == phandle)
+			return;
+	}
+	idx->ents[i].phandle = phandle;
+	idx->ents[i].offset = offset;
+	idx->count++;
+}
+
+/**
+ * overlay_index_lookup - finds the node with a given phandle
+ * @fdt: Base device tree blob
+ * @idx: phandle index, or NULL
+ * @phandle: phandle to look up
+ *
+ * overlay_index_lookup() is the same as fdt_node_offset_by_phandle(),
+ * but checks the index first.
+ *
+ * returns:
+ *      the node offset in the base device tree
+ *      Negative error code on error
+ */
+static int overlay_index_lookup(const void *fdt, struct fdt_overlay_index *idx,
+				uint32_t phandle)
+{
+	int i, n;
+
+	if (!idx || !idx->ents || !phandle || phandle == (uint32_t)-1)
+		return fdt_node_offset_by_phandle(fdt, phandle);
+
+	for (i = phandle % idx->size, n = 0;
+	     idx->ents[i].phandle && n < idx->size;
+	     i = (i + 1) % idx->size, n++) {
+		if (idx->ents[i].phandle != phandle)
+			continue;
+
+		/* The node may have lost its phandle since it was added */
+		if (fdt_get_phandle(fdt, idx->ents[i].offset) == phandle)
+			return idx->ents[i].offset;
+		break;
+	}
+
+	return fdt_node_offset_by_phandle(fdt, phandle);
+}
+
+/**
+ * overlay_index_shift - updates the index after a change to the base tree
+ * @fdt: Base device tree blob
+ * @idx: phandle index, or NULL
+ * @node: node offset in the base device tree which was changed
+ * @old_size: size of the structure block before the change
+ *
+ * Adding or resizing a property or adding a subnode inserts or removes
+ * space inside a node, after its own start, so every node at a higher
+ * offset moves by the same amount.
+ */
+static void overlay_index_shift(const void *fdt, struct fdt_overlay_index *idx,
+				int node, int old_size)
+{
+	int delta, i;
+
+	if (!idx || !idx->ents)
+		return;
+
+	delta = fdt_size_dt_struct(fdt) - old_size;
+	if (!delta)
+		return;
+
+	for (i = 0; i < idx->size; i++) {
+		if (idx->ents[i].phandle && idx->ents[i].offset > node)
+			idx->ents[i].offset += delta;
+	}
+}
+
 /**
  * overlay_get_target - retrieves the offset of a fragment's target
  * @fdt: Base device tree blob
  * @fdto: Device tree overlay blob
  * @fragment: node offset of the fragment in the overlay
  * @pathp: pointer which receives the path of the target (or NULL)
+ * @idx: phandle index, or NULL
  *
  * overlay_get_target() retrieves the target offset in the base
  * device tree of a fragment, no matter how the actual targeting is
@@ -56,7 +152,8 @@ static uint32_t overlay_get_target_phandle(const void *fdto, int fragment)
  *      Negative error code on error
  */
 static int overlay_get_target(const void *fdt, const void *fdto,
-			      int fragment, char const **pathp)
+			      int fragment, char const **pathp,
+			      struct fdt_overlay_index *idx)
 {
 	uint32_t phandle;
 	const char *path = NULL;
@@ -76,7 +173,7 @@ static int overlay_get_target(const void *fdt, const void *fdto,
 		else
 			ret = path_len;
 	} else
-		ret = fdt_node_offset_by_phandle(fdt, phandle);
+		ret = overlay_index_lookup(fdt, idx, phandle);
 
 	/*
 	* If we haven't found either a target or a
@@ -541,6 +638,7 @@ static int overlay_fixup_phandles(void *fdt, void *fdto)
  * @target: Node offset in the base device tree to apply the fragment to
  * @fdto: Device tree overlay blob
  * @node: Node offset in the overlay holding the changes to merge
+ * @idx: phandle index to keep up to date, or NULL
  *
  * overlay_apply_node() merges a node into a target base device tree
  * node pointed.
@@ -555,10 +653,12 @@ static int overlay_fixup_phandles(void *fdt, void *fdto)
  *      Negative error code on failure
  */
 static int overlay_apply_node(void *fdt, int target,
-			      void *fdto, int node)
+			      void *fdto, int node,
+			      struct fdt_overlay_index *idx)
 {
 	int property;
 	int subnode;
+	int size;
 
 	fdt_for_each_property_offset(property, fdto, node) {
 		const char *name;
@@ -573,9 +673,11 @@ static int overlay_apply_node(void *fdt, int target,
 		if (prop_len < 0)
 			return prop_len;
 
+		size = fdt_size_dt_struct(fdt);
 		ret = fdt_setprop(fdt, target, name, prop, prop_len);
 		if (ret)
 			return ret;
+		overlay_index_shift(fdt, idx, target, size);
 	}
 
 	fdt_for_each_subnode(subnode, fdto, node) {
@@ -583,6 +685,7 @@ static int overlay_apply_node(void *fdt, int target,
 		int nnode;
 		int ret;
 
+		size = fdt_size_dt_struct(fdt);
 		nnode = fdt_add_subnode(fdt, target, name);
 		if (nnode == -FDT_ERR_EXISTS) {
 			nnode = fdt_subnode_offset(fdt, target, name);
@@ -592,12 +695,16 @@ static int overlay_apply_node(void *fdt, int target,
 
 		if (nnode < 0)
 			return nnode;
+		overlay_index_shift(fdt, idx, target, size);
 
-		ret = overlay_apply_node(fdt, nnode, fdto, subnode);
+		ret = overlay_apply_node(fdt, nnode, fdto, subnode, idx);
 		if (ret)
 			return ret;
 	}
 
+	/* Later overlays may target this node by its new phandle */
+	overlay_index_add(idx, fdt_get_phandle(fdt, target), target);
+
 	return 0;
 }
 
@@ -605,6 +712,7 @@ static int overlay_apply_node(void *fdt, int target,
  * overlay_merge - Merge an overlay into its base device tree
  * @fdt: Base Device Tree blob
  * @fdto: Device tree overlay blob
+ * @idx: phandle index, or NULL
  *
  * overlay_merge() merges an overlay into its base device tree.
  *
@@ -616,7 +724,7 @@ static int overlay_apply_node(void *fdt, int target,
  *      0 on success
  *      Negative error code on failure
  */
-static int overlay_merge(void *fdt, void *fdto)
+static int overlay_merge(void *fdt, void *fdto, struct fdt_overlay_index *idx)
 {
 	int fragment;
 
@@ -636,11 +744,11 @@ static int overlay_merge(void *fdt, void *fdto)
 		if (overlay < 0)
 			return overlay;
 
-		target = overlay_get_target(fdt, fdto, fragment, NULL);
+		target = overlay_get_target(fdt, fdto, fragment, NULL, idx);
 		if (target < 0)
 			return target;
 
-		ret = overlay_apply_node(fdt, target, fdto, overlay);
+		ret = overlay_apply_node(fdt, target, fdto, overlay, idx);
 		if (ret)
 			return ret;
 	}
@@ -680,6 +788,7 @@ static int get_path_len(const void *fdt, int nodeoffset)
  * overlay_symbol_update - Update the symbols of base tree after a merge
  * @fdt: Base Device Tree blob
  * @fdto: Device tree overlay blob
+ * @idx: phandle index, or NULL
  *
  * overlay_symbol_update() updates the symbols of the base tree with the
  * symbols of the applied overlay
@@ -692,10 +801,11 @@ static int get_path_len(const void *fdt, int nodeoffset)
  *      0 on success
  *      Negative error code on failure
  */
-static int overlay_symbol_update(void *fdt, void *fdto)
+static int overlay_symbol_update(void *fdt, void *fdto,
+				 struct fdt_overlay_index *idx)
 {
 	int root_sym, ov_sym, prop, path_len, fragment, target;
-	int len, frag_name_len, ret, rel_path_len;
+	int len, frag_name_len, ret, rel_path_len, size;
 	const char *s, *e;
 	const char *path;
 	const char *name;
@@ -714,8 +824,12 @@ static int overlay_symbol_update(void *fdt, void *fdto)
 	root_sym = fdt_subnode_offset(fdt, 0, "__symbols__");
 
 	/* it no root symbols exist we should create them */
-	if (root_sym == -FDT_ERR_NOTFOUND)
+	if (root_sym == -FDT_ERR_NOTFOUND) {
+		size = fdt_size_dt_struct(fdt);
 		root_sym = fdt_add_subnode(fdt, 0, "__symbols__");
+		if (root_sym >= 0)
+			overlay_index_shift(fdt, idx, 0, size);
+	}
 
 	/* any error is fatal now */
 	if (root_sym < 0)
@@ -779,7 +893,8 @@ static int overlay_symbol_update(void *fdt, void *fdto)
 			return -FDT_ERR_BADOVERLAY;
 
 		/* get the target of the fragment */
-		ret = overlay_get_target(fdt, fdto, fragment, &target_path);
+		ret = overlay_get_target(fdt, fdto, fragment, &target_path,
+					 idx);
 		if (ret < 0)
 			return ret;
 		target = ret;
@@ -794,14 +909,17 @@ static int overlay_symbol_update(void *fdt, void *fdto)
 			len = strlen(target_path);
 		}
 
+		size = fdt_size_dt_struct(fdt);
 		ret = fdt_setprop_placeholder(fdt, root_sym, name,
 				len + (len > 1) + rel_path_len, &p);
 		if (ret < 0)
 			return ret;
+		overlay_index_shift(fdt, idx, root_sym, size);
 
 		if (!target_path) {
 			/* again in case setprop_placeholder changed it */
-			ret = overlay_get_target(fdt, fdto, fragment, &target_path);
+			ret = overlay_get_target(fdt, fdto, fragment,
+						 &target_path, idx);
 			if (ret < 0)
 				return ret;
 			target = ret;
@@ -826,15 +944,59 @@ static int overlay_symbol_update(void *fdt, void *fdto)
 	return 0;
 }
 
+int fdt_overlay_index_init(const void *fdt, struct fdt_overlay_index *idx,
+			   struct fdt_phandle_entry *ents, int size)
+{
+	uint32_t phandle;
+	int offset, i;
+
+	FDT_RO_PROBE(fdt);
+
+	idx->ents = size > 0 ? ents : NULL;
+	idx->size = idx->ents ? size : 0;
+	idx->count = 0;
+	idx->max_phandle = 0;
+	for (i = 0; i < idx->size; i++)
+		idx->ents[i].phandle = 0;
+
+	for (offset = fdt_next_node(fdt, -1, NULL);
+	     offset >= 0;
+	     offset = fdt_next_node(fdt, offset, NULL)) {
+		phandle = fdt_get_phandle(fdt, offset);
+		if (phandle > idx->max_phandle)
+			idx->max_phandle = phandle;
+		overlay_index_add(idx, phandle, offset);
+	}
+	if (offset != -FDT_ERR_NOTFOUND)
+		return offset;
+
+	return 0;
+}
+
 int fdt_overlay_apply(void *fdt, void *fdto)
 {
-	uint32_t delta;
+	return fdt_overlay_apply_index(fdt, fdto, NULL);
+}
+
+int fdt_overlay_apply_index(void *fdt, void *fdto,
+			    struct fdt_overlay_index *idx)
+{
+	uint32_t delta, ov_max = 0;
 	int ret;
 
 	FDT_RO_PROBE(fdt);
 	FDT_RO_PROBE(fdto);
 
-	ret = fdt_find_max_phandle(fdt, &delta);
+	/*
+	 * With an index, the highest phandle is tracked as overlays are
+	 * applied: those from the overlay end up at most delta + ov_max
+	 */
+	if (idx) {
+		delta = idx->max_phandle;
+		ret = fdt_find_max_phandle(fdto, &ov_max);
+	} else {
+		ret = fdt_find_max_phandle(fdt, &delta);
+	}
 	if (ret)
 		goto err;
 
@@ -850,14 +1012,17 @@ int fdt_overlay_apply(void *fdt, void *fdto)
 	if (ret)
 		goto err;
 
-	ret = overlay_merge(fdt, fdto);
+	ret = overlay_merge(fdt, fdto, idx);
 	if (ret)
 		goto err;
 
-	ret = overlay_symbol_update(fdt, fdto);
+	ret = overlay_symbol_update(fdt, fdto, idx);
 	if (ret)
 		goto err;
 
+	if (idx)
+		idx->max_phandle = delta + ov_max;
+
 	/*
 	 * The overlay has been damaged, erase its magic.
 	 */
@@ -882,5 +1047,5 @@ err:
 
 int fdt_overlay_apply_node(void *fdt, int target, void *fdto, int node)
 {
-	return overlay_apply_node(fdt, target, fdto, node);
+	return overlay_apply_node(fdt, target, fdto, node, NULL);
 }
@@ -2039,6 +2039,80 @@ int fdt_overlay_apply(void *fdt, void *fdto);
  */
 int fdt_overlay_apply_node(void *fdt, int target, void *fdto, int node);
 
+/**
+ * struct fdt_phandle_entry - One entry in a phandle index
+ * @phandle: phandle of the node, 0 if the entry is unused
+ * @offset: offset of the node in the base device tree
+ */
+struct fdt_phandle_entry {
+	uint32_t phandle;
+	int offset;
+};
+
+/**
+ * struct fdt_overlay_index - State kept when applying several overlays
+ * @ents: hash table mapping phandles to node offsets in the base device
+ *	tree, or NULL to keep no index
+ * @size: number of entries in @ents
+ * @count: number of entries in use
+ * @max_phandle: a phandle value at least as high as any in the base tree
+ *
+ * Applying an overlay looks up the base tree node for each target phandle
+ * and first finds the highest phandle in use, each of which walks the whole
+ * base tree. Keeping the phandles in an index which is updated as overlays
+ * are applied avoids these walks.
+ */
+struct fdt_overlay_index {
+	struct fdt_phandle_entry *ents;
+	int size;
+	int count;
+	uint32_t max_phandle;
+};
+
+/**
+ * fdt_overlay_index_init - Set up an index for applying overlays
+ * @fdt: pointer to the base device tree blob
+ * @idx: index to set up
+ * @ents: space for the hash table, or NULL for none
+ * @size: number of entries in @ents
+ *
+ * fdt_overlay_index_init() walks the base tree once, recording the
+ * highest phandle and, as far as there is room, the offset of each node
+ * with a phandle. About twice as many entries as there are phandles are
+ * needed to avoid lookups falling back to walking the tree.
+ *
+ * The index stays valid while the base tree is only changed by
+ * fdt_overlay_apply_index() or in ways which leave the structure block
+ * alone, such as fdt_open_into(), fdt_pack() or memory reservations.
+ *
+ * returns:
+ *	0, on success
+ *	-FDT_ERR_BADMAGIC,
+ *	-FDT_ERR_BADVERSION,
+ *	-FDT_ERR_BADSTATE,
+ *	-FDT_ERR_BADSTRUCTURE,
+ *	-FDT_ERR_TRUNCATED, standard meanings
+ */
+int fdt_overlay_index_init(const void *fdt, struct fdt_overlay_index *idx,
+			   struct fdt_phandle_entry *ents, int size);
+
+/**
+ * fdt_overlay_apply_index - Applies a DT overlay using an index
+ * @fdt: pointer to the base device tree blob
+ * @fdto: pointer to the device tree overlay blob
+ * @idx: index set up by fdt_overlay_index_init(), or NULL
+ *
+ * This is the same as fdt_overlay_apply() but uses and updates @idx, so
+ * that applying several overlays in turn does not walk the base tree for
+ * each one. The phandles given to the overlay's nodes may be higher than
+ * fdt_overlay_apply() would choose, but are still unique.
+ *
+ * returns:
+ *	as for fdt_overlay_apply()
+ */
+int fdt_overlay_apply_index(void *fdt, void *fdto,
+			    struct fdt_overlay_index *idx);
+
 /**********************************************************************/
 /* Debugging / informational functions                                */
 /**********************************************************************/
@@ -7,6 +7,9 @@
 
 #include <common.h>
 #include <bootm.h>
+#include <image.h>
+#include <malloc.h>
+#include <os.h>
 #include <asm/global_data.h>
 #include <test/suites.h>
 #include <test/test.h>
@@ -238,6 +241,87 @@ static int bootm_test_subst_both(struct unit_test_state *uts)
 }
 BOOTM_TEST(bootm_test_subst_both, 0);
 
+#ifdef CONFIG_SANDBOX
+/* FIT with several configurations, written by test_ut.py using mkimage */
+#define FIT_COMPAT_FNAME	"fit_compat.itb"
+
+/* Check the configuration picked for a board using FDT image @fdt_name */
+static int check_fit_compat(struct unit_test_state *uts, const void *fit,
+			    const char *fdt_name, const char *expect)
+{
+	const void *fdt;
+	size_t size;
+	int noffset;
+
+	noffset = fit_image_get_node(fit, fdt_name);
+	ut_assert(noffset >= 0);
+	ut_assertok(fit_image_get_data(fit, noffset, &fdt, &size));
+	noffset = fit_conf_find_compat(fit, fdt);
+	if (!expect) {
+		ut_asserteq(-1, noffset);
+		return 0;
+	}
+	ut_assert(noffset >= 0);
+	ut_asserteq_str(expect, fdt_get_name(fit, noffset, NULL));
+
+	return 0;
+}
+
+/* Check the configuration picked for each board */
+static int check_fit_compat_all(struct unit_test_state *uts, const void *fit)
+{
+	ut_assertok(check_fit_compat(uts, fit, "fdt-1", "conf-1"));
+	ut_assertok(check_fit_compat(uts, fit, "fdt-2", "conf-2"));
+	ut_assertok(check_fit_compat(uts, fit, "fdt-3", "conf-3"));
+	ut_assertok(check_fit_compat(uts, fit, "fdt-4", NULL));
+
+	return 0;
+}
+
+/* Test that the compatible index picks the same configuration as a scan */
+static int bootm_test_fit_compat(struct unit_test_state *uts)
+{
+	const int spare = 256;
+	int size, confs;
+	void *buf, *fit;
+
+	ut_assertok(os_read_file(FIT_COMPAT_FNAME, &buf, &size));
+	fit = malloc(size + spare);
+	ut_assertnonnull(fit);
+	ut_assertok(fdt_open_into(buf, fit, size + spare));
+	free(buf);
+	confs = fdt_path_offset(fit, FIT_CONFS_PATH);
+	ut_assert(confs >= 0);
+
+	/* mkimage adds the index, which must agree with the scan */
+	ut_assertnonnull(fdt_getprop(fit, confs, FIT_COMPAT_INDEX_PROP, NULL));
+	ut_assertok(check_fit_compat_all(uts, fit));
+	ut_assertok(fdt_delprop(fit, confs, FIT_COMPAT_INDEX_PROP));
+	ut_assertok(check_fit_compat_all(uts, fit));
+
+	/* The index is used when present, even if it disagrees */
+	ut_assertok(fdt_setprop(fit, confs, FIT_COMPAT_INDEX_PROP,
+				"test,board-a\0conf-3", 20));
+	ut_assertok(check_fit_compat(uts, fit, "fdt-1", "conf-3"));
+
+	/* A malformed index is ignored and the configurations are scanned */
+	ut_assertok(fdt_setprop_string(fit, confs, FIT_COMPAT_INDEX_PROP,
+				       "test,board-a"));
+	ut_assertok(check_fit_compat_all(uts, fit));
+	ut_assertok(fdt_setprop(fit, confs, FIT_COMPAT_INDEX_PROP,
+				"test,board-a\0conf-3", 19));
+	ut_assertok(check_fit_compat_all(uts, fit));
+	ut_assertok(fdt_setprop(fit, confs, FIT_COMPAT_INDEX_PROP,
+				"test,board-a\0conf-9", 20));
+	ut_assertok(check_fit_compat(uts, fit, "fdt-1", "conf-1"));
+
+	free(fit);
+
+	return 0;
+}
+BOOTM_TEST(bootm_test_fit_compat, 0);
+#endif
+
 int do_ut_bootm(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
 	struct unit_test *tests = ll_entry_start(struct unit_test, bootm_test);
@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for finding commands and running scripts from the environment
+ */
+
+#include <common.h>
+#include <command.h>
+#include <env.h>
+#include <test/suites.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+/* Declare a new command test */
+#define COMMAND_TEST(_name, _flags)	UNIT_TEST(_name, _flags, command_test)
+
+/* Test that find_cmd() gives the same result as scanning the whole table */
+static int command_test_find(struct unit_test_state *uts)
+{
+	struct cmd_tbl *start = ll_entry_start(struct cmd_tbl, cmd);
+	const int count = ll_entry_count(struct cmd_tbl, cmd);
+	struct cmd_tbl *cmd;
+	char name[32];
+	int len;
+
+	/* Every abbreviation of every command, with and without a suffix */
+	for (cmd = start; cmd < start + count; cmd++) {
+		for (len = 1; len <= strlen(cmd->name) &&
+		     len < sizeof(name) - 2; len++) {
+			strlcpy(name, cmd->name, len + 1);
+			ut_asserteq_ptr(find_cmd_tbl(name, start, count),
+					find_cmd(name));
+			strcat(name, ".b");
+			ut_asserteq_ptr(find_cmd_tbl(name, start, count),
+					find_cmd(name));
+		}
+	}
+
+	ut_asserteq_str("setenv", find_cmd("setenv")->name);
+	ut_asserteq_str("setenv", find_cmd("seten")->name);
+	ut_asserteq_str("md", find_cmd("md.l")->name);
+	ut_assertnull(find_cmd("se"));
+	ut_assertnull(find_cmd("no-such-command"));
+	ut_assertnull(find_cmd(""));
+	ut_assertnull(find_cmd(NULL));
+
+	return 0;
+}
+COMMAND_TEST(command_test_find, 0);
+
+#ifdef CONFIG_HUSH_PARSER
+/**
+ * run_script() - run a script from the environment and check its result
+ *
+ * The script is run twice, so that the second run can use a cached parse.
+ *
+ * @uts:	test state
+ * @script:	script, which should set 'out'
+ * @expect:	expected value of 'out'
+ * Return: 0 if OK, -ve on error
+ */
+static int run_script(struct unit_test_state *uts, const char *script,
+		      const char *expect)
+{
+	int i;
+
+	ut_assertok(env_set("script", script));
+	for (i = 0; i < 2; i++) {
+		ut_assertok(env_set("out", NULL));
+		ut_assertok(run_command("run script", 0));
+		ut_asserteq_str(expect, env_get("out"));
+	}
+
+	return 0;
+}
+
+/* Test running scripts again, which may use the parse cache */
+static int command_test_hush_script_rerun(struct unit_test_state *uts)
+{
+	ut_assertok(run_script(uts,
+		"for i in a b c; do setenv out ${out}${i}; done", "abc"));
+
+	/* Substitutions in an assignment before a command */
+	ut_assertok(run_script(uts, "x=5; y=${x} setenv out ${y}", "5"));
+
+	/* Leaving a loop early must not upset the next run */
+	ut_assertok(run_script(uts,
+		"for i in a b c; do setenv out ${out}${i}; "
+		"if test ${i} = b; then exit; fi; done", "ab"));
+
+	/* Several lines, and a changed script */
+	ut_assertok(run_script(uts, "setenv out 1\nsetenv out ${out}2", "12"));
+	ut_assertok(run_script(uts, "setenv out 1\nsetenv out ${out}3", "13"));
+
+	/* A script which runs itself */
+	ut_assertok(run_script(uts,
+		"setenv out ${out}x; if test ${out} != xxx; then run script; fi",
+		"xxx"));
+
+	ut_assertok(env_set("script", NULL));
+	ut_assertok(env_set("out", NULL));
+
+	return 0;
+}
+COMMAND_TEST(command_test_hush_script_rerun, 0);
+#endif
+
+int do_ut_command(struct cmd_tbl *cmdtp, int flag, int argc,
+		  char *const argv[])
+{
+	struct unit_test *tests = ll_entry_start(struct unit_test,
+						 command_test);
+	const int n_ents = ll_entry_count(struct unit_test, command_test);
+
+	return cmd_ut_category("command", "command_test_", tests, n_ents,
+			       argc, argv);
+}
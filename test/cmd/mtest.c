@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the fast memory test
+ */
+
+#include <common.h>
+#include <command.h>
+#include <mapmem.h>
+#include <test/ut.h>
+
+#define TEST_START	0x100000
+#define TEST_SIZE	0x8000
+
+/* Declare a new mem test */
+#define MEM_TEST(_name, _flags)	UNIT_TEST(_name, _flags, mem_test)
+
+/* Test that 'mtest' passes and leaves each word holding its pattern */
+static int mem_test_mtest_fast(struct unit_test_state *uts)
+{
+	ulong *buf;
+	ulong seed;
+	int i;
+
+	ut_assertok(run_command("mtest 100000 108000 5a00 2", 0));
+
+	/* The second iteration walks a one into bit 1 of the pattern */
+	seed = 0x5a00 ^ (1UL << 1);
+	buf = map_sysmem(TEST_START, TEST_SIZE);
+	for (i = 0; i < TEST_SIZE / sizeof(ulong); i++)
+		ut_asserteq((TEST_START + i * sizeof(ulong)) ^ seed, buf[i]);
+	unmap_sysmem(buf);
+
+	return 0;
+}
+MEM_TEST(mem_test_mtest_fast, 0);
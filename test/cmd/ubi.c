@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the UBI attach snapshot, through the ubi command
+ */
+
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+#include <mapmem.h>
+#include <linux/mtd/mtd.h>
+#include <linux/sizes.h>
+#include <asm/unaligned.h>
+#include <test/suites.h>
+#include <test/ut.h>
+
+/* Declare a new ubi test */
+#define UBI_TEST(_name, _flags)	UNIT_TEST(_name, _flags, ubi_test)
+
+#define UBI_TEST_PEB_SIZE	SZ_64K
+#define UBI_TEST_PEBS		32
+#define UBI_TEST_DATA_SIZE	0x1000
+
+/* A NOR flash in RAM, recording which PEBs were read */
+static struct mtd_info ubi_test_mtd;
+static u8 *ubi_test_flash;
+static bool ubi_test_peb_read[UBI_TEST_PEBS];
+
+static int ubi_test_mtd_erase(struct mtd_info *mtd, struct erase_info *instr)
+{
+	memset(ubi_test_flash + instr->addr, 0xff, instr->len);
+	instr->state = MTD_ERASE_DONE;
+	mtd_erase_callback(instr);
+
+	return 0;
+}
+
+static int ubi_test_mtd_read(struct mtd_info *mtd, loff_t from, size_t len,
+			     size_t *retlen, u_char *buf)
+{
+	int pnum;
+
+	for (pnum = from / UBI_TEST_PEB_SIZE;
+	     pnum * UBI_TEST_PEB_SIZE < from + len; pnum++)
+		ubi_test_peb_read[pnum] = true;
+
+	memcpy(buf, ubi_test_flash + from, len);
+	*retlen = len;
+
+	return 0;
+}
+
+static int ubi_test_mtd_write(struct mtd_info *mtd, loff_t to, size_t len,
+			      size_t *retlen, const u_char *buf)
+{
+	size_t i;
+
+	/* Programming can only clear bits */
+	for (i = 0; i < len; i++)
+		ubi_test_flash[to + i] &= buf[i];
+	*retlen = len;
+
+	return 0;
+}
+
+/* Return the number of PEBs read since the last call */
+static int ubi_test_count_reads(void)
+{
+	int pnum, count = 0;
+
+	for (pnum = 0; pnum < UBI_TEST_PEBS; pnum++) {
+		if (ubi_test_peb_read[pnum])
+			count++;
+		ubi_test_peb_read[pnum] = false;
+	}
+
+	return count;
+}
+
+/* Return the PEB whose LEB data starts with @size bytes of @val, or -1 */
+static int ubi_test_find_peb(u8 val, int size)
+{
+	int pnum, i;
+
+	for (pnum = 0; pnum < UBI_TEST_PEBS; pnum++) {
+		u8 *peb = ubi_test_flash + pnum * UBI_TEST_PEB_SIZE;
+		u8 *data;
+
+		/* data_offset field of the EC header */
+		data = peb + get_unaligned_be32(peb + 20);
+		if (data + size > peb + UBI_TEST_PEB_SIZE)
+			continue;
+		for (i = 0; i < size && data[i] == val; i++)
+			;
+		if (i == size)
+			return pnum;
+	}
+
+	return -1;
+}
+
+static int ubi_test_check_buf(struct unit_test_state *uts, const u8 *buf,
+			      u8 val)
+{
+	int i;
+
+	for (i = 0; i < UBI_TEST_DATA_SIZE; i++)
+		ut_asserteq(val, buf[i]);
+
+	return 0;
+}
+
+/*
+ * Test that an attach uses the snapshot of the previous one only while it
+ * matches the flash, also when a volume which does not hold the newest VID
+ * header was changed behind UBI's back
+ */
+static int ubi_test_attach_snapshot(struct unit_test_state *uts)
+{
+	int pnum;
+	u8 *buf;
+
+	ubi_test_flash = malloc(UBI_TEST_PEBS * UBI_TEST_PEB_SIZE);
+	ut_assertnonnull(ubi_test_flash);
+	memset(ubi_test_flash, 0xff, UBI_TEST_PEBS * UBI_TEST_PEB_SIZE);
+
+	memset(&ubi_test_mtd, '\0', sizeof(ubi_test_mtd));
+	ubi_test_mtd.name = "ubitest";
+	ubi_test_mtd.type = MTD_NORFLASH;
+	ubi_test_mtd.flags = MTD_CAP_NORFLASH;
+	ubi_test_mtd.writesize = 1;
+	ubi_test_mtd.writebufsize = 256;
+	ubi_test_mtd.size = UBI_TEST_PEBS * UBI_TEST_PEB_SIZE;
+	ubi_test_mtd.erasesize = UBI_TEST_PEB_SIZE;
+	ubi_test_mtd._erase = ubi_test_mtd_erase;
+	ubi_test_mtd._read = ubi_test_mtd_read;
+	ubi_test_mtd._write = ubi_test_mtd_write;
+	ut_assertok(add_mtd_device(&ubi_test_mtd));
+
+	/* Format the flash, volume a gets the newest VID header */
+	buf = map_sysmem(0, UBI_TEST_DATA_SIZE);
+	ut_assertok(run_command("ubi part ubitest", 0));
+	ut_assertok(run_command("ubi create a 8000", 0));
+	ut_assertok(run_command("ubi create b 8000", 0));
+	memset(buf, 'b', UBI_TEST_DATA_SIZE);
+	ut_assertok(run_command("ubi write 0 b 1000", 0));
+	memset(buf, 'a', UBI_TEST_DATA_SIZE);
+	ut_assertok(run_command("ubi write 0 a 1000", 0));
+
+	/* The writes dropped the snapshot, so every PEB is scanned */
+	ubi_test_count_reads();
+	ut_assertok(run_command("ubi part ubitest", 0));
+	ut_asserteq(UBI_TEST_PEBS, ubi_test_count_reads());
+
+	/* Nothing was written since, so the snapshot is used */
+	ut_assertok(run_command("ubi part ubitest", 0));
+	ut_assert(ubi_test_count_reads() < UBI_TEST_PEBS);
+	memset(buf, '\0', UBI_TEST_DATA_SIZE);
+	ut_assertok(run_command("ubi read 0 b 1000", 0));
+	ut_assertok(ubi_test_check_buf(uts, buf, 'b'));
+
+	/* Erase volume b without UBI knowing, the snapshot must be dropped */
+	ut_assertok(run_command("ubi detach", 0));
+	pnum = ubi_test_find_peb('b', UBI_TEST_DATA_SIZE);
+	ut_assert(pnum >= 0);
+	memset(ubi_test_flash + pnum * UBI_TEST_PEB_SIZE, 0xff,
+	       UBI_TEST_PEB_SIZE);
+
+	ubi_test_count_reads();
+	ut_assertok(run_command("ubi part ubitest", 0));
+	ut_asserteq(UBI_TEST_PEBS, ubi_test_count_reads());
+	memset(buf, '\0', UBI_TEST_DATA_SIZE);
+	ut_assertok(run_command("ubi read 0 b 1000", 0));
+	ut_assertok(ubi_test_check_buf(uts, buf, 0xff));
+	ut_assertok(run_command("ubi read 0 a 1000", 0));
+	ut_assertok(ubi_test_check_buf(uts, buf, 'a'));
+
+	ut_assertok(run_command("ubi detach", 0));
+	unmap_sysmem(buf);
+	ut_assertok(del_mtd_device(&ubi_test_mtd));
+	free(ubi_test_flash);
+
+	return 0;
+}
+UBI_TEST(ubi_test_attach_snapshot, UT_TESTF_CONSOLE_REC);
+
+int do_ut_ubi(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
+{
+	struct unit_test *tests = ll_entry_start(struct unit_test, ubi_test);
+	const int n_ents = ll_entry_count(struct unit_test, ubi_test);
+
+	return cmd_ut_category("ubi", "ubi_test_", tests, n_ents, argc, argv);
+}
@@ -9,6 +9,7 @@
 #include <os.h>
 #endif
 #include <dm.h>
+#include <malloc.h>
 #include <asm/global_data.h>
 #include <dm/device.h>
 #include <dm/device-internal.h>
@@ -485,3 +486,73 @@ static int dm_test_bus_child_post_probe_uclass(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_bus_child_post_probe_uclass,
 	UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+#if CONFIG_IS_ENABLED(DM_COMBINED_ALLOC)
+/* Size of a block carved from the allocation holding a device */
+#define BLOCK_SIZE(type)	ALIGN(sizeof(type), 2 * sizeof(void *))
+
+#define COMBINED_COUNT	1000
+
+/* Test that the data for each child comes from one block at bind and probe */
+static int dm_test_bus_combined_alloc(struct unit_test_state *uts)
+{
+	struct udevice *bus, *dev, *child[COMBINED_COUNT];
+	struct dm_test_parent_data *parent_data;
+	struct dm_test_pdata *plat;
+	ulong start_mem;
+	long size;
+	int i;
+
+	ut_assertok(uclass_get_device(UCLASS_TEST_BUS, 0, &bus));
+	ut_assertok(device_find_child_by_seq(bus, 0, &dev));
+
+	/* The plat and parent plat follow the device */
+	plat = dev_get_plat(dev);
+	ut_asserteq_ptr((char *)dev + BLOCK_SIZE(struct udevice), plat);
+	ut_asserteq_ptr((char *)plat + BLOCK_SIZE(struct dm_test_pdata),
+			dev_get_parent_plat(dev));
+	ut_asserteq(0, dev_get_flags(dev) & (DM_FLAG_ALLOC_PDATA |
+					     DM_FLAG_ALLOC_PARENT_PDATA));
+
+	/* The priv and parent priv share a block while probed */
+	ut_assertok(device_probe(dev));
+	ut_assert(dev_get_flags(dev) & DM_FLAG_ALLOC_PRIV_COMBINED);
+	parent_data = dev_get_parent_priv(dev);
+	ut_asserteq_ptr((char *)dev_get_priv(dev) +
+			BLOCK_SIZE(struct dm_test_priv), parent_data);
+	ut_asserteq(TEST_FLAG_CHILD_PROBED, parent_data->flag);
+
+	ut_assertok(device_remove(dev, DM_REMOVE_NORMAL));
+	ut_asserteq(0, dev_get_flags(dev) & DM_FLAG_ALLOC_PRIV_COMBINED);
+	ut_asserteq_ptr(NULL, dev_get_priv(dev));
+	ut_asserteq_ptr(NULL, dev_get_parent_priv(dev));
+
+	/* Probing again gives zeroed data */
+	ut_assertok(device_probe(dev));
+	parent_data = dev_get_parent_priv(dev);
+	ut_asserteq(TEST_FLAG_CHILD_PROBED, parent_data->flag);
+
+	/* Each child takes a single allocation, holding all its plat data */
+	size = BLOCK_SIZE(struct udevice) + BLOCK_SIZE(struct dm_test_pdata) +
+		BLOCK_SIZE(struct dm_test_parent_plat);
+	start_mem = ut_check_free();
+	for (i = 0; i < COMBINED_COUNT; i++) {
+		ut_assertok(device_bind(bus, DM_DRIVER_GET(testfdt_drv),
+					"combined", NULL, ofnode_null(),
+					&child[i]));
+		ut_asserteq(0, dev_get_flags(child[i]) &
+			    (DM_FLAG_ALLOC_PDATA | DM_FLAG_ALLOC_PARENT_PDATA));
+		ut_assert(malloc_usable_size(child[i]) >= size);
+		ut_asserteq_ptr((char *)child[i] + size -
+				BLOCK_SIZE(struct dm_test_parent_plat),
+				dev_get_parent_plat(child[i]));
+	}
+
+	for (i = 0; i < COMBINED_COUNT; i++)
+		ut_assertok(device_unbind(child[i]));
+	ut_assertok(ut_check_delta(start_mem));
+
+	return 0;
+}
+DM_TEST(dm_test_bus_combined_alloc, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+#endif
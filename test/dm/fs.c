@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for reading files through file streams
+ */
+
+#include <common.h>
+#include <blk.h>
+#include <dm.h>
+#include <fs.h>
+#include <malloc.h>
+#include <mapmem.h>
+#include <sandboxblockdev.h>
+#include <dm/test.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+#define TEST_FILE	"/stream.bin"
+#define TEST_SIZE	(48 * 1024)
+#define TEST_CHUNK	1000
+
+static int select_fs(struct unit_test_state *uts)
+{
+	ut_assertok(fs_set_blk_dev("host", "0:0", FS_TYPE_FAT));
+
+	return 0;
+}
+
+/* Test reading a file through a stream, and that writes make it stale */
+static int dm_test_fs_file_stream(struct unit_test_state *uts)
+{
+	struct fs_file_stream *file;
+	struct blk_desc *desc;
+	loff_t actual, pos;
+	char *data, *buf;
+	int i;
+
+	/* test/py/tests/test_ut.py creates this image */
+	ut_assertok(host_dev_bind(0, "fat.img"));
+	desc = blk_get_devnum_by_type(IF_TYPE_HOST, 0);
+	ut_assertnonnull(desc);
+
+	data = malloc(TEST_SIZE);
+	buf = malloc(TEST_SIZE);
+	ut_assertnonnull(data);
+	ut_assertnonnull(buf);
+	for (i = 0; i < TEST_SIZE; i++)
+		data[i] = i * 7 + (i >> 8);
+
+	ut_assertok(select_fs(uts));
+	ut_assertok(fs_write(TEST_FILE, map_to_sysmem(data), 0, TEST_SIZE,
+			     &actual));
+	ut_asserteq(TEST_SIZE, actual);
+
+	/* Read it in pieces which do not line up with clusters */
+	ut_assertok(select_fs(uts));
+	file = fs_openfile(TEST_FILE);
+	ut_assertnonnull(file);
+	ut_asserteq(TEST_SIZE, file->size);
+	memset(buf, '\0', TEST_SIZE);
+	for (pos = 0; pos < TEST_SIZE; pos += actual) {
+		ut_assertok(fs_readfile(file, buf + pos, pos, TEST_CHUNK,
+					&actual));
+		ut_assert(actual > 0);
+	}
+	ut_asserteq(TEST_SIZE, pos);
+	ut_asserteq_mem(data, buf, TEST_SIZE);
+
+	/* Going backwards, and reading past the end */
+	ut_assertok(fs_readfile(file, buf, 100, 50, &actual));
+	ut_asserteq(50, actual);
+	ut_asserteq_mem(data + 100, buf, 50);
+	ut_assertok(fs_readfile(file, buf, TEST_SIZE - 10, TEST_CHUNK,
+				&actual));
+	ut_asserteq(10, actual);
+	ut_asserteq_mem(data + TEST_SIZE - 10, buf, 10);
+
+	/* A raw write to the device makes the stream stale */
+	ut_asserteq(1, blk_dread(desc, 0, 1, buf));
+	ut_asserteq(1, blk_dwrite(desc, 0, 1, buf));
+	ut_asserteq(-ESTALE, fs_readfile(file, buf, 0, 10, &actual));
+	fs_closefile(file);
+
+	/* So does a change through the filesystem */
+	ut_assertok(select_fs(uts));
+	file = fs_openfile(TEST_FILE);
+	ut_assertnonnull(file);
+	ut_assertok(fs_readfile(file, buf, 0, 10, &actual));
+	ut_asserteq(10, actual);
+	ut_assertok(select_fs(uts));
+	ut_assertok(fs_unlink(TEST_FILE));
+	ut_asserteq(-ESTALE, fs_readfile(file, buf, 0, 10, &actual));
+	fs_closefile(file);
+
+	ut_assertok(select_fs(uts));
+	ut_assertnull(fs_openfile(TEST_FILE));
+
+	free(buf);
+	free(data);
+	ut_assertok(host_dev_bind(0, NULL));
+
+	return 0;
+}
+DM_TEST(dm_test_fs_file_stream, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
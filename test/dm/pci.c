@@ -7,6 +7,7 @@
 #include <dm.h>
 #include <asm/io.h>
 #include <asm/test.h>
+#include <dm/device-internal.h>
 #include <dm/test.h>
 #include <test/test.h>
 #include <test/ut.h>
@@ -376,3 +377,123 @@ static int dm_test_pci_region_multi(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_pci_region_multi, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+#define PCI_TEST_MAX_FUNCS	32
+
+/* A PCI function as bound on a bus, with its BARs */
+struct pci_test_func {
+	pci_dev_t bdf;
+	uint vendor;
+	uint device;
+	uint class;
+	u32 bar[6];
+};
+
+/* Probe every PCI bus and record the functions bound on them */
+static int pci_test_collect(struct unit_test_state *uts,
+			    struct pci_test_func *funcs, int *countp)
+{
+	struct udevice *bus, *dev;
+	int count = 0;
+	int i;
+
+	uclass_foreach_dev_probe(UCLASS_PCI, bus) {
+		device_foreach_child(dev, bus) {
+			struct pci_child_plat *pplat = dev_get_parent_plat(dev);
+			struct pci_test_func *func;
+
+			ut_assert(count < PCI_TEST_MAX_FUNCS);
+			func = &funcs[count++];
+			func->bdf = dm_pci_get_bdf(dev);
+			func->vendor = pplat->vendor;
+			func->device = pplat->device;
+			func->class = pplat->class;
+			for (i = 0; i < ARRAY_SIZE(func->bar); i++)
+				ut_assertok(dm_pci_read_config32(dev,
+						PCI_BASE_ADDRESS_0 + i * 4,
+						&func->bar[i]));
+		}
+	}
+	*countp = count;
+
+	return 0;
+}
+
+/* Remove the PCI controllers, so that their buses are bound again on probe */
+static int pci_test_remove_roots(struct unit_test_state *uts)
+{
+	struct udevice *bus;
+	struct uclass *uc;
+
+	uclass_id_foreach_dev(UCLASS_PCI, bus, uc) {
+		if (!device_is_on_pci_bus(bus))
+			ut_assertok(device_remove(bus, DM_REMOVE_NORMAL));
+	}
+
+	return 0;
+}
+
+/*
+ * Check whether the PCI controllers scanned their buses since they were
+ * probed, or bound the functions from the enumeration cache
+ */
+static int pci_test_check_scanned(struct unit_test_state *uts, bool scanned)
+{
+	struct udevice *bus;
+	struct uclass *uc;
+	uint reads;
+
+	uclass_id_foreach_dev(UCLASS_PCI, bus, uc) {
+		if (device_is_on_pci_bus(bus))
+			continue;
+		reads = sandbox_pci_get_id_reads(bus);
+		ut_asserteq(scanned, reads >= PCI_MAX_PCI_DEVICES);
+	}
+
+	return 0;
+}
+
+/* Test that binding from the enumeration cache matches a fresh scan */
+static int dm_test_pci_enum_cache(struct unit_test_state *uts)
+{
+	struct pci_test_func scanned[PCI_TEST_MAX_FUNCS];
+	struct pci_test_func cached[PCI_TEST_MAX_FUNCS];
+	int num_scanned, num_cached;
+	struct udevice *bus;
+	struct uclass *uc;
+	int i;
+
+	/* Scan every bus, which records what is found */
+	ut_assertok(pci_test_remove_roots(uts));
+	pci_enum_cache_reset();
+	memset(scanned, '\0', sizeof(scanned));
+	ut_assertok(pci_test_collect(uts, scanned, &num_scanned));
+	ut_assert(num_scanned > 0);
+	ut_assertok(pci_test_check_scanned(uts, true));
+
+	/*
+	 * Probe the buses again, now from the cache. Unbind the functions
+	 * which are not in the device tree, so that they must be bound again.
+	 * Bridges are left, since unbinding them would change this uclass.
+	 */
+	ut_assertok(pci_test_remove_roots(uts));
+	uclass_id_foreach_dev(UCLASS_PCI, bus, uc) {
+		struct udevice *dev, *next;
+
+		device_foreach_child_safe(dev, next, bus) {
+			if (!ofnode_valid(dev_ofnode(dev)) &&
+			    device_get_uclass_id(dev) != UCLASS_PCI)
+				ut_assertok(device_unbind(dev));
+		}
+	}
+	memset(cached, '\0', sizeof(cached));
+	ut_assertok(pci_test_collect(uts, cached, &num_cached));
+	ut_assertok(pci_test_check_scanned(uts, false));
+
+	ut_asserteq(num_scanned, num_cached);
+	for (i = 0; i < num_scanned; i++)
+		ut_asserteq_mem(&scanned[i], &cached[i], sizeof(scanned[i]));
+
+	return 0;
+}
+DM_TEST(dm_test_pci_enum_cache, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
@@ -6,7 +6,9 @@
 #include <common.h>
 #include <log.h>
 #include <serial.h>
+#include <stdio_dev.h>
 #include <dm.h>
+#include <asm/test.h>
 #include <dm/test.h>
 #include <test/test.h>
 #include <test/ut.h>
@@ -70,3 +72,74 @@ static int dm_test_serial(struct unit_test_state *uts)
 }
 
 DM_TEST(dm_test_serial, UT_TESTF_SCAN_FDT);
+
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+/* Get the number of characters waiting in the TX buffer */
+static int tx_count(struct serial_dev_priv *upriv)
+{
+	return (upriv->tx_wr_ptr - upriv->tx_rd_ptr +
+		CONFIG_SERIAL_TX_BUFFER_SIZE) % CONFIG_SERIAL_TX_BUFFER_SIZE;
+}
+
+static int dm_test_serial_tx_buffer(struct unit_test_state *uts)
+{
+	struct serial_dev_priv *upriv;
+	struct stdio_dev *sdev;
+	struct udevice *dev;
+	int queued, polled;
+
+	ut_assertok(uclass_get_device_by_name(UCLASS_SERIAL, "serial", &dev));
+	upriv = dev_get_uclass_priv(dev);
+	sdev = upriv->sdev;
+	ut_assertnonnull(upriv->tx_buf);
+	ut_assertnonnull(sdev);
+	ut_asserteq(0, tx_count(upriv));
+
+	/* Output is queued, not waited for, while the UART has no room */
+	sandbox_serial_set_busy(dev, true);
+	sdev->puts(sdev, "tx\n");
+	queued = tx_count(upriv);
+	sdev->tstc(sdev);
+	polled = tx_count(upriv);
+	sandbox_serial_set_busy(dev, false);
+	ut_asserteq(4, queued);
+	ut_asserteq(4, polled);
+
+	/* Checking for input sends it once there is room */
+	sdev->tstc(sdev);
+	ut_asserteq(0, tx_count(upriv));
+
+	/* Output goes straight out when there is room */
+	sdev->putc(sdev, '.');
+	ut_asserteq(0, tx_count(upriv));
+
+	/* Flushing sends whatever is left */
+	sandbox_serial_set_busy(dev, true);
+	sdev->putc(sdev, '\n');
+	queued = tx_count(upriv);
+	sandbox_serial_set_busy(dev, false);
+	serial_flush();
+	ut_asserteq(2, queued);
+	ut_asserteq(0, tx_count(upriv));
+
+	/* Once stopped, output is no longer queued */
+	serial_tx_stop();
+	ut_assert(upriv->tx_stopped);
+	ut_assertnonnull(upriv->tx_buf);
+	sdev->putc(sdev, '\n');
+	ut_asserteq(0, tx_count(upriv));
+
+	/* Buffering resumes when control comes back */
+	serial_tx_start();
+	sandbox_serial_set_busy(dev, true);
+	sdev->putc(sdev, '.');
+	queued = tx_count(upriv);
+	sandbox_serial_set_busy(dev, false);
+	serial_flush();
+	ut_asserteq(1, queued);
+	ut_asserteq(0, tx_count(upriv));
+
+	return 0;
+}
+DM_TEST(dm_test_serial_tx_buffer, UT_TESTF_SCAN_FDT);
+#endif
@@ -10,17 +10,20 @@
 #include <mapmem.h>
 #include <os.h>
 #include <spi.h>
+#include <spi-mem.h>
 #include <spi_flash.h>
 #include <asm/state.h>
 #include <asm/test.h>
 #include <dm/test.h>
 #include <dm/util.h>
+#include <linux/mtd/spi-nor.h>
 #include <test/test.h>
 #include <test/ut.h>
 
 /* Simple test of sandbox SPI flash */
 static int dm_test_spi_flash(struct unit_test_state *uts)
 {
+	struct spi_flash *flash;
 	struct udevice *dev;
 	int full_size = 0x200000;
 	int size = 0x10000;
@@ -51,6 +54,34 @@ static int dm_test_spi_flash(struct unit_test_state *uts)
 	ut_assertok(spi_flash_read_dm(dev, 0, size, dst));
 	ut_asserteq_mem(src, dst, size);
 
+	/* Erase a multi-sector span, leaving the data before it alone */
+	ut_assertok(spi_flash_erase_dm(dev, size, 2 * size));
+	ut_assertok(spi_flash_read_dm(dev, 0, 3 * size, dst));
+	ut_asserteq_mem(src, dst, size);
+	for (i = size; i < 3 * size; i++)
+		ut_asserteq(dst[i], 0xff);
+
+	/* Erase the whole device, this uses a single chip erase */
+	ut_assertok(spi_flash_erase_dm(dev, 0, full_size));
+	ut_assertok(spi_flash_read_dm(dev, 0, full_size, dst));
+	for (i = 0; i < full_size; i++)
+		ut_asserteq(dst[i], 0xff);
+
+	/*
+	 * Reads use a direct mapping; the sandbox controller has no
+	 * memory-mapped window so it falls back to regular operations
+	 */
+	flash = dev_get_uclass_priv(dev);
+	ut_assertnonnull(flash->dirmap.rdesc);
+	ut_assert(flash->dirmap.rdesc->nodirmap);
+	for (i = 0; i < size; i++)
+		src[i] = i ^ 0x5a;
+	ut_assertok(spi_flash_write_dm(dev, 0, size, src));
+	memset(dst, '\0', size);
+	ut_asserteq(size, spi_mem_dirmap_read(flash->dirmap.rdesc, 0, size,
+					      dst));
+	ut_asserteq_mem(src, dst, size);
+
 	/* Check mapping */
 	ut_assertok(dm_spi_get_mmap(dev, &map_base, &map_size, &offset));
 	ut_asserteq(0x1000, map_base);
@@ -67,6 +98,60 @@ static int dm_test_spi_flash(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_spi_flash, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
 
+/* Test that erases use the largest erase type which fits */
+static int dm_test_spi_flash_erase(struct unit_test_state *uts)
+{
+	struct sandbox_state *state = state_get_current();
+	int full_size = 0x200000;
+	int size = 0x12000;
+	int start = 0xf000;
+	struct udevice *dev, *emul;
+	u8 *src, *dst;
+	int i;
+
+	/* The flash on chip select 1 has 4KiB and 64KiB erase types */
+	ut_assertok(uclass_get_device_by_name(UCLASS_SPI_FLASH, "spi.bin@1",
+					      &dev));
+	emul = state->spi[0][1].emul;
+	ut_assertnonnull(emul);
+
+	src = map_sysmem(0x20000, full_size);
+	for (i = 0; i < full_size; i++)
+		src[i] = i;
+	ut_assertok(spi_flash_write_dm(dev, 0, full_size, src));
+
+	/*
+	 * Erase the last small sector of the first block, the whole second
+	 * block and the first small sector of the third one
+	 */
+	ut_assertok(spi_flash_erase_dm(dev, start, size));
+	ut_asserteq(2, sandbox_sf_get_erase_count(emul, SPINOR_OP_BE_4K));
+	ut_asserteq(1, sandbox_sf_get_erase_count(emul, SPINOR_OP_SE));
+	ut_asserteq(0, sandbox_sf_get_erase_count(emul, SPINOR_OP_CHIP_ERASE));
+
+	dst = map_sysmem(0x20000 + full_size, full_size);
+	ut_assertok(spi_flash_read_dm(dev, 0, full_size, dst));
+	ut_asserteq_mem(src, dst, start);
+	for (i = start; i < start + size; i++)
+		ut_asserteq(0xff, dst[i]);
+	ut_asserteq_mem(src + start + size, dst + start + size,
+			full_size - start - size);
+
+	/* Erasing the whole device uses a single chip erase */
+	ut_assertok(spi_flash_erase_dm(dev, 0, full_size));
+	ut_asserteq(2, sandbox_sf_get_erase_count(emul, SPINOR_OP_BE_4K));
+	ut_asserteq(1, sandbox_sf_get_erase_count(emul, SPINOR_OP_SE));
+	ut_asserteq(1, sandbox_sf_get_erase_count(emul, SPINOR_OP_CHIP_ERASE));
+	ut_assertok(spi_flash_read_dm(dev, 0, full_size, dst));
+	for (i = 0; i < full_size; i++)
+		ut_asserteq(0xff, dst[i]);
+
+	sandbox_sf_unbind_emul(state, 0, 1);
+
+	return 0;
+}
+DM_TEST(dm_test_spi_flash_erase, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
 /* Functional test that sandbox SPI flash works correctly */
 static int dm_test_spi_flash_func(struct unit_test_state *uts)
 {
@@ -164,6 +164,55 @@ static int dm_test_video_chars(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_video_chars, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
 
+#ifdef CONFIG_VIDEO_DAMAGE
+/* Test that only the areas drawn to are synced */
+static int dm_test_video_damage(struct unit_test_state *uts)
+{
+	struct udevice *dev, *con;
+	struct video_priv *priv;
+
+	ut_assertok(select_vidconsole(uts, "vidconsole0"));
+	ut_assertok(uclass_get_device(UCLASS_VIDEO, 0, &dev));
+	ut_assertok(uclass_get_device(UCLASS_VIDEO_CONSOLE, 0, &con));
+	priv = dev_get_uclass_priv(dev);
+
+	/* A forced sync always updates the display, so clears the damage */
+	ut_assertok(video_sync(dev, true));
+	ut_assert(priv->damage.xend <= priv->damage.xstart);
+
+	vidconsole_putc_xy(con, VID_TO_POS(8), 16, 'a');
+	ut_asserteq(8, priv->damage.xstart);
+	ut_asserteq(16, priv->damage.ystart);
+	ut_asserteq(16, priv->damage.xend);
+	ut_asserteq(32, priv->damage.yend);
+
+	/* Further drawing grows the bounding box */
+	vidconsole_putc_xy(con, VID_TO_POS(80), 48, 'b');
+	ut_asserteq(8, priv->damage.xstart);
+	ut_asserteq(16, priv->damage.ystart);
+	ut_asserteq(88, priv->damage.xend);
+	ut_asserteq(64, priv->damage.yend);
+
+	/* Regions outside the display are clipped */
+	video_damage(dev, priv->xsize - 4, -4, 100, 8);
+	ut_asserteq(0, priv->damage.ystart);
+	ut_asserteq(priv->xsize, priv->damage.xend);
+
+	ut_assertok(video_sync(dev, true));
+	ut_assert(priv->damage.xend <= priv->damage.xstart);
+
+	/* Clearing a row damages the whole width */
+	vidconsole_set_row(con, 1, priv->colour_bg);
+	ut_asserteq(0, priv->damage.xstart);
+	ut_asserteq(16, priv->damage.ystart);
+	ut_asserteq(priv->xsize, priv->damage.xend);
+	ut_asserteq(32, priv->damage.yend);
+
+	return 0;
+}
+DM_TEST(dm_test_video_damage, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+#endif
+
 #ifdef CONFIG_VIDEO_ANSI
 #define ANSI_ESC "\x1b"
 /* Test handling of ANSI escape sequences */
@@ -343,6 +392,8 @@ static int dm_test_video_truetype(struct unit_test_state *uts)
 
 	ut_assertok(uclass_get_device(UCLASS_VIDEO, 0, &dev));
 	ut_assertok(uclass_get_device(UCLASS_VIDEO_CONSOLE, 0, &con));
+	/* Place characters exactly, not on the glyph cache's grid */
+	ut_assertok(console_truetype_set_glyph_cache(con, false));
 	vidconsole_put_string(con, test_string);
 	ut_asserteq(12237, compress_frame_buffer(uts, dev));
 
@@ -364,6 +415,8 @@ static int dm_test_video_truetype_scroll(struct unit_test_state *uts)
 
 	ut_assertok(uclass_get_device(UCLASS_VIDEO, 0, &dev));
 	ut_assertok(uclass_get_device(UCLASS_VIDEO_CONSOLE, 0, &con));
+	/* Place characters exactly, not on the glyph cache's grid */
+	ut_assertok(console_truetype_set_glyph_cache(con, false));
 	vidconsole_put_string(con, test_string);
 	ut_asserteq(35030, compress_frame_buffer(uts, dev));
 
@@ -385,9 +438,60 @@ static int dm_test_video_truetype_bs(struct unit_test_state *uts)
 
 	ut_assertok(uclass_get_device(UCLASS_VIDEO, 0, &dev));
 	ut_assertok(uclass_get_device(UCLASS_VIDEO_CONSOLE, 0, &con));
+	/* Place characters exactly, not on the glyph cache's grid */
+	ut_assertok(console_truetype_set_glyph_cache(con, false));
 	vidconsole_put_string(con, test_string);
 	ut_asserteq(29018, compress_frame_buffer(uts, dev));
 
 	return 0;
 }
 DM_TEST(dm_test_video_truetype_bs, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+#ifdef CONFIG_CONSOLE_TRUETYPE_GLYPH_CACHE
+/* Test the TrueType glyph cache */
+static int dm_test_video_truetype_cache(struct unit_test_state *uts)
+{
+	struct vidconsole_priv *vc_priv;
+	struct udevice *dev, *con;
+	const char *test_string = "Criticism may not be agreeable, but it is necessary. It fulfils the same function as pain in the human body. It calls attention to an unhealthy state of things.";
+	const char *line = "Some see private enterprise as a cow to be milked\n";
+	int cached, uncached, hits;
+
+	ut_assertok(uclass_get_device(UCLASS_VIDEO, 0, &dev));
+	ut_assertok(uclass_get_device(UCLASS_VIDEO_CONSOLE, 0, &con));
+	vidconsole_put_string(con, test_string);
+	cached = compress_frame_buffer(uts, dev);
+
+	/*
+	 * A line starts at the same position each time, so writing it again
+	 * finds every character in the cache
+	 */
+	vidconsole_put_string(con, "\n");
+	vidconsole_put_string(con, line);
+	hits = console_truetype_get_glyph_hits(con);
+	vidconsole_put_string(con, line);
+	ut_asserteq(strlen(line) - 1, console_truetype_get_glyph_hits(con) - hits);
+
+	/* Start again at the top, without the cache */
+	ut_assertok(video_clear(dev));
+	vc_priv = dev_get_uclass_priv(con);
+	vc_priv->xcur_frac = vc_priv->xstart_frac;
+	vc_priv->ycur = 0;
+	vc_priv->last_ch = 0;
+	ut_assertok(console_truetype_set_glyph_cache(con, false));
+	hits = console_truetype_get_glyph_hits(con);
+	vidconsole_put_string(con, test_string);
+	uncached = compress_frame_buffer(uts, dev);
+	ut_asserteq(hits, console_truetype_get_glyph_hits(con));
+
+	/*
+	 * The cache places characters on a quarter-pixel grid, so the output
+	 * is close to, but not always the same as, the uncached output
+	 */
+	ut_assert(cached > 0);
+	ut_assert(abs(cached - uncached) < uncached / 20);
+
+	return 0;
+}
+DM_TEST(dm_test_video_truetype_cache, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+#endif
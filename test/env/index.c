@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the index of a sorted environment
+ */
+
+#include <common.h>
+#include <env.h>
+#include <env_internal.h>
+#include <malloc.h>
+#include <asm/global_data.h>
+#include <test/env.h>
+#include <test/ut.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+static const char test_text[] = "arch=sandbox\0baudrate=115200\0board=sb\0"
+	"bootdelay=3\0empty=\0stdout=serial\0";
+
+/* Look up variables in an environment with an index, as before relocation */
+static int env_test_index_find(struct unit_test_state *uts)
+{
+	char buf[32];
+
+	ut_asserteq(sizeof("arch=sandbox\0baudrate=115200\0board=") - 1,
+		    env_index_find("board"));
+	ut_asserteq(2, env_get_f("board", buf, sizeof(buf)));
+	ut_asserteq_str("sb", buf);
+	ut_asserteq(-1, env_get_f("sandbox", buf, sizeof(buf)));
+	ut_asserteq(6, env_get_f("stdout", buf, sizeof(buf)));
+	ut_asserteq_str("serial", buf);
+	ut_asserteq(0, env_get_f("empty", buf, sizeof(buf)));
+	ut_asserteq_str("", buf);
+
+	/* Prefixes and extensions of names are not matches */
+	ut_asserteq(-ENOENT, env_index_find("boar"));
+	ut_asserteq(-ENOENT, env_index_find("boards"));
+	ut_asserteq(-ENOENT, env_index_find("a"));
+	ut_asserteq(-ENOENT, env_index_find("zzz"));
+	ut_asserteq(-1, env_get_f("boar", buf, sizeof(buf)));
+
+	return 0;
+}
+
+/* Run the index tests on @env, which is made the early environment */
+static int env_test_index_run(struct unit_test_state *uts, env_t *env)
+{
+	struct env_index idx;
+	char buf[32];
+
+	memcpy(env->data, test_text, sizeof(test_text));
+	ut_assertok(env_index_add(env->data));
+	memcpy(&idx, env->data + ENV_SIZE - sizeof(idx), sizeof(idx));
+	ut_asserteq(ENV_INDEX_MAGIC, idx.magic);
+	ut_asserteq(6, idx.count);
+	ut_asserteq(sizeof(test_text), idx.size);
+
+	gd->env_addr = (ulong)env->data;
+	gd->env_valid = ENV_VALID;
+	ut_assertok(env_test_index_find(uts));
+
+	/* An index which does not match the text is not used */
+	env->data[sizeof("arch=sandbox\0baudrate=115200\0board=s") - 1] = 'x';
+	gd->env_index_addr = 0;
+	ut_asserteq(-EINVAL, env_index_find("board"));
+	ut_asserteq(2, env_get_f("board", buf, sizeof(buf)));
+	ut_asserteq_str("sx", buf);
+
+	/* Text which is not sorted gets no index */
+	memset(env->data, '\0', ENV_SIZE);
+	memcpy(env->data, "b=1\0a=2\0", sizeof("b=1\0a=2\0"));
+	ut_asserteq(-EINVAL, env_index_add(env->data));
+	ut_asserteq(-ENODATA, env_index_find("a"));
+	ut_asserteq(1, env_get_f("a", buf, sizeof(buf)));
+	ut_asserteq_str("2", buf);
+
+	/* The default environment is shorter than ENV_SIZE, so has no index */
+	gd->env_addr = (ulong)default_environment;
+	ut_asserteq(-ENODATA, env_index_find("arch"));
+	gd->env_addr = (ulong)env->data;
+
+	/* The saved environment has an index if there is room */
+	ut_assertok(env_export(env));
+	memcpy(&idx, env->data + ENV_SIZE - sizeof(idx), sizeof(idx));
+	if (idx.magic == ENV_INDEX_MAGIC) {
+		gd->env_index_addr = 0;
+		ut_assert(env_index_find("arch") >= 0);
+		ut_asserteq(strlen(env_get("arch")),
+			    env_get_f("arch", buf, sizeof(buf)));
+		ut_asserteq_str(env_get("arch"), buf);
+	}
+
+	return 0;
+}
+
+static int env_test_index(struct unit_test_state *uts)
+{
+	ulong env_addr = gd->env_addr;
+	ulong env_valid = gd->env_valid;
+	env_t *env;
+	int ret;
+
+	env = calloc(1, sizeof(*env));
+	ut_assertnonnull(env);
+
+	/* Put the real environment back even if a check fails */
+	ret = env_test_index_run(uts, env);
+	gd->env_addr = env_addr;
+	gd->env_valid = env_valid;
+	gd->env_index_addr = 0;
+	free(env);
+
+	return ret;
+}
+ENV_TEST(env_test_index, 0);
@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Unit tests for the software BCH encoder/decoder
+ */
+
+#include <common.h>
+#include <log.h>
+#include <malloc.h>
+#include <rand.h>
+#include <linux/bch.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+/* NAND-like layout: 512-byte ECC steps, BCH-8 over GF(2^13) */
+#define BCH_TEST_M		13
+#define BCH_TEST_T		8
+#define BCH_TEST_STEP		512
+#define BCH_TEST_STEPS		256
+
+/**
+ * flip_bits() - inject bit errors into a data step and its ECC bytes
+ *
+ * @data:	data step
+ * @ecc:	ECC bytes of the step
+ * @nbits:	number of data bits followed by ECC bits
+ * @count:	number of distinct bits to flip
+ */
+static void flip_bits(u8 *data, u8 *ecc, uint nbits, int count)
+{
+	uint pos[BCH_TEST_T];
+	int i, j;
+
+	for (i = 0; i < count; i++) {
+again:
+		pos[i] = rand() % nbits;
+		for (j = 0; j < i; j++)
+			if (pos[j] == pos[i])
+				goto again;
+
+		if (pos[i] < BCH_TEST_STEP * 8) {
+			data[pos[i] / 8] ^= 1 << (pos[i] % 8);
+		} else {
+			pos[i] -= BCH_TEST_STEP * 8;
+			ecc[pos[i] / 8] ^= 0x80 >> (pos[i] % 8);
+			pos[i] += BCH_TEST_STEP * 8;
+		}
+	}
+}
+
+/**
+ * correct_step() - decode a step and fix the data bits reported in error
+ *
+ * @bch:	BCH control structure
+ * @data:	data step to fix
+ * @ecc:	ECC bytes read along with the step
+ * Return:	number of corrected bits, or -EBADMSG
+ */
+static int correct_step(struct bch_control *bch, u8 *data, const u8 *ecc)
+{
+	uint errloc[BCH_TEST_T];
+	int i, ret;
+
+	ret = decode_bch(bch, data, BCH_TEST_STEP, ecc, NULL, NULL, errloc);
+	for (i = 0; i < ret; i++)
+		if (errloc[i] < BCH_TEST_STEP * 8)
+			data[errloc[i] / 8] ^= 1 << (errloc[i] % 8);
+
+	return ret;
+}
+
+/* Test that up to t bit errors are found and corrected */
+static int lib_test_bch(struct unit_test_state *uts)
+{
+	u8 *data, *orig, ecc[32], ecc_orig[32];
+	struct bch_control *bch;
+	uint nbits;
+	int i, n;
+
+	bch = init_bch(BCH_TEST_M, BCH_TEST_T, 0);
+	ut_assertnonnull(bch);
+	ut_assert(bch->ecc_bytes <= sizeof(ecc));
+	nbits = BCH_TEST_STEP * 8 + bch->ecc_bits;
+
+	data = malloc(BCH_TEST_STEP);
+	orig = malloc(BCH_TEST_STEP);
+	ut_assertnonnull(data);
+	ut_assertnonnull(orig);
+
+	srand(0x5eed);
+	for (i = 0; i < BCH_TEST_STEP; i++)
+		orig[i] = rand();
+	memset(ecc_orig, '\0', sizeof(ecc_orig));
+	encode_bch(bch, orig, BCH_TEST_STEP, ecc_orig);
+
+	/* A clean step decodes without error */
+	memcpy(data, orig, BCH_TEST_STEP);
+	ut_asserteq(0, correct_step(bch, data, ecc_orig));
+	ut_asserteq_mem(orig, data, BCH_TEST_STEP);
+
+	/* Every error count up to t, in data and ECC bytes */
+	for (n = 1; n <= BCH_TEST_T; n++) {
+		memcpy(data, orig, BCH_TEST_STEP);
+		memcpy(ecc, ecc_orig, sizeof(ecc));
+		flip_bits(data, ecc, nbits, n);
+		ut_asserteq(n, correct_step(bch, data, ecc));
+		ut_asserteq_mem(orig, data, BCH_TEST_STEP);
+	}
+
+	/* Many steps with random error counts, as when reading raw NAND */
+	for (i = 0; i < BCH_TEST_STEPS; i++) {
+		memcpy(data, orig, BCH_TEST_STEP);
+		memcpy(ecc, ecc_orig, sizeof(ecc));
+		flip_bits(data, ecc, nbits, i % (BCH_TEST_T + 1));
+		n = correct_step(bch, data, ecc);
+		ut_asserteq(i % (BCH_TEST_T + 1), n);
+		ut_asserteq_mem(orig, data, BCH_TEST_STEP);
+	}
+
+	free(orig);
+	free(data);
+	free_bch(bch);
+
+	return 0;
+}
+LIB_TEST(lib_test_bch, 0);
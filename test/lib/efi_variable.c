@@ -0,0 +1,250 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Test the UEFI variable store
+ */
+
+#include <common.h>
+#include <efi_loader.h>
+#include <efi_variable.h>
+#include <fs.h>
+#include <malloc.h>
+#include <mapmem.h>
+#include <sandboxblockdev.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+#define UT_VAR_COUNT 100
+
+static const efi_guid_t ut_var_guid =
+	EFI_GUID(0x3f8a8c0e, 0x6b3d, 0x4d1a,
+		 0x9d, 0x47, 0x2e, 0x51, 0x0c, 0x1e, 0x7a, 0x64);
+
+/* Set the decimal suffix of the test variable name */
+static void ut_var_name(u16 *name, int i)
+{
+	name[7] = '0' + i / 100;
+	name[8] = '0' + (i / 10) % 10;
+	name[9] = '0' + i % 10;
+}
+
+/* Test setting, finding and deleting many variables in memory */
+static int lib_test_efi_var_mem(struct unit_test_state *uts)
+{
+	u16 name[] = L"UtVar--000";
+	efi_uintn_t size;
+	u32 attr = EFI_VARIABLE_BOOTSERVICE_ACCESS;
+	int i, val;
+
+	ut_asserteq_64(EFI_SUCCESS, efi_init_obj_list());
+
+	for (i = 0; i < UT_VAR_COUNT; ++i) {
+		ut_var_name(name, i);
+		ut_asserteq_64(EFI_SUCCESS,
+			       efi_set_variable_int(name, &ut_var_guid, attr,
+						    sizeof(i), &i, false));
+	}
+
+	for (i = UT_VAR_COUNT - 1; i >= 0; --i) {
+		ut_var_name(name, i);
+		size = sizeof(val);
+		ut_asserteq_64(EFI_SUCCESS,
+			       efi_get_variable_int(name, &ut_var_guid, NULL,
+						    &size, &val, NULL));
+		ut_asserteq(sizeof(val), size);
+		ut_asserteq(i, val);
+	}
+
+	/* Overwrite and delete variables in the middle of the store */
+	for (i = 0; i < UT_VAR_COUNT; i += 2) {
+		ut_var_name(name, i);
+		ut_asserteq_64(EFI_SUCCESS,
+			       efi_set_variable_int(name, &ut_var_guid, attr,
+						    0, NULL, false));
+	}
+	for (i = 1; i < UT_VAR_COUNT; i += 2) {
+		ut_var_name(name, i);
+		val = -i;
+		ut_asserteq_64(EFI_SUCCESS,
+			       efi_set_variable_int(name, &ut_var_guid, attr,
+						    sizeof(val), &val, false));
+	}
+	for (i = 0; i < UT_VAR_COUNT; ++i) {
+		ut_var_name(name, i);
+		size = sizeof(val);
+		if (i & 1) {
+			ut_asserteq_64(EFI_SUCCESS,
+				       efi_get_variable_int(name, &ut_var_guid,
+							    NULL, &size, &val,
+							    NULL));
+			ut_asserteq(-i, val);
+		} else {
+			ut_asserteq_64(EFI_NOT_FOUND,
+				       efi_get_variable_int(name, &ut_var_guid,
+							    NULL, &size, &val,
+							    NULL));
+		}
+	}
+
+	for (i = 1; i < UT_VAR_COUNT; i += 2) {
+		ut_var_name(name, i);
+		ut_asserteq_64(EFI_SUCCESS,
+			       efi_set_variable_int(name, &ut_var_guid, attr,
+						    0, NULL, false));
+	}
+
+	return 0;
+}
+
+LIB_TEST(lib_test_efi_var_mem, 0);
+
+#if defined(CONFIG_SANDBOX) && defined(CONFIG_EFI_VARIABLE_FILE_JOURNAL)
+#define UT_NV_ATTR	(EFI_VARIABLE_NON_VOLATILE | \
+			 EFI_VARIABLE_BOOTSERVICE_ACCESS | \
+			 EFI_VARIABLE_RUNTIME_ACCESS)
+#define UT_NV_COUNT	10
+
+/* Set test variable @i to @val, or delete it if @val is negative */
+static int ut_var_set(struct unit_test_state *uts, int i, int val)
+{
+	u16 name[] = L"UtVar--000";
+
+	ut_var_name(name, i);
+	ut_asserteq_64(EFI_SUCCESS,
+		       efi_set_variable_int(name, &ut_var_guid, UT_NV_ATTR,
+					    val < 0 ? 0 : sizeof(val), &val,
+					    false));
+
+	return 0;
+}
+
+/* Check test variable @i has value @expect, or is missing if negative */
+static int ut_var_check(struct unit_test_state *uts, int i, int expect)
+{
+	u16 name[] = L"UtVar--000";
+	efi_uintn_t size = sizeof(int);
+	efi_status_t ret;
+	int val;
+
+	ut_var_name(name, i);
+	ret = efi_get_variable_int(name, &ut_var_guid, NULL, &size, &val, NULL);
+	if (expect < 0) {
+		ut_asserteq_64(EFI_NOT_FOUND, ret);
+	} else {
+		ut_asserteq_64(EFI_SUCCESS, ret);
+		ut_asserteq(expect, val);
+	}
+
+	return 0;
+}
+
+/* Drop the non-volatile variables and load them again, as on a reboot */
+static int ut_var_reload(struct unit_test_state *uts)
+{
+	struct efi_var_entry *var, *end;
+	struct efi_var_file *buf;
+	loff_t len;
+	u16 *data;
+
+	ut_asserteq_64(EFI_SUCCESS,
+		       efi_var_collect(&buf, &len, EFI_VARIABLE_NON_VOLATILE));
+	end = (struct efi_var_entry *)((u8 *)buf + len);
+	for (var = buf->var; var < end;
+	     var = (struct efi_var_entry *)ALIGN((uintptr_t)data + var->length,
+						 8)) {
+		data = var->name + u16_strlen(var->name) + 1;
+		efi_var_mem_del(efi_var_mem_find(&var->guid, var->name, NULL));
+	}
+	free(buf);
+	ut_assertok(ut_var_check(uts, 0, -1));
+
+	ut_asserteq_64(EFI_SUCCESS, efi_var_from_file());
+
+	return 0;
+}
+
+/* Read the variables file into @buf */
+static int ut_var_read_file(struct unit_test_state *uts,
+			    struct efi_var_file *buf, loff_t *lenp)
+{
+	ut_assertok(fs_set_blk_dev("host", "0:0", FS_TYPE_ANY));
+	ut_assertok(fs_read(EFI_VAR_FILE_NAME, map_to_sysmem(buf), 0,
+			    EFI_VAR_BUF_SIZE, lenp));
+	ut_assert(buf->length <= *lenp);
+
+	return 0;
+}
+
+static int ut_var_file(struct unit_test_state *uts, struct efi_var_file *buf)
+{
+	loff_t len, actual;
+	int i;
+
+	/* Start with a file holding a snapshot and no journal */
+	ut_asserteq_64(EFI_SUCCESS, efi_var_to_file());
+	for (i = 0; i < UT_NV_COUNT; i++)
+		ut_assertok(ut_var_set(uts, i, i));
+	ut_assertok(ut_var_set(uts, 1, 100));
+	ut_assertok(ut_var_set(uts, 2, -1));
+
+	/* The changes are appended to the file and replayed when loading */
+	ut_assertok(ut_var_read_file(uts, buf, &len));
+	ut_assert(buf->length < len);
+	ut_assertok(ut_var_reload(uts));
+	ut_assertok(ut_var_check(uts, 0, 0));
+	ut_assertok(ut_var_check(uts, 1, 100));
+	ut_assertok(ut_var_check(uts, 2, -1));
+	for (i = 3; i < UT_NV_COUNT; i++)
+		ut_assertok(ut_var_check(uts, i, i));
+
+	/* A record cut short, e.g. by a power loss, is dropped */
+	ut_assertok(ut_var_set(uts, 3, 300));
+	ut_assertok(ut_var_read_file(uts, buf, &len));
+	ut_assertok(fs_set_blk_dev("host", "0:0", FS_TYPE_ANY));
+	ut_assertok(fs_write(EFI_VAR_FILE_NAME, map_to_sysmem(buf), 0, len - 8,
+			     &actual));
+	ut_assertok(ut_var_reload(uts));
+	ut_assertok(ut_var_check(uts, 3, 3));
+	ut_assertok(ut_var_check(uts, 1, 100));
+
+	/* The next change rewrites the file without the damaged record */
+	ut_assertok(ut_var_set(uts, 4, 400));
+	ut_assertok(ut_var_read_file(uts, buf, &len));
+	ut_asserteq(buf->length, len);
+	ut_assertok(ut_var_reload(uts));
+	ut_assertok(ut_var_check(uts, 3, 3));
+	ut_assertok(ut_var_check(uts, 4, 400));
+
+	for (i = 0; i < UT_NV_COUNT; i++)
+		ut_assertok(ut_var_set(uts, i, -1));
+
+	return 0;
+}
+
+/* Test storing non-volatile variables in a file on the EFI system partition */
+static int lib_test_efi_var_file(struct unit_test_state *uts)
+{
+	struct efi_system_partition esp = efi_system_partition;
+	struct efi_var_file *buf;
+	int ret;
+
+	ut_asserteq_64(EFI_SUCCESS, efi_init_obj_list());
+
+	/* test/py/tests/test_ut.py creates this image */
+	ut_assertok(host_dev_bind(0, "fat.img"));
+	buf = malloc(EFI_VAR_BUF_SIZE);
+	ut_assertnonnull(buf);
+	efi_system_partition.if_type = IF_TYPE_HOST;
+	efi_system_partition.devnum = 0;
+	efi_system_partition.part = 0;
+
+	ret = ut_var_file(uts, buf);
+
+	efi_system_partition = esp;
+	free(buf);
+	ut_assertok(host_dev_bind(0, NULL));
+
+	return ret;
+}
+LIB_TEST(lib_test_efi_var_file, 0);
+#endif
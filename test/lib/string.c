@@ -12,6 +12,9 @@
 #include <common.h>
 #include <command.h>
 #include <log.h>
+#include <malloc.h>
+#include <time.h>
+#include <linux/sizes.h>
 #include <test/lib.h>
 #include <test/test.h>
 #include <test/ut.h>
@@ -193,3 +196,144 @@ static int lib_memmove(struct unit_test_state *uts)
 }
 
 LIB_TEST(lib_memmove, 0);
+
+/* Size of the buffers for the large copy tests */
+#define BIGLEN		SZ_64K
+
+/**
+ * lib_memcpy_large() - unit test for long memory operations
+ *
+ * The architecture dependent implementations switch to block loops and, for
+ * memset(), whole cache line zeroing for long regions. Check these with
+ * varied alignment.
+ *
+ * @uts:	unit test state
+ * Return:	0 = success, 1 = failure
+ */
+static int lib_memcpy_large(struct unit_test_state *uts)
+{
+	static const int lens[] = { 63, 64, 65, 127, 255, 1000, 4096, 5000,
+				    BIGLEN / 2 };
+	u8 *src, *dst, *buf;
+	int i, j, offset;
+
+	src = malloc(BIGLEN);
+	dst = malloc(BIGLEN);
+	buf = malloc(BIGLEN);
+	ut_assertnonnull(src);
+	ut_assertnonnull(dst);
+	ut_assertnonnull(buf);
+	for (i = 0; i < BIGLEN; i++)
+		src[i] = i ^ (i >> 8) ^ MASK;
+
+	for (i = 0; i < ARRAY_SIZE(lens); i++) {
+		int len = lens[i];
+
+		for (offset = 0; offset <= SWEEP; offset++) {
+			memset(dst, '\0', BIGLEN);
+			memcpy(dst + offset, src + SWEEP - offset, len);
+			ut_asserteq_mem(src + SWEEP - offset, dst + offset, len);
+			ut_asserteq(0, dst[offset + len]);
+			ut_asserteq(0, memcmp(dst + offset, src + SWEEP - offset,
+					      len));
+			dst[offset + len - 1] ^= 1;
+			ut_assert(memcmp(dst + offset, src + SWEEP - offset,
+					 len));
+
+			/* Overlapping moves in both directions */
+			memcpy(buf, src, BIGLEN);
+			memmove(buf + offset + 1, buf, len);
+			ut_asserteq_mem(src, buf + offset + 1, len);
+			memcpy(buf, src, BIGLEN);
+			memmove(buf, buf + offset + 1, len);
+			ut_asserteq_mem(src + offset + 1, buf, len);
+
+			for (j = 0; j < 2; j++) {
+				int val = j ? MASK : 0;
+
+				memset(buf, ~val, BIGLEN);
+				memset(buf + offset + 1, val, len);
+				ut_asserteq((u8)~val, buf[offset]);
+				ut_asserteq((u8)~val, buf[offset + 1 + len]);
+				ut_assert(!memchr_inv(buf + offset + 1, val, len));
+			}
+		}
+	}
+
+	free(buf);
+	free(dst);
+	free(src);
+
+	return 0;
+}
+
+LIB_TEST(lib_memcpy_large, 0);
+
+/* Size copied when measuring speed, repeated SPEED_LOOPS times */
+#define SPEED_LEN	SZ_1M
+#define SPEED_LOOPS	16
+
+/**
+ * lib_memcpy_speed() - print the speed of the memory functions
+ *
+ * Copies are measured with the pointers aligned alike and not, as the
+ * architecture dependent implementations handle these differently.
+ *
+ * @uts:	unit test state
+ * Return:	0 = success, 1 = failure
+ */
+static int lib_memcpy_speed(struct unit_test_state *uts)
+{
+	ulong start, time;
+	u8 *src, *dst;
+	int i;
+
+	src = malloc(SPEED_LEN);
+	dst = malloc(SPEED_LEN);
+	ut_assertnonnull(src);
+	ut_assertnonnull(dst);
+	memset(src, MASK, SPEED_LEN);
+
+	start = get_timer(0);
+	for (i = 0; i < SPEED_LOOPS; i++)
+		memcpy(dst, src, SPEED_LEN);
+	time = get_timer(start);
+	printf("memcpy: %lu MB/s\n",
+	       SPEED_LOOPS * SPEED_LEN / 1000 / (time + 1));
+
+	start = get_timer(0);
+	for (i = 0; i < SPEED_LOOPS; i++)
+		memcpy(dst, src + 1, SPEED_LEN - 1);
+	time = get_timer(start);
+	printf("memcpy (unaligned): %lu MB/s\n",
+	       SPEED_LOOPS * SPEED_LEN / 1000 / (time + 1));
+
+	start = get_timer(0);
+	for (i = 0; i < SPEED_LOOPS; i++)
+		memmove(dst + 1, dst, SPEED_LEN - 1);
+	time = get_timer(start);
+	printf("memmove: %lu MB/s\n",
+	       SPEED_LOOPS * SPEED_LEN / 1000 / (time + 1));
+
+	start = get_timer(0);
+	for (i = 0; i < SPEED_LOOPS; i++)
+		memset(dst, 0, SPEED_LEN);
+	time = get_timer(start);
+	printf("memset: %lu MB/s\n",
+	       SPEED_LOOPS * SPEED_LEN / 1000 / (time + 1));
+
+	memcpy(dst, src, SPEED_LEN);
+	start = get_timer(0);
+	for (i = 0; i < SPEED_LOOPS; i++)
+		ut_asserteq(0, memcmp(dst, src, SPEED_LEN));
+	time = get_timer(start);
+	printf("memcmp: %lu MB/s\n",
+	       SPEED_LOOPS * SPEED_LEN / 1000 / (time + 1));
+
+	free(dst);
+	free(src);
+
+	return 0;
+}
+
+LIB_TEST(lib_memcpy_speed, 0);
@@ -26,6 +26,7 @@ extern u32 __dtb_test_fdt_overlay_begin;
 extern u32 __dtb_test_fdt_overlay_stacked_begin;
 
 static void *fdt;
+static void *fdt_index;
 
 static int ut_fdt_getprop_u32_by_index(void *fdt, const char *path,
 				    const char *name, int index,
@@ -211,6 +212,16 @@ static int fdt_overlay_stacked(struct unit_test_state *uts)
 }
 OVERLAY_TEST(fdt_overlay_stacked, 0);
 
+static int fdt_overlay_index(struct unit_test_state *uts)
+{
+	/* Applying with an index gives exactly the same tree */
+	ut_asserteq(fdt_totalsize(fdt), fdt_totalsize(fdt_index));
+	ut_asserteq_mem(fdt, fdt_index, fdt_totalsize(fdt));
+
+	return CMD_RET_SUCCESS;
+}
+OVERLAY_TEST(fdt_overlay_index, 0);
+
 int do_ut_overlay(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
 	struct unit_test *tests = ll_entry_start(struct unit_test,
@@ -221,6 +232,7 @@ int do_ut_overlay(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 	void *fdt_overlay = &__dtb_test_fdt_overlay_begin;
 	void *fdt_overlay_stacked = &__dtb_test_fdt_overlay_stacked_begin;
 	void *fdt_overlay_copy, *fdt_overlay_stacked_copy;
+	struct fdt_overlay_index ov_idx;
 	int ret = -ENOMEM;
 
 	uts = calloc(1, sizeof(*uts));
@@ -242,6 +254,10 @@ int do_ut_overlay(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 	if (!fdt_overlay_stacked_copy)
 		goto err3;
 
+	fdt_index = malloc(FDT_COPY_SIZE);
+	if (!fdt_index)
+		goto err4;
+
 	/*
 	 * Resize the FDT to 4k so that we have room to operate on
 	 *
@@ -274,8 +290,26 @@ int do_ut_overlay(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 	/* Apply the stacked overlay */
 	ut_assertok(fdt_overlay_apply(fdt, fdt_overlay_stacked_copy));
 
+	/*
+	 * Apply both overlays again to another copy, using an index; the
+	 * stacked overlay targets a node added by the first one
+	 */
+	ut_assertok(fdt_open_into(fdt_base, fdt_index, FDT_COPY_SIZE));
+	ut_assertok(fdt_open_into(fdt_overlay, fdt_overlay_copy,
+				  FDT_COPY_SIZE));
+	ut_assertok(fdt_open_into(fdt_overlay_stacked, fdt_overlay_stacked_copy,
+				  FDT_COPY_SIZE));
+	ut_assertok(fdt_overlay_index_alloc(fdt_index, &ov_idx));
+	ut_assertok(fdt_overlay_apply_index(fdt_index, fdt_overlay_copy,
+					    &ov_idx));
+	ut_assertok(fdt_overlay_apply_index(fdt_index,
+					    fdt_overlay_stacked_copy, &ov_idx));
+	fdt_overlay_index_free(&ov_idx);
+
 	ret = cmd_ut_category("overlay", "", tests, n_ents, argc, argv);
 
+	free(fdt_index);
+err4:
 	free(fdt_overlay_stacked_copy);
 err3:
 	free(fdt_overlay_copy);
@@ -0,0 +1,70 @@
+# SPDX-License-Identifier: GPL-2.0+
+
+import pytest
+import u_boot_utils
+import zlib
+
+# Bytes of source data, written a word at a time
+SRC_LEN = 0x110
+
+# Destination window, which is checked as a whole after each copy
+DST_LEN = 0x120
+DST_FILL = 0x5a
+
+# Source offset, destination offset and length of each copy. These cover
+# pointers aligned alike and differently, short copies and ones long enough
+# for the block loops of the architecture-specific memcpy().
+COPIES = [
+    (0, 0, 0x100),
+    (8, 0, 0xc8),
+    (3, 3, 0x41),
+    (1, 0, 0x100),
+    (0, 5, 0x80),
+    (7, 13, 0xf3),
+    (15, 2, 0x3f),
+]
+
+def src_word(i):
+    """Return word i of the source data."""
+    return i * 0x9e3779b1 & 0xffffffff
+
+def src_data(byteorder):
+    """Return the source data as stored by a CPU of the given byte order."""
+    data = bytearray()
+    for i in range(SRC_LEN // 4):
+        data += src_word(i).to_bytes(4, byteorder)
+    return data
+
+def get_crc32(u_boot_console, addr, size):
+    """Return the CRC32 of a memory area as calculated by U-Boot."""
+    response = u_boot_console.run_command('crc32 %x %x' % (addr, size))
+    return int(response.split('==> ')[1].strip()[:8], 16)
+
+@pytest.mark.buildconfigspec('cmd_memory')
+@pytest.mark.buildconfigspec('cmd_crc32')
+def test_mem_copy(u_boot_console):
+    """Test that cp copies memory correctly at varied alignment.
+
+    cp uses memcpy(), so this runs the architecture-specific implementation
+    on boards which enable USE_ARCH_MEMCPY.
+    """
+
+    ram_base = u_boot_utils.find_ram_base(u_boot_console)
+    src = ram_base
+    dst = ram_base + 0x1000
+
+    for i in range(SRC_LEN // 4):
+        u_boot_console.run_command('mw.l %x %08x' % (src + i * 4, src_word(i)))
+    crc = get_crc32(u_boot_console, src, SRC_LEN)
+    data = src_data('little')
+    if crc != zlib.crc32(data):
+        data = src_data('big')
+    assert crc == zlib.crc32(data)
+
+    for src_off, dst_off, size in COPIES:
+        u_boot_console.run_command('mw.b %x %x %x' % (dst, DST_FILL, DST_LEN))
+        u_boot_console.run_command('cp.b %x %x %x' %
+                                   (src + src_off, dst + dst_off, size))
+        expect = bytearray([DST_FILL] * DST_LEN)
+        expect[dst_off:dst_off + size] = data[src_off:src_off + size]
+        assert get_crc32(u_boot_console, dst, DST_LEN) == zlib.crc32(expect)
@@ -3,6 +3,7 @@
 
 import os.path
 import pytest
+import u_boot_utils
 
 @pytest.mark.buildconfigspec('ut_dm')
 def test_ut_dm_init(u_boot_console):
@@ -21,6 +22,74 @@ def test_ut_dm_init(u_boot_console):
         with open(fn, 'wb') as fh:
             fh.write(data)
 
+    fn = u_boot_console.config.source_dir + '/fat.img'
+    if not os.path.exists(fn):
+        data = b'\x00' * (1024 * 1024)
+        with open(fn, 'wb') as fh:
+            fh.write(data)
+        u_boot_utils.run_and_log(u_boot_console, ['mkfs.vfat', fn])
+
+# Board device trees for the FIT used by the bootm_test_fit_compat test
+fit_compat_dtbs = {
+    'fdt-1': '"test,board-a", "test,soc"',
+    'fdt-2': '"test,board-b", "test,soc"',
+    'fdt-3': '"test,board-c"',
+    'fdt-4': '"test,board-d"',
+}
+
+# The configurations pick boards by their FDT image or by their own
+# compatible strings. fdt-4 is not used by any configuration.
+fit_compat_its = '''
+/dts-v1/;
+
+/ {
+	description = "FIT with several board configurations";
+	#address-cells = <1>;
+
+	images {
+%(images)s
+	};
+
+	configurations {
+		default = "conf-1";
+		conf-1 {
+			fdt = "fdt-1";
+		};
+		conf-2 {
+			fdt = "fdt-2";
+		};
+		conf-3 {
+			compatible = "test,board-c", "test,board-b";
+			fdt = "fdt-3";
+		};
+	};
+};
+'''
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.requiredtool('dtc')
+def test_ut_bootm_init(u_boot_console):
+    """Initialize data for ut bootm tests."""
+
+    cons = u_boot_console
+    images = ''
+    for name, compat in fit_compat_dtbs.items():
+        dts = os.path.join(cons.config.build_dir, name + '.dts')
+        dtb = os.path.join(cons.config.build_dir, name + '.dtb')
+        with open(dts, 'w') as fd:
+            fd.write('/dts-v1/;\n/ {\n\tcompatible = %s;\n};\n' % compat)
+        u_boot_utils.run_and_log(cons, ['dtc', dts, '-O', 'dtb', '-o', dtb])
+        images += ('\t\t%s {\n\t\t\tdata = /incbin/("%s");\n'
+                   '\t\t\ttype = "flat_dt";\n\t\t\tarch = "sandbox";\n'
+                   '\t\t\tcompression = "none";\n\t\t};\n' % (name, dtb))
+
+    its = os.path.join(cons.config.build_dir, 'fit_compat.its')
+    with open(its, 'w') as fd:
+        fd.write(fit_compat_its % {'images': images})
+    mkimage = cons.config.build_dir + '/tools/mkimage'
+    fit = cons.config.source_dir + '/fit_compat.itb'
+    u_boot_utils.run_and_log(cons, [mkimage, '-f', its, fit])
+
 def test_ut(u_boot_console, ut_subtest):
     """Execute a "ut" subtest.
 
@@ -24,6 +24,84 @@
 
 static image_header_t header;
 
+/**
+ * fit_add_compat_index() - Add an index of compatible strings to a FIT
+ *
+ * This lists each compatible string used by the configurations, along with
+ * the name of the first configuration which has it, in a 'compatible-index'
+ * property in the configurations node. U-Boot can then pick the best
+ * configuration for a board without looking at every configuration and FDT.
+ *
+ * @fit: FIT to update
+ * @external_data: true if the data will be moved outside the FIT, in which
+ *	case the FDT images cannot be used to match at run time
+ * @return 0 if OK, -ENOSPC if the FIT is too small, other -ve on error
+ */
+static int fit_add_compat_index(void *fit, bool external_data)
+{
+	const char *compat, *name, *p;
+	int confs_noffset, noffset, compat_noffset;
+	int len, cur_len, size = 0;
+	char *index = NULL, *new;
+	const void *fdt;
+	int ret;
+
+	confs_noffset = fdt_path_offset(fit, FIT_CONFS_PATH);
+	if (confs_noffset < 0)
+		return 0;
+
+	fdt_for_each_subnode(noffset, fit, confs_noffset) {
+		if (external_data &&
+		    !fdt_getprop(fit, noffset, "compatible", NULL))
+			continue;
+		compat_noffset = fit_conf_get_compat_node(fit, noffset, &fdt);
+		if (compat_noffset < 0)
+			continue;
+		compat = fdt_getprop(fdt, compat_noffset, "compatible", &len);
+		name = fdt_get_name(fit, noffset, NULL);
+		if (!compat || !name)
+			continue;
+
+		for (; len > 0; len -= cur_len, compat += cur_len) {
+			cur_len = strnlen(compat, len) + 1;
+
+			/* Only the first configuration for a string is used */
+			for (p = index; p && p < index + size;) {
+				if (!strcmp(p, compat))
+					break;
+				p += strlen(p) + 1;
+				p += strlen(p) + 1;
+			}
+			if (p && p < index + size)
+				continue;
+
+			new = realloc(index, size + cur_len + strlen(name) + 1);
+			if (!new) {
+				free(index);
+				return -ENOMEM;
+			}
+			index = new;
+			memcpy(index + size, compat, cur_len - 1);
+			index[size + cur_len - 1] = '\0';
+			size += cur_len;
+			strcpy(index + size, name);
+			size += strlen(name) + 1;
+		}
+	}
+
+	/* Replace any index from an earlier run of mkimage */
+	fdt_delprop(fit, confs_noffset, FIT_COMPAT_INDEX_PROP);
+	if (!size)
+		return 0;
+	ret = fdt_setprop(fit, confs_noffset, FIT_COMPAT_INDEX_PROP, index,
+			  size);
+	free(index);
+	if (ret)
+		return ret == -FDT_ERR_NOSPACE ? -ENOSPC : -EIO;
+
+	return 0;
+}
+
 static int fit_add_file_data(struct image_tool_params *params, size_t size_inc,
 			     const char *tmpfile)
 {
@@ -59,6 +137,9 @@ static int fit_add_file_data(struct image_tool_params *params, size_t size_inc,
 		ret = fit_set_timestamp(ptr, 0, time);
 	}
 
+	if (!ret)
+		ret = fit_add_compat_index(ptr, params->external_data);
+
 	if (!ret) {
 		ret = fit_cipher_data(params->keydir, dest_blob, ptr,
 				      params->comment,
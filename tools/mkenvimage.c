@@ -27,9 +27,13 @@
 
 #define CRC_SIZE sizeof(uint32_t)
 
+/* Environment index, see struct env_index in include/env_internal.h */
+#define ENV_INDEX_MAGIC		0x58444e45
+#define ENV_INDEX_WORDS		4
+
 static void usage(const char *exec_name)
 {
-	fprintf(stderr, "%s [-h] [-r] [-b] [-p <byte>] -s <environment partition size> -o <output> <input file>\n"
+	fprintf(stderr, "%s [-h] [-r] [-b] [-i] [-p <byte>] -s <environment partition size> -o <output> <input file>\n"
 	       "\n"
 	       "This tool takes a key=value input file (same as would a `printenv' show) and generates the corresponding environment image, ready to be flashed.\n"
 	       "\n"
@@ -41,6 +45,8 @@ static void usage(const char *exec_name)
 	       "\tcolumn are treated as comments (also skipped).\n"
 	       "\t-r : the environment has multiple copies in flash\n"
 	       "\t-b : the target is big endian (default is little endian)\n"
+	       "\t-i : sort the variables and add an index, so that U-Boot can\n"
+	       "\t     find them quickly before relocation (CONFIG_ENV_INDEX)\n"
 	       "\t-p <byte> : fill the image with <byte> bytes instead of 0xff bytes\n"
 	       "\t-V : print version information and exit\n"
 	       "\n"
@@ -66,6 +72,103 @@ long int xstrtol(const char *s)
 	exit(EXIT_FAILURE);
 }
 
+/* Compare the names of two name=value strings, as U-Boot does */
+static int name_cmp(const char *a, const char *b)
+{
+	int ca, cb;
+
+	for (;; a++, b++) {
+		ca = *a == '=' ? 0 : (unsigned char)*a;
+		cb = *b == '=' ? 0 : (unsigned char)*b;
+		if (ca != cb || !ca)
+			return ca - cb;
+	}
+}
+
+static int var_cmp(const void *p1, const void *p2)
+{
+	const char *const *a = p1, *const *b = p2;
+	int ret;
+
+	ret = name_cmp(*a, *b);
+	if (ret)
+		return ret;
+
+	/* Keep the input order for variables with the same name */
+	return *a < *b ? -1 : *a > *b;
+}
+
+static void put_word(unsigned char *p, uint32_t val, int bigendian)
+{
+	val = bigendian ? cpu_to_be32(val) : cpu_to_le32(val);
+	memcpy(p, &val, sizeof(val));
+}
+
+/*
+ * Sort the variables by name and add an index at the end of the environment.
+ * When a variable is set more than once the last value is kept, as happens
+ * when U-Boot imports the environment.
+ */
+static int add_index(unsigned char *envptr, unsigned int envsize,
+		     unsigned int textsize, unsigned char padbyte,
+		     int bigendian)
+{
+	unsigned int count, pos, idx, i, len;
+	unsigned char *text;
+	uint32_t *offset;
+	char **vars;
+	uint32_t crc;
+
+	for (count = 0, pos = 0; envptr[pos]; count++)
+		pos += strlen((char *)envptr + pos) + 1;
+
+	vars = malloc(count * sizeof(*vars) + 1);
+	offset = malloc(count * sizeof(*offset) + 1);
+	text = malloc(textsize);
+	if (!vars || !offset || !text) {
+		fprintf(stderr, "Can't alloc memory for the index\n");
+		return -1;
+	}
+	for (i = 0, pos = 0; i < count; i++) {
+		vars[i] = (char *)envptr + pos;
+		pos += strlen(vars[i]) + 1;
+	}
+	qsort(vars, count, sizeof(*vars), var_cmp);
+
+	for (i = 0, idx = 0, pos = 0; i < count; i++) {
+		if (i + 1 < count && !name_cmp(vars[i], vars[i + 1]))
+			continue;
+		len = strlen(vars[i]) + 1;
+		memcpy(text + pos, vars[i], len);
+		offset[idx++] = pos;
+		pos += len;
+	}
+	text[pos++] = '\0';
+	count = idx;
+
+	if (pos + (ENV_INDEX_WORDS + count) * sizeof(uint32_t) > envsize) {
+		fprintf(stderr, "The environment is too large to add an index\n");
+		return -1;
+	}
+	memcpy(envptr, text, pos);
+	memset(envptr + pos, padbyte, textsize - pos);
+	crc = crc32(0, text, pos);
+
+	idx = envsize - (ENV_INDEX_WORDS + count) * sizeof(uint32_t);
+	for (i = 0; i < count; i++, idx += sizeof(uint32_t))
+		put_word(envptr + idx, offset[i], bigendian);
+	put_word(envptr + idx, crc, bigendian);
+	put_word(envptr + idx + 4, pos, bigendian);
+	put_word(envptr + idx + 8, count, bigendian);
+	put_word(envptr + idx + 12, ENV_INDEX_MAGIC, bigendian);
+
+	free(text);
+	free(offset);
+	free(vars);
+
+	return 0;
+}
+
 #define CHUNK_SIZE 4096
 
 int main(int argc, char **argv)
@@ -78,6 +181,7 @@ int main(int argc, char **argv)
 	unsigned int filesize = 0, envsize = 0, datasize = 0;
 	int bigendian = 0;
 	int redundant = 0;
+	int index = 0;
 	unsigned char padbyte = 0xff;
 	int readbytes = 0;
 
@@ -93,7 +197,7 @@ int main(int argc, char **argv)
 	opterr = 0;
 
 	/* Parse the cmdline */
-	while ((option = getopt(argc, argv, ":s:o:rbp:hV")) != -1) {
+	while ((option = getopt(argc, argv, ":s:o:rbip:hV")) != -1) {
 		switch (option) {
 		case 's':
 			datasize = xstrtol(optarg);
@@ -111,6 +215,9 @@ int main(int argc, char **argv)
 		case 'b':
 			bigendian = 1;
 			break;
+		case 'i':
+			index = 1;
+			break;
 		case 'p':
 			padbyte = xstrtol(optarg);
 			break;
@@ -254,6 +361,9 @@ int main(int argc, char **argv)
 		envptr[ep] = '\0';
 	}
 
+	if (index && add_index(envptr, envsize, ep + 1, padbyte, bigendian))
+		return EXIT_FAILURE;
+
 	/* Computes the CRC and put it at the beginning of the data */
 	crc = crc32(0, envptr, envsize);
 	targetendian_crc = bigendian ? cpu_to_be32(crc) : cpu_to_le32(crc);
@@ -59,16 +59,88 @@ static bool read_num(const char *str, uint64_t *num)
 	return str[0] && !endptr[0];
 }
 
+static int read_word(FILE *f, uint64_t pos, uint64_t *val)
+{
+	if (fseek(f, pos, SEEK_SET) < 0 || fread(val, sizeof(*val), 1, f) != 1)
+		return -1;
+	*val = le64_to_cpu(*val);
+
+	return 0;
+}
+
+static int check_relr_word(FILE *f, const char *prog, const char *name,
+			   uint64_t text_base, uint64_t addr)
+{
+	uint64_t val;
+
+	if (addr < text_base || read_word(f, addr - text_base, &val)) {
+		fprintf(stderr, "%s: %s: bad relr location %" PRIx64 "\n",
+			prog, name, addr);
+		return 4;
+	}
+	if (val < text_base)
+		fprintf(stderr, "warning: relr location %" PRIx64
+				" holds %" PRIx64 "\n", addr, val);
+	debug("Relr %" PRIx64 " %" PRIx64 "\n", addr, val);
+
+	return 0;
+}
+
+/*
+ * The linker stores the link-time value of each RELR location in place, so
+ * there is nothing to write. Walk the table as relocate_code() does instead,
+ * checking that every location is in the image and holds an address in it.
+ */
+static int check_relr(FILE *f, const char *prog, const char *name,
+		      uint64_t text_base, uint64_t relr_start,
+		      uint64_t relr_end)
+{
+	uint64_t pos, entry, base = 0;
+	int bit, ret;
+
+	for (pos = relr_start; pos < relr_end; pos += sizeof(entry)) {
+		if (read_word(f, pos - text_base, &entry)) {
+			fprintf(stderr, "%s: %s: read relr failed at %"
+					PRIx64 "\n", prog, name, pos);
+			return 4;
+		}
+
+		/* An address, with any bitmaps that follow starting after it */
+		if (!(entry & 1)) {
+			ret = check_relr_word(f, prog, name, text_base, entry);
+			if (ret)
+				return ret;
+			base = entry + sizeof(entry);
+			continue;
+		}
+
+		/* A bitmap of the next 63 words */
+		for (bit = 1; bit < 64; bit++) {
+			if (!(entry & (1ULL << bit)))
+				continue;
+			ret = check_relr_word(f, prog, name, text_base,
+					      base + (bit - 1) * sizeof(entry));
+			if (ret)
+				return ret;
+		}
+		base += 63 * sizeof(entry);
+	}
+
+	return 0;
+}
+
 int main(int argc, char **argv)
 {
 	FILE *f;
 	int i, num;
 	uint64_t rela_start, rela_end, text_base;
+	uint64_t relr_start = 0, relr_end = 0;
 
-	if (argc != 5) {
+	if (argc != 5 && argc != 7) {
 		fprintf(stderr, "Statically apply ELF rela relocations\n");
 		fprintf(stderr, "Usage: %s <bin file> <text base> " \
-				"<rela start> <rela end>\n", argv[0]);
+				"<rela start> <rela end> " \
+				"[<relr start> <relr end>]\n", argv[0]);
 		fprintf(stderr, "All numbers in hex.\n");
 		return 1;
 	}
@@ -87,6 +159,19 @@ int main(int argc, char **argv)
 		return 3;
 	}
 
+	if (argc == 7 && (!read_num(argv[5], &relr_start) ||
+			  !read_num(argv[6], &relr_end))) {
+		fprintf(stderr, "%s: bad number\n", argv[0]);
+		return 3;
+	}
+
+	if (relr_start > relr_end ||
+	    (relr_start != relr_end && relr_start < text_base) ||
+	    (relr_end - relr_start) % sizeof(uint64_t)) {
+		fprintf(stderr, "%s: bad relr bounds\n", argv[0]);
+		return 3;
+	}
+
 	if (rela_start > rela_end || rela_start < text_base ||
 	    (rela_end - rela_start) % sizeof(Elf64_Rela)) {
 		fprintf(stderr, "%s: bad rela bounds\n", argv[0]);
@@ -147,6 +232,16 @@ int main(int argc, char **argv)
 		}
 	}
 
+	if (relr_start != relr_end) {
+		int ret = check_relr(f, argv[0], argv[1], text_base,
+				     relr_start, relr_end);
+
+		if (ret) {
+			fclose(f);
+			return ret;
+		}
+	}
+
 	if (fclose(f) < 0) {
 		fprintf(stderr, "%s: %s: close failed: %s\n",
 			argv[0], argv[1], strerror(errno));